@@ -0,0 +1,135 @@
+//
+// binary.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// Blob throughput of binary fields, see `ejfpSetBinarySchema`: base64 encoding
+// and decoding alone, and whole objects through `ejfpSerialize` and
+// `ejfpDeserialize` (validating and trusted, see `ejfpSetTrusted`), against
+// `memcpy` of the same bytes.
+//
+// Usage: binary [N_OBJECTS]
+//
+
+#include "ejfp/base64.h"
+#include "ejfp/deserialization.h"
+#include "ejfp/ejfp.h"
+#include "ejfp/serialization.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BLOB_SIZE 65536
+#define MESSAGE_SIZE (EJFP_BASE64_ENCODED_SIZE(BLOB_SIZE) + 64)
+
+typedef enum {
+	ModeMemcpy = 0,
+	ModeEncode,
+	ModeDecode,
+	ModeSerialize,
+	ModeDeserialize,
+	ModeDeserializeTrusted,
+} Mode;
+
+static const char *const kModeNames[] = {"memcpy", "encode", "decode", "serialize", "deserialize", "trusted"};
+
+static uint8_t sBlob[BLOB_SIZE];
+static uint8_t sDecoded[BLOB_SIZE];
+static char sMessage[MESSAGE_SIZE];
+
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static void run(Mode aMode, size_t aMessageSize, size_t aNObjects)
+{
+	static const char *const kBinaryFields[] = {"blob"};
+	static char output[MESSAGE_SIZE];
+	EjfpFieldVariant fieldVariants[2] = {{EjfpFieldVariantTypeInteger, "seq"}, {EjfpFieldVariantTypeBinary, "blob"}};
+	Ejfp ejfp;
+	size_t nErrors = 0;
+	long long checksum = 0;
+	fieldVariants[1].binaryValue = sBlob;
+	fieldVariants[1].binaryValueSize = BLOB_SIZE;
+	ejfpInitialize(&ejfp);
+	const double kStart = now();
+
+	for (size_t i = 0; i < aNObjects; ++i) {
+		int result = 0;
+
+		switch (aMode) {
+			case ModeMemcpy:
+				memcpy(sDecoded, sBlob, BLOB_SIZE);
+
+				break;
+
+			case ModeEncode:
+				ejfpBase64Encode(output, sBlob, BLOB_SIZE);
+
+				break;
+
+			case ModeDecode:
+				result = ejfpBase64Decode(sDecoded, sMessage + 20, EJFP_BASE64_ENCODED_SIZE(BLOB_SIZE));
+
+				break;
+
+			case ModeSerialize:
+				fieldVariants[0].integerValue = (int)i;
+				result = ejfpSerialize(&ejfp, fieldVariants, 2, output, sizeof(output));
+
+				break;
+
+			case ModeDeserialize:
+			case ModeDeserializeTrusted:
+				ejfpReset(&ejfp);
+				ejfpSetTrusted(&ejfp, aMode == ModeDeserializeTrusted);
+				ejfpSetBinarySchema(&ejfp, kBinaryFields, 1, (char *)sDecoded, sizeof(sDecoded));
+				result = ejfpDeserialize(&ejfp, fieldVariants, 2, sMessage, aMessageSize);
+
+				break;
+		}
+
+		nErrors += result < 0;
+		checksum += sDecoded[i % BLOB_SIZE] + (unsigned char)output[i % MESSAGE_SIZE];
+	}
+
+	const double kDuration = now() - kStart;
+	printf("%-12s  %8.1f MB/s  checksum %lld  errors %zu\n", kModeNames[aMode],
+		(double)BLOB_SIZE * (double)aNObjects / kDuration / 1e6, checksum, nErrors);
+}
+
+int main(int aArgc, char **aArgv)
+{
+	const size_t kNObjects = aArgc > 1 ? (size_t)strtoul(aArgv[1], NULL, 10) : 20000;
+	EjfpFieldVariant fieldVariants[2] = {{EjfpFieldVariantTypeInteger, "seq"}, {EjfpFieldVariantTypeBinary, "blob"}};
+
+	for (size_t i = 0; i < BLOB_SIZE; ++i) {
+		sBlob[i] = (uint8_t)(i * 2654435761u >> 13);
+	}
+
+	fieldVariants[0].integerValue = 1000;
+	fieldVariants[1].binaryValue = sBlob;
+	fieldVariants[1].binaryValueSize = BLOB_SIZE;
+	const int kMessageSize = ejfpSerialize(NULL, fieldVariants, 2, sMessage, sizeof(sMessage));
+
+	if (kMessageSize < 0 || strncmp(sMessage, "{\"seq\":1000,\"blob\":\"", 20) != 0) {
+		fprintf(stderr, "Failed to serialize: %d\n", kMessageSize);
+
+		return 1;
+	}
+
+	printf("%d byte blobs, %d byte messages\n", BLOB_SIZE, kMessageSize);
+
+	for (Mode mode = ModeMemcpy; mode <= ModeDeserializeTrusted; ++mode) {
+		run(mode, (size_t)kMessageSize, kNObjects);
+	}
+
+	return 0;
+}
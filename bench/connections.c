@@ -0,0 +1,169 @@
+//
+// connections.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// Throughput and latency of `EjfpConnections` over socketpairs. A writer
+// thread sends timestamped objects to the connections round-robin as fast as
+// it can, and the epoll loop measures the time each object has taken to
+// arrive, i.e. latency under saturation.
+//
+// Usage: connections [N_MESSAGES]
+//
+
+#include "ejfp/connections.h"
+#include "ejfp/error.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BUFFER_SIZE 256
+
+typedef struct {
+	int *fds;
+	size_t nFds;
+	size_t nMessages;
+} Writer;
+
+typedef struct {
+	int64_t *latencies;
+	size_t nLatencies;
+	size_t nErrors;
+} Reader;
+
+static int64_t now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (int64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+static int int64Compare(const void *aLhs, const void *aRhs)
+{
+	const int64_t kLhs = *(const int64_t *)aLhs;
+	const int64_t kRhs = *(const int64_t *)aRhs;
+
+	return (kLhs > kRhs) - (kLhs < kRhs);
+}
+
+static void *writerRun(void *aWriter)
+{
+	const Writer *writer = (const Writer *)aWriter;
+	char message[64];
+
+	for (size_t i = 0; i < writer->nMessages; ++i) {
+		const int kSize = snprintf(message, sizeof(message), "{\"seq\":%zu,\"t\":%lld}\n", i, (long long)now());
+
+		if (write(writer->fds[i % writer->nFds], message, (size_t)kSize) != kSize) {
+			perror("write");
+			exit(1);
+		}
+	}
+
+	return NULL;
+}
+
+static void onObject(void *aContext, EjfpConnection *aConnection, int aResult, const EjfpFieldVariant *aFieldVariants)
+{
+	Reader *reader = (Reader *)aContext;
+	(void)aConnection;
+
+	if (aResult != 2 || aFieldVariants[1].fieldType != EjfpFieldVariantTypeInteger64) {
+		++reader->nErrors;
+
+		return;
+	}
+
+	reader->latencies[reader->nLatencies++] = now() - aFieldVariants[1].integer64Value;
+}
+
+static int run(size_t aNConnections, size_t aNMessages)
+{
+	EjfpConnection *connectionArray = calloc(aNConnections, sizeof(EjfpConnection));
+	char *buffers = malloc(aNConnections * BUFFER_SIZE);
+	int *fds = malloc(aNConnections * 2 * sizeof(int));
+	EjfpFieldVariant fieldVariants[4];
+	EjfpConnections connections;
+	Reader reader = {malloc(aNMessages * sizeof(int64_t)), 0, 0};
+	Writer writer = {fds + aNConnections, aNConnections, aNMessages};
+	pthread_t thread;
+
+	if (ejfpConnectionsInitialize(&connections, connectionArray, aNConnections, buffers, BUFFER_SIZE, fieldVariants,
+		4, onObject, &reader) != EjfpOk) {
+		perror("epoll_create1");
+
+		return -1;
+	}
+
+	for (size_t i = 0; i < aNConnections; ++i) {
+		int sockets[2];
+
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+			perror("socketpair");
+
+			return -1;
+		}
+
+		fds[i] = sockets[0];
+		fds[aNConnections + i] = sockets[1];
+		ejfpConnectionsAdd(&connections, sockets[0], NULL);
+	}
+
+	const int64_t kStart = now();
+	pthread_create(&thread, NULL, writerRun, &writer);
+
+	while (reader.nLatencies + reader.nErrors < aNMessages) {
+		if (ejfpConnectionsPoll(&connections, 1000) < 0) {
+			perror("epoll_wait");
+
+			return -1;
+		}
+	}
+
+	const int64_t kDuration = now() - kStart;
+	pthread_join(thread, NULL);
+	qsort(reader.latencies, reader.nLatencies, sizeof(int64_t), int64Compare);
+	printf("%5zu connections  %9.0f msg/s  p50 %8.1f us  p99 %8.1f us  errors %zu\n", aNConnections,
+		(double)aNMessages * 1e9 / (double)kDuration, reader.latencies[reader.nLatencies / 2] / 1e3,
+		reader.latencies[reader.nLatencies * 99 / 100] / 1e3, reader.nErrors);
+
+	for (size_t i = 0; i < aNConnections * 2; ++i) {
+		close(fds[i]);
+	}
+
+	ejfpConnectionsDeinitialize(&connections);
+	free(reader.latencies);
+	free(fds);
+	free(buffers);
+	free(connectionArray);
+
+	return 0;
+}
+
+int main(int aArgc, char **aArgv)
+{
+	static const size_t kNConnections[] = {1, 100, 1000};
+	const size_t kNMessages = aArgc > 1 ? (size_t)strtoul(aArgv[1], NULL, 10) : 1000000;
+	struct rlimit limit;
+
+	// 2 descriptors per connection
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < 2100) {
+		limit.rlim_cur = limit.rlim_max < 2100 ? limit.rlim_max : 2100;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	for (size_t i = 0; i < sizeof(kNConnections) / sizeof(kNConnections[0]); ++i) {
+		if (run(kNConnections[i], kNMessages) != 0) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,107 @@
+//
+// frame.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// Framing throughput: `ejfpSerializeToSink` followed by a separate CRC pass
+// over the output, and `ejfpSerializeFramed`, which checksums the output as
+// it is written. Both w/ the byte-wise and the slice-by-8 tables.
+//
+// Usage: frame [N_OBJECTS]
+//
+
+#include "ejfp/crc.h"
+#include "ejfp/ejfp.h"
+#include "ejfp/frame.h"
+#include "ejfp/sink.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FRAME_SIZE 512
+
+typedef enum {
+	ModeSeparate = 0,
+	ModeFramed,
+} Mode;
+
+static const char *const kModeNames[] = {"separate", "framed"};
+
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static void run(Mode aMode, const EjfpCrc *aCrc, const EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize,
+	size_t aNObjects)
+{
+	const EjfpFrameFormat kFormat = {aCrc, 2};
+	char frame[FRAME_SIZE];
+	Ejfp ejfp;
+	size_t nBytes = 0;
+	uint32_t checksum = 0;
+	ejfpInitialize(&ejfp);
+	const double kStart = now();
+
+	for (size_t i = 0; i < aNObjects; ++i) {
+		int size = 0;
+
+		if (aMode == ModeFramed) {
+			size = ejfpSerializeFramed(&ejfp, &kFormat, aFieldVariants, aFieldVariantsSize, frame, FRAME_SIZE);
+		} else {
+			EjfpSink sink;
+			ejfpSinkInitialize(&sink, frame + 2, FRAME_SIZE - 6, NULL, NULL);
+			size = ejfpSerializeToSink(&ejfp, aFieldVariants, aFieldVariantsSize, &sink);
+			const uint32_t kCrc = ejfpCrcCompute(aCrc, frame + 2, (size_t)size);
+			memcpy(frame + 2 + size, &kCrc, 4);
+			size += 6;
+		}
+
+		checksum += (uint8_t)frame[size - 1];
+		nBytes += (size_t)size;
+	}
+
+	const double kDuration = now() - kStart;
+	printf("%-8s %-7s  %7.1f MB/s  %6.2f Mobj/s  checksum %u\n", kModeNames[aMode], aCrc->isSliced ? "sliced" :
+		"bytes", (double)nBytes / kDuration / 1e6, (double)aNObjects / kDuration / 1e6, (unsigned)checksum);
+}
+
+int main(int aArgc, char **aArgv)
+{
+	const size_t kNObjects = aArgc > 1 ? (size_t)strtoul(aArgv[1], NULL, 10) : 1000000;
+	const EjfpCrcParameters kParameters = EJFP_CRC32;
+	static uint32_t table[EJFP_CRC_TABLE_SIZE];
+	static uint32_t slicedTable[EJFP_CRC_SLICED_TABLE_SIZE];
+	EjfpCrc crcs[2];
+	ejfpCrcInitialize(&crcs[0], &kParameters, table, EJFP_CRC_TABLE_SIZE);
+	ejfpCrcInitialize(&crcs[1], &kParameters, slicedTable, EJFP_CRC_SLICED_TABLE_SIZE);
+
+	char payload[256];
+	memset(payload, 'p', sizeof(payload) - 1);
+	payload[sizeof(payload) - 1] = '\0';
+	EjfpFieldVariant fieldVariants[5] = {
+		{EjfpFieldVariantTypeInteger, "seq"},
+		{EjfpFieldVariantTypeString, "type"},
+		{EjfpFieldVariantTypeString, "payload"},
+		{EjfpFieldVariantTypeInteger, "current"},
+		{EjfpFieldVariantTypeBoolean, "armed"},
+	};
+	fieldVariants[0].integerValue = 10000;
+	fieldVariants[1].stringValue = "telemetry";
+	fieldVariants[2].stringValue = payload;
+	fieldVariants[3].integerValue = -42;
+	fieldVariants[4].booleanValue = 1;
+
+	for (int crc = 0; crc < 2; ++crc) {
+		for (Mode mode = ModeSeparate; mode <= ModeFramed; ++mode) {
+			run(mode, &crcs[crc], fieldVariants, 5, kNObjects);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,106 @@
+//
+// query.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// Lookup of "/sensors/N/temp" in a document w/ an array of sensor objects:
+// converting every value before looking one up, indexing the document and
+// looking one up, and looking one up in a document which has been indexed.
+//
+// Usage: query [N_SENSORS]
+//
+
+#include "ejfp/error.h"
+#include "ejfp/query.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define N_ITERATIONS 2000
+
+typedef enum {
+	ModeDecode = 0,
+	ModeIndex,
+	ModeLookup,
+} Mode;
+
+static const char *const kModeNames[] = {"decode", "index", "lookup"};
+
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static void run(Mode aMode, const char *aInput, size_t aInputSize, size_t aNSensors, jsmntok_t *aTokens,
+	size_t aTokensSize, EjfpFieldVariant *aFieldVariants)
+{
+	EjfpDocument document;
+	EjfpPathSegment segments[3];
+	EjfpPath path;
+	char pointer[64];
+	long long checksum = 0;
+	size_t nErrors = 0;
+	ejfpDocumentIndex(&document, aTokens, aTokensSize, aInput, aInputSize);
+	const double kStart = now();
+
+	for (size_t i = 0; i < N_ITERATIONS; ++i) {
+		snprintf(pointer, sizeof(pointer), "/sensors/%zu/temp", (i * 7919) % aNSensors);
+		ejfpPathCompile(&path, segments, 3, pointer);
+
+		if (aMode != ModeLookup) {
+			ejfpDocumentIndex(&document, aTokens, aTokensSize, aInput, aInputSize);
+		}
+
+		if (aMode == ModeDecode) {
+			for (int token = 0; token < document.nTokens; ++token) {
+				ejfpDocumentValue(&document, token, &aFieldVariants[token]);
+			}
+		}
+
+		const int kToken = ejfpDocumentFind(&document, 0, &path);
+
+		if (kToken < 0) {
+			++nErrors;
+		} else {
+			checksum += aMode == ModeDecode ? aFieldVariants[kToken].integerValue
+				: (ejfpDocumentValue(&document, kToken, &aFieldVariants[0]), aFieldVariants[0].integerValue);
+		}
+	}
+
+	const double kDuration = now() - kStart;
+	printf("%-7s %10.2f us/lookup  %8.1f MB/s  checksum %lld  errors %zu\n", kModeNames[aMode],
+		kDuration / N_ITERATIONS * 1e6, (double)aInputSize * N_ITERATIONS / kDuration / 1e6, checksum, nErrors);
+}
+
+int main(int aArgc, char **aArgv)
+{
+	const size_t kNSensors = aArgc > 1 ? (size_t)strtoul(aArgv[1], NULL, 10) : 1000;
+	const size_t kTokensSize = 5 + kNSensors * 11;
+	char *input = malloc(32 + kNSensors * 96);
+	jsmntok_t *tokens = malloc(kTokensSize * sizeof(jsmntok_t));
+	EjfpFieldVariant *fieldVariants = malloc(kTokensSize * sizeof(EjfpFieldVariant));
+	size_t inputSize = (size_t)sprintf(input, "{\"id\": 1, \"sensors\": [");
+
+	for (size_t i = 0; i < kNSensors; ++i) {
+		inputSize += (size_t)sprintf(input + inputSize, "%s{\"name\": \"s%zu\", \"temp\": %zu, \"ok\": true, "
+			"\"pos\": [1, 2]}", i == 0 ? "" : ", ", i, i % 100);
+	}
+
+	inputSize += (size_t)sprintf(input + inputSize, "]}");
+	printf("%zu sensors, %zu bytes\n", kNSensors, inputSize);
+
+	for (Mode mode = ModeDecode; mode <= ModeLookup; ++mode) {
+		run(mode, input, inputSize, kNSensors, tokens, kTokensSize, fieldVariants);
+	}
+
+	free(fieldVariants);
+	free(tokens);
+	free(input);
+
+	return 0;
+}
@@ -0,0 +1,78 @@
+//
+// shape.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// Deserialization throughput w/ and w/o the shape cache on a steady stream of
+// telemetry objects of the same layout, and on one which alternates between
+// two layouts (the worst case: every object misses).
+//
+// Usage: shape [N_OBJECTS]
+//
+
+#include "ejfp/deserialization.h"
+#include "ejfp/ejfp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define N_LAYOUTS 2
+
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static void run(const char *aName, char (*aInputs)[128], size_t aNInputs, size_t aNObjects, int aIsCached)
+{
+	char shapeBuffer[256];
+	EjfpShapeCache shapeCache;
+	EjfpFieldVariant fieldVariants[8];
+	Ejfp ejfp;
+	size_t nBytes = 0;
+	size_t nErrors = 0;
+	size_t inputLengths[N_LAYOUTS];
+	ejfpInitialize(&ejfp);
+	ejfpShapeCacheInitialize(&shapeCache, shapeBuffer, sizeof(shapeBuffer));
+	ejfpSetShapeCache(&ejfp, aIsCached ? &shapeCache : NULL);
+
+	for (size_t i = 0; i < aNInputs; ++i) {
+		inputLengths[i] = strlen(aInputs[i]);
+	}
+
+	const double kStart = now();
+
+	for (size_t i = 0; i < aNObjects; ++i) {
+		const size_t kInput = i % aNInputs;
+		ejfpReset(&ejfp);
+		nErrors += ejfpDeserialize(&ejfp, fieldVariants, 8, aInputs[kInput], inputLengths[kInput]) < 0;
+		nBytes += inputLengths[kInput];
+	}
+
+	const double kDuration = now() - kStart;
+	printf("%-10s cache %-3s  %7.1f MB/s  %6.2f Mobj/s  hits %8zu  misses %8zu  errors %zu\n", aName,
+		aIsCached ? "on" : "off", (double)nBytes / kDuration / 1e6, (double)aNObjects / kDuration / 1e6,
+		ejfpShapeCacheHits(&shapeCache), ejfpShapeCacheMisses(&shapeCache), nErrors);
+}
+
+int main(int aArgc, char **aArgv)
+{
+	const size_t kNObjects = aArgc > 1 ? (size_t)strtoul(aArgv[1], NULL, 10) : 2000000;
+	char inputs[N_LAYOUTS][128];
+	snprintf(inputs[0], sizeof(inputs[0]),
+		"{\"seq\": 12345, \"type\": \"telemetry\", \"voltage\": 11.52, \"current\": -3, \"armed\": true}");
+	snprintf(inputs[1], sizeof(inputs[1]),
+		"{\"type\": \"telemetry\", \"seq\": 12345, \"voltage\": 11.52, \"current\": -3, \"armed\": true}");
+
+	run("steady", inputs, 1, kNObjects, 0);
+	run("steady", inputs, 1, kNObjects, 1);
+	run("alternate", inputs, N_LAYOUTS, kNObjects, 0);
+	run("alternate", inputs, N_LAYOUTS, kNObjects, 1);
+
+	return 0;
+}
@@ -0,0 +1,95 @@
+//
+// stream.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// Throughput and frame loss of `EjfpStream` on a noisy link, w/ and w/o
+// recovery mode. A bit is flipped in the given share of bytes of an NDJSON
+// stream, which is then fed into the framer in 256-byte chunks.
+//
+// Usage: stream [ERROR_RATE_PERCENT]
+//
+
+#include "ejfp/error.h"
+#include "ejfp/stream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define N_OBJECTS 500000
+#define CHUNK_SIZE 256
+
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static void run(const char *aInput, size_t aInputSize, size_t aNIntact, int aIsRecovering)
+{
+	char buffer[1024];
+	EjfpStream stream;
+	Ejfp ejfp;
+	EjfpFieldVariant fieldVariants[8];
+	size_t nObjects = 0;
+	size_t nErrors = 0;
+	ejfpStreamInitialize(&stream, buffer, sizeof(buffer));
+	ejfpInitialize(&ejfp);
+	ejfpStreamSetRecovery(&stream, aIsRecovering);
+	const double kStart = now();
+
+	for (size_t nFed = 0; nFed < aInputSize;) {
+		const size_t kChunkSize = aInputSize - nFed < CHUNK_SIZE ? aInputSize - nFed : CHUNK_SIZE;
+		nFed += ejfpStreamFeed(&stream, aInput + nFed, kChunkSize);
+
+		for (int result; (result = ejfpStreamNext(&stream, &ejfp, fieldVariants, 8))
+			!= EjfpErrorDeserializationPartitioned;) {
+			if (result >= 0) {
+				++nObjects;
+			} else {
+				++nErrors;
+			}
+		}
+	}
+
+	const double kDuration = now() - kStart;
+	printf("recovery %-3s  %7.1f MB/s  objects %6zu (intact %zu)  errors %7zu  skipped %8zu B\n",
+		aIsRecovering ? "on" : "off", (double)aInputSize / kDuration / 1e6, nObjects, aNIntact, nErrors,
+		ejfpStreamSkipped(&stream));
+}
+
+int main(int aArgc, char **aArgv)
+{
+	const double kErrorRate = (aArgc > 1 ? atof(aArgv[1]) : 1.0) / 100.0;
+	char *input = malloc((size_t)N_OBJECTS * 128);
+	size_t inputSize = 0;
+	size_t nIntact = 0;
+	srand(1);
+
+	for (int i = 0; i < N_OBJECTS; ++i) {
+		const size_t kStart = inputSize;
+		int isIntact = 1;
+		inputSize += (size_t)sprintf(input + inputSize,
+			"{\"seq\":%d,\"type\":\"telemetry\",\"voltage\":%d.%02d,\"armed\":true}\n", i, 10 + i % 3, i % 100);
+
+		for (size_t j = kStart; j < inputSize; ++j) {
+			if ((double)rand() / RAND_MAX < kErrorRate) {
+				input[j] ^= (char)(1 << (rand() % 8));
+				isIntact = 0;
+			}
+		}
+
+		nIntact += isIntact;
+	}
+
+	printf("%d objects, %zu bytes, %.2f%% of bytes corrupted\n", N_OBJECTS, inputSize, kErrorRate * 100);
+	run(input, inputSize, nIntact, 0);
+	run(input, inputSize, nIntact, 1);
+	free(input);
+
+	return 0;
+}
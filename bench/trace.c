@@ -0,0 +1,112 @@
+//
+// trace.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// Cost of tracing w/ a `clock_gettime` clock, see "ejfp/trace.h", and the
+// latency histograms of a round trip of messages from tens of bytes to
+// several KiB.
+//
+// Usage: trace [N_OBJECTS]
+//
+
+#include "ejfp/deserialization.h"
+#include "ejfp/ejfp.h"
+#include "ejfp/print.h"
+#include "ejfp/serialization.h"
+#include "ejfp/trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define N_MESSAGES 64
+#define PAYLOAD_SIZE_MAX 8192
+
+static char sPayload[PAYLOAD_SIZE_MAX + 1];
+static char sOutput[PAYLOAD_SIZE_MAX + 128];
+
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+/// @brief Nanoseconds
+static uint32_t clockMonotonic(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (uint32_t)((uint64_t)time.tv_sec * 1000000000u + (uint64_t)time.tv_nsec);
+}
+
+static void run(EjfpTrace *aTrace, const size_t *aPayloadSizes, size_t aNObjects)
+{
+	EjfpFieldVariant fieldVariants[3] = {
+		{EjfpFieldVariantTypeInteger, "seq"},
+		{EjfpFieldVariantTypeString, "payload"},
+		{EjfpFieldVariantTypeBoolean, "armed"},
+	};
+	EjfpFieldVariant decoded[3];
+	Ejfp ejfp;
+	size_t nErrors = 0;
+	long long checksum = 0;
+	ejfpInitialize(&ejfp);
+	ejfpSetTrace(&ejfp, aTrace);
+	const double kStart = now();
+
+	for (size_t i = 0; i < aNObjects; ++i) {
+		// Strings are not NULL-terminated, cut the payload to size in place
+		const size_t kPayloadSize = aPayloadSizes[i % N_MESSAGES];
+		const char kCut = sPayload[kPayloadSize];
+		sPayload[kPayloadSize] = '\0';
+		fieldVariants[0].integerValue = (int)i;
+		fieldVariants[1].stringValue = sPayload;
+		fieldVariants[2].booleanValue = i % 2;
+		const int kSize = ejfpSerialize(&ejfp, fieldVariants, 3, sOutput, sizeof(sOutput));
+		sPayload[kPayloadSize] = kCut;
+		ejfpReset(&ejfp);
+
+		if (kSize <= 0 || ejfpDeserialize(&ejfp, decoded, 3, sOutput, (size_t)kSize) != 3) {
+			++nErrors;
+		} else {
+			checksum += decoded[0].integerValue;
+		}
+	}
+
+	const double kDuration = now() - kStart;
+	printf("%-10s  %6.2f Mobj/s  checksum %lld  errors %zu\n", aTrace == NULL ? "untraced" : "traced",
+		(double)aNObjects / kDuration / 1e6, checksum, nErrors);
+}
+
+int main(int aArgc, char **aArgv)
+{
+	const size_t kNObjects = aArgc > 1 ? (size_t)strtoul(aArgv[1], NULL, 10) : 500000;
+	static EjfpTraceHistogram histograms[EjfpTracePhaseN];
+	size_t payloadSizes[N_MESSAGES];
+	EjfpTrace trace;
+	ejfpTraceInitialize(&trace, clockMonotonic);
+
+	for (int phase = 0; phase < EjfpTracePhaseN; ++phase) {
+		ejfpTraceHistogramReset(&histograms[phase]);
+		ejfpTraceSetHistogram(&trace, (EjfpTracePhase)phase, &histograms[phase]);
+	}
+
+	memset(sPayload, 'x', PAYLOAD_SIZE_MAX);
+
+	// Mostly small messages, and a few large ones
+	for (int i = 0; i < N_MESSAGES; ++i) {
+		payloadSizes[i] = (size_t)8 << (i % 8 == 7 ? 10 : i % 7);
+	}
+
+	run(NULL, payloadSizes, kNObjects);
+	run(&trace, payloadSizes, kNObjects);
+	printf("Nanoseconds:\n");
+	ejfpTracePrint(&trace);
+
+	return 0;
+}
@@ -0,0 +1,109 @@
+//
+// trusted.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// Deserialization throughput on messages written by `ejfpSerialize`: the
+// validating path, the validating path w/ the shape cache, and the trusted
+// mode, see `ejfpSetTrusted`.
+//
+// Usage: trusted [N_OBJECTS]
+//
+
+#include "ejfp/deserialization.h"
+#include "ejfp/ejfp.h"
+#include "ejfp/serialization.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define N_MESSAGES 64
+#define MESSAGE_SIZE 160
+
+typedef enum {
+	ModeValidating = 0,
+	ModeShapeCache,
+	ModeTrusted,
+} Mode;
+
+static const char *const kModeNames[] = {"validating", "shape", "trusted"};
+
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static void run(Mode aMode, char (*aMessages)[MESSAGE_SIZE], const size_t *aMessageSizes, size_t aNObjects)
+{
+	char shapeBuffer[256];
+	EjfpShapeCache shapeCache;
+	EjfpFieldVariant fieldVariants[8];
+	Ejfp ejfp;
+	size_t nBytes = 0;
+	size_t nErrors = 0;
+	long long checksum = 0;
+	ejfpInitialize(&ejfp);
+	ejfpShapeCacheInitialize(&shapeCache, shapeBuffer, sizeof(shapeBuffer));
+	ejfpSetShapeCache(&ejfp, aMode == ModeShapeCache ? &shapeCache : NULL);
+	ejfpSetTrusted(&ejfp, aMode == ModeTrusted);
+	const double kStart = now();
+
+	for (size_t i = 0; i < aNObjects; ++i) {
+		const size_t kMessage = i % N_MESSAGES;
+		ejfpReset(&ejfp);
+		const int kNFieldVariants = ejfpDeserialize(&ejfp, fieldVariants, 8, aMessages[kMessage],
+			aMessageSizes[kMessage]);
+
+		if (kNFieldVariants < 0) {
+			++nErrors;
+		} else {
+			checksum += fieldVariants[0].integerValue;
+		}
+
+		nBytes += aMessageSizes[kMessage];
+	}
+
+	const double kDuration = now() - kStart;
+	printf("%-10s  %7.1f MB/s  %6.2f Mobj/s  checksum %lld  errors %zu\n", kModeNames[aMode],
+		(double)nBytes / kDuration / 1e6, (double)aNObjects / kDuration / 1e6, checksum, nErrors);
+}
+
+int main(int aArgc, char **aArgv)
+{
+	const size_t kNObjects = aArgc > 1 ? (size_t)strtoul(aArgv[1], NULL, 10) : 2000000;
+	char messages[N_MESSAGES][MESSAGE_SIZE];
+	size_t messageSizes[N_MESSAGES];
+	char names[N_MESSAGES][16];
+
+	for (int i = 0; i < N_MESSAGES; ++i) {
+		EjfpFieldVariant fieldVariants[6] = {
+			{EjfpFieldVariantTypeInteger, "seq"},
+			{EjfpFieldVariantTypeString, "type"},
+			{EjfpFieldVariantTypeString, "name"},
+			{EjfpFieldVariantTypeFloat, "voltage"},
+			{EjfpFieldVariantTypeInteger, "current"},
+			{EjfpFieldVariantTypeBoolean, "armed"},
+		};
+		snprintf(names[i], sizeof(names[i]), "drone-%d", i);
+		fieldVariants[0].integerValue = 10000 + i;
+		fieldVariants[1].stringValue = "telemetry";
+		fieldVariants[2].stringValue = names[i];
+		fieldVariants[3].floatValue = 11.0f + (float)i / 8;
+		fieldVariants[4].integerValue = -i;
+		fieldVariants[5].booleanValue = i % 2;
+		messageSizes[i] = (size_t)ejfpSerialize(NULL, fieldVariants, 6, messages[i], MESSAGE_SIZE);
+	}
+
+	printf("%d messages, e.g. %s\n", N_MESSAGES, messages[0]);
+
+	for (Mode mode = ModeValidating; mode <= ModeTrusted; ++mode) {
+		run(mode, messages, messageSizes, kNObjects);
+	}
+
+	return 0;
+}
@@ -37,21 +37,6 @@ extern "C" {
 #define JSMN_API extern
 #endif
 
-/**
- * JSON type identifier. Basic types are:
- * 	o Object
- * 	o Array
- * 	o String
- * 	o Other primitive: number, boolean (true/false) or null
- */
-typedef enum {
-  JSMN_UNDEFINED = 0,
-  JSMN_OBJECT = 1,
-  JSMN_ARRAY = 2,
-  JSMN_STRING = 3,
-  JSMN_PRIMITIVE = 4
-} jsmntype_t;
-
 enum jsmnerr {
   /* Not enough tokens were provided */
   JSMN_ERROR_NOMEM = -1,
@@ -61,22 +46,6 @@ enum jsmnerr {
   JSMN_ERROR_PART = -3
 };
 
-/**
- * JSON token description.
- * type		type (object, array, string etc.)
- * start	start position in JSON data string
- * end		end position in JSON data string
- */
-typedef struct {
-  jsmntype_t type;
-  int start;
-  int end;
-  int size;
-#ifdef JSMN_PARENT_LINKS
-  int parent;
-#endif
-} jsmntok_t;
-
 /**
  * Create JSON parser over an array of tokens
  */
@@ -112,7 +81,7 @@ static jsmntok_t *jsmn_alloc_token(jsmn_parser *parser, jsmntok_t *tokens,
  * Fills token type and boundaries.
  */
 static void jsmn_fill_token(jsmntok_t *token, const jsmntype_t type,
-                            const int start, const int end) {
+                            const jsmnint_t start, const jsmnint_t end) {
   token->type = type;
   token->start = start;
   token->end = end;
@@ -126,7 +95,7 @@ static int jsmn_parse_primitive(jsmn_parser *parser, const char *js,
                                 const size_t len, jsmntok_t *tokens,
                                 const size_t num_tokens) {
   jsmntok_t *token;
-  int start;
+  jsmnint_t start;
 
   start = parser->pos;
 
@@ -182,7 +151,7 @@ static int jsmn_parse_string(jsmn_parser *parser, const char *js,
                              const size_t num_tokens) {
   jsmntok_t *token;
 
-  int start = parser->pos;
+  jsmnint_t start = parser->pos;
 
   parser->pos++;
 
@@ -1,12 +1,55 @@
 #ifndef JSMN_FWD_H_
 #define JSMN_FWD_H_
 
+/**
+ * Positions in the JSON string. JSMN_LARGE widens them to 64 bits for inputs
+ * over 2 GiB, at the cost of twice as large tokens.
+ */
+#ifdef JSMN_LARGE
+typedef long long jsmnint_t;
+typedef unsigned long long jsmnuint_t;
+#else
+typedef int jsmnint_t;
+typedef unsigned int jsmnuint_t;
+#endif
+
+/**
+ * JSON type identifier. Basic types are:
+ * 	o Object
+ * 	o Array
+ * 	o String
+ * 	o Other primitive: number, boolean (true/false) or null
+ */
+typedef enum {
+  JSMN_UNDEFINED = 0,
+  JSMN_OBJECT = 1,
+  JSMN_ARRAY = 2,
+  JSMN_STRING = 3,
+  JSMN_PRIMITIVE = 4
+} jsmntype_t;
+
+/**
+ * JSON token description.
+ * type		type (object, array, string etc.)
+ * start	start position in JSON data string
+ * end		end position in JSON data string
+ */
+typedef struct {
+  jsmntype_t type;
+  jsmnint_t start;
+  jsmnint_t end;
+  int size;
+#ifdef JSMN_PARENT_LINKS
+  int parent;
+#endif
+} jsmntok_t;
+
 /**
  * JSON parser. Contains an array of token blocks available. Also stores
  * the string being parsed now and current position in that string.
  */
 typedef struct {
-  unsigned int pos;     /* offset in the JSON string */
+  jsmnuint_t pos;       /* offset in the JSON string */
   unsigned int toknext; /* next token to allocate */
   int toksuper;         /* superior token node, e.g. parent object or array */
 } jsmn_parser;
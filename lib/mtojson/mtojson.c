@@ -8,60 +8,117 @@
 #include <stdint.h>
 #include <string.h>
 
-static char* gen_array(char *, const void *);
+#if MTOJSON_ENABLE_REAL
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
 static char* gen_boolean(char *, const void *);
 static char* gen_c_array(char *, const void *);
+static char* gen_int(char *, const void *);
+static char* gen_null(char *, const void *);
+static char* gen_object(char *, const void *);
+static char* gen_primitive(char *, const void *);
+static char* gen_string(char *, const void *);
+static char* gen_value(char *, const void *);
+#if MTOJSON_ENABLE_ARRAYS
+static char* gen_array(char *, const void *);
+#endif
+#if MTOJSON_ENABLE_REAL
+static char* gen_double(char *, const void *);
+static char* gen_float(char *, const void *);
+#endif
+#if MTOJSON_ENABLE_HEX
 static char* gen_hex(char *, const void *);
 static char* gen_hex_u8(char *, const void *);
 static char* gen_hex_u16(char *, const void *);
 static char* gen_hex_u32(char *, const void *);
 static char* gen_hex_u64(char *, const void *);
-static char* gen_int(char *, const void *);
+#endif
+#if MTOJSON_ENABLE_SIZED_INTS
 static char* gen_int8_t(char *, const void *);
 static char* gen_int16_t(char *, const void *);
 static char* gen_int32_t(char *, const void *);
-static char* gen_int64_t(char *, const void *);
 static char* gen_long(char *, const void *);
-static char* gen_longlong(char *, const void *);
-static char* gen_null(char *, const void *);
-static char* gen_object(char *, const void *);
-static char* gen_primitive(char *, const void *);
-static char* gen_string(char *, const void *);
 static char* gen_uint(char *, const void *);
 static char* gen_uint8_t(char *, const void *);
 static char* gen_uint16_t(char *, const void *);
 static char* gen_uint32_t(char *, const void *);
-static char* gen_uint64_t(char *, const void *);
 static char* gen_ulong(char *, const void *);
+#endif
+#if MTOJSON_ENABLE_INT64
+static char* gen_int64_t(char *, const void *);
+static char* gen_longlong(char *, const void *);
+static char* gen_uint64_t(char *, const void *);
 static char* gen_ulonglong(char *, const void *);
-static char* gen_value(char *, const void *);
+#endif
+
+/* Generators of disabled value types, see MTOJSON_ENABLE_* in mtojson.h */
+#if !(MTOJSON_ENABLE_REAL && MTOJSON_ENABLE_INT64 && MTOJSON_ENABLE_SIZED_INTS \
+	&& MTOJSON_ENABLE_HEX && MTOJSON_ENABLE_ARRAYS)
+static char*
+gen_unsupported(char *out, const void *val)
+{
+	(void)out;
+	(void)val;
+	return NULL;
+}
+#endif
+
+#if MTOJSON_ENABLE_REAL
+#define GEN_REAL(gen) gen
+#else
+#define GEN_REAL(gen) gen_unsupported
+#endif
+#if MTOJSON_ENABLE_INT64
+#define GEN_INT64(gen) gen
+#else
+#define GEN_INT64(gen) gen_unsupported
+#endif
+#if MTOJSON_ENABLE_SIZED_INTS
+#define GEN_SIZED_INTS(gen) gen
+#else
+#define GEN_SIZED_INTS(gen) gen_unsupported
+#endif
+#if MTOJSON_ENABLE_HEX
+#define GEN_HEX(gen) gen
+#else
+#define GEN_HEX(gen) gen_unsupported
+#endif
+#if MTOJSON_ENABLE_ARRAYS
+#define GEN_ARRAYS(gen) gen
+#else
+#define GEN_ARRAYS(gen) gen_unsupported
+#endif
 
 static char* (* const gen_functions[])(char *, const void *) = {
 	gen_primitive,
-	gen_array,
+	GEN_ARRAYS(gen_array),
 	gen_boolean,
-	gen_hex,
-	gen_hex_u8,
-	gen_hex_u16,
-	gen_hex_u32,
-	gen_hex_u64,
+	GEN_REAL(gen_double),
+	GEN_REAL(gen_float),
+	GEN_HEX(gen_hex),
+	GEN_HEX(gen_hex_u8),
+	GEN_HEX(gen_hex_u16),
+	GEN_HEX(gen_hex_u32),
+	GEN_HEX(gen_hex_u64),
 	gen_int,
-	gen_int8_t,
-	gen_int16_t,
-	gen_int32_t,
-	gen_int64_t,
-	gen_long,
-	gen_longlong,
+	GEN_SIZED_INTS(gen_int8_t),
+	GEN_SIZED_INTS(gen_int16_t),
+	GEN_SIZED_INTS(gen_int32_t),
+	GEN_INT64(gen_int64_t),
+	GEN_SIZED_INTS(gen_long),
+	GEN_INT64(gen_longlong),
 	gen_null,
 	gen_object,
 	gen_string,
-	gen_uint,
-	gen_uint8_t,
-	gen_uint16_t,
-	gen_uint32_t,
-	gen_uint64_t,
-	gen_ulong,
-	gen_ulonglong,
+	GEN_SIZED_INTS(gen_uint),
+	GEN_SIZED_INTS(gen_uint8_t),
+	GEN_SIZED_INTS(gen_uint16_t),
+	GEN_SIZED_INTS(gen_uint32_t),
+	GEN_INT64(gen_uint64_t),
+	GEN_SIZED_INTS(gen_ulong),
+	GEN_INT64(gen_ulonglong),
 	gen_value,
 };
 
@@ -151,6 +208,60 @@ gen_string(char *out, const void *val)
 	return out;
 }
 
+/* Shortest "%.*g" representation in [prec_min, prec_max] that reads back as
+ * the same value. A ".0" suffix keeps integral values recognizable as reals. */
+#if MTOJSON_ENABLE_REAL
+static char*
+mtojson_dtoa(char *out, double d, int is_float, int prec_min, int prec_max)
+{
+	char buf[32];
+	int len = 0;
+
+	for (int prec = prec_min; prec <= prec_max; prec++) {
+		len = snprintf(buf, sizeof(buf), "%.*g", prec, d);
+		double back = strtod(buf, NULL);
+		if (is_float ? (float)back == (float)d : back == d)
+			break;
+	}
+
+	if (len <= 0 || (size_t)len >= sizeof(buf) - 2)
+		return NULL;
+
+	if (!strpbrk(buf, ".eE")) {
+		buf[len++] = '.';
+		buf[len++] = '0';
+	}
+
+	return strcpy_val(out, buf, (size_t)len);
+}
+
+static char*
+gen_double(char *out, const void *val)
+{
+	if (!val)
+		return gen_null(out, val);
+
+	double d = *(const double*)val;
+	if (d != d || d - d != 0.0) // NaN, +-inf have no JSON representation
+		return gen_null(out, val);
+
+	return mtojson_dtoa(out, d, 0, 15, 17);
+}
+
+static char*
+gen_float(char *out, const void *val)
+{
+	if (!val)
+		return gen_null(out, val);
+
+	float f = *(const float*)val;
+	if (f != f || f - f != 0.0f)
+		return gen_null(out, val);
+
+	return mtojson_dtoa(out, f, 1, 6, 9);
+}
+#endif
+
 static char*
 mtojson_utoa(char *dst, unsigned n, unsigned base)
 {
@@ -170,6 +281,7 @@ mtojson_utoa(char *dst, unsigned n, unsigned base)
 	return e;
 }
 
+#if MTOJSON_ENABLE_SIZED_INTS || MTOJSON_ENABLE_HEX
 static char*
 mtojson_ultoa(char *dst, unsigned long n, unsigned base)
 {
@@ -188,7 +300,9 @@ mtojson_ultoa(char *dst, unsigned long n, unsigned base)
 		*s = "0123456789ABCDEF"[n % base];
 	return e;
 }
+#endif
 
+#if MTOJSON_ENABLE_INT64 || MTOJSON_ENABLE_HEX
 static char*
 mtojson_ulltoa(char *dst, unsigned long long n, unsigned base)
 {
@@ -207,7 +321,9 @@ mtojson_ulltoa(char *dst, unsigned long long n, unsigned base)
 		*s = "0123456789ABCDEF"[n % base];
 	return e;
 }
+#endif
 
+#if MTOJSON_ENABLE_HEX
 static char*
 gen_hex(char *out, const void *val)
 {
@@ -292,6 +408,7 @@ gen_hex_u64(char *out, const void *val)
 
 	return out;
 }
+#endif
 
 static char*
 gen_int(char *out, const void *val)
@@ -311,6 +428,7 @@ gen_int(char *out, const void *val)
 	return mtojson_utoa(out, u, 10);
 }
 
+#if MTOJSON_ENABLE_SIZED_INTS
 static char*
 gen_int8_t(char *out, const void *val)
 {
@@ -364,7 +482,9 @@ gen_int32_t(char *out, const void *val)
 
 	return mtojson_utoa(out, u, 10);
 }
+#endif
 
+#if MTOJSON_ENABLE_INT64
 static char*
 gen_int64_t(char *out, const void *val)
 {
@@ -382,7 +502,9 @@ gen_int64_t(char *out, const void *val)
 
 	return mtojson_ulltoa(out, u, 10);
 }
+#endif
 
+#if MTOJSON_ENABLE_SIZED_INTS
 static char*
 gen_uint(char *out, const void *val)
 {
@@ -418,7 +540,9 @@ gen_uint32_t(char *out, const void *val)
 
 	return mtojson_ultoa(out, *(const uint32_t*)val, 10);
 }
+#endif
 
+#if MTOJSON_ENABLE_INT64
 static char*
 gen_uint64_t(char *out, const void *val)
 {
@@ -427,7 +551,9 @@ gen_uint64_t(char *out, const void *val)
 
 	return mtojson_ulltoa(out, *(const uint64_t*)val, 10);
 }
+#endif
 
+#if MTOJSON_ENABLE_SIZED_INTS
 static char*
 gen_long(char *out, const void *val)
 {
@@ -445,7 +571,9 @@ gen_long(char *out, const void *val)
 
 	return mtojson_ultoa(out, u, 10);
 }
+#endif
 
+#if MTOJSON_ENABLE_INT64
 static char*
 gen_longlong(char *out, const void *val)
 {
@@ -463,8 +591,10 @@ gen_longlong(char *out, const void *val)
 
 	return mtojson_ulltoa(out, u, 10);
 }
+#endif
 
 
+#if MTOJSON_ENABLE_SIZED_INTS
 static char*
 gen_ulong(char *out, const void *val)
 {
@@ -473,7 +603,9 @@ gen_ulong(char *out, const void *val)
 
 	return mtojson_ultoa(out, *(const unsigned long*)val, 10);
 }
+#endif
 
+#if MTOJSON_ENABLE_INT64
 static char*
 gen_ulonglong(char *out, const void *val)
 {
@@ -482,6 +614,7 @@ gen_ulonglong(char *out, const void *val)
 
 	return mtojson_ulltoa(out, *(const unsigned long long*)val, 10);
 }
+#endif
 
 static char*
 gen_value(char *out, const void *val)
@@ -489,6 +622,15 @@ gen_value(char *out, const void *val)
 	return strcpy_val(out, (const char*)val, strlen((const char*)val));
 }
 
+#if !MTOJSON_ENABLE_ARRAYS
+static char*
+gen_c_array(char *out, const void *val)
+{
+	(void)out;
+	(void)val;
+	return NULL;
+}
+#else
 static char*
 gen_c_array(char *out, const void *val)
 {
@@ -509,6 +651,14 @@ gen_c_array(char *out, const void *val)
 		incr = sizeof(_Bool);
 		break;
 
+	case t_to_double:
+		incr = sizeof(double);
+		break;
+
+	case t_to_float:
+		incr = sizeof(float);
+		break;
+
 	case t_to_int:
 		incr = sizeof(int);
 		break;
@@ -599,7 +749,9 @@ gen_c_array(char *out, const void *val)
 	*out++ = ']';
 	return out;
 }
+#endif
 
+#if MTOJSON_ENABLE_ARRAYS
 static char*
 gen_array(char *out, const void *val)
 {
@@ -628,6 +780,7 @@ gen_array(char *out, const void *val)
 	*out++ = ']';
 	return out;
 }
+#endif
 
 static char*
 gen_object(char *out, const void *val)
@@ -642,15 +795,10 @@ gen_object(char *out, const void *val)
 
 	*out++ = '{';
 	while (tjs->name){
-		const char *name = tjs->name;
-		size_t len = strlen(name);
-		if (!reduce_rem_len(len + 3)) // 3 -> "":
+		if (!(out = gen_string(out, tjs->name)))
+			return NULL;
+		if (!reduce_rem_len(1)) // 1 -> :
 			return NULL;
-
-		*out++ = '"';
-		memcpy(out, name, len);
-		out += len;
-		*out++ = '"';
 		*out++ = ':';
 
 		if (tjs->count)
@@ -693,9 +841,11 @@ json_generate(char *out, const struct to_json *tjs, size_t len)
 		return 0;
 
 	switch (tjs->stype) {
+#if MTOJSON_ENABLE_ARRAYS
 	case t_to_array:
 		out = gen_array(out, tjs);
 		break;
+#endif
 	case t_to_object:
 		out = gen_object(out, tjs);
 		break;
@@ -704,6 +854,8 @@ json_generate(char *out, const struct to_json *tjs, size_t len)
 		break;
 	/* These are not valid ctypes */
 	case t_to_boolean:
+	case t_to_double:
+	case t_to_float:
 	case t_to_int:
 	case t_to_null:
 	case t_to_string:
@@ -8,6 +8,24 @@
 
 #include <stddef.h>
 
+/* Feature switches, e.g. -DMTOJSON_ENABLE_HEX=0. Code for disabled value types
+ * is not compiled, json_generate fails on such values. */
+#ifndef MTOJSON_ENABLE_REAL
+#define MTOJSON_ENABLE_REAL 1         /* double, float */
+#endif
+#ifndef MTOJSON_ENABLE_INT64
+#define MTOJSON_ENABLE_INT64 1        /* int64_t, uint64_t, long long, hex_u64 */
+#endif
+#ifndef MTOJSON_ENABLE_SIZED_INTS
+#define MTOJSON_ENABLE_SIZED_INTS 1   /* (u)int8/16/32_t, uint, long, ulong */
+#endif
+#ifndef MTOJSON_ENABLE_HEX
+#define MTOJSON_ENABLE_HEX 1          /* hex, hex_u8/16/32/64 */
+#endif
+#ifndef MTOJSON_ENABLE_ARRAYS
+#define MTOJSON_ENABLE_ARRAYS 1       /* Arrays, and C arrays ('count') */
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -16,6 +34,8 @@ enum json_to_type {
 	t_to_primitive,
 	t_to_array,
 	t_to_boolean,
+	t_to_double,
+	t_to_float,
 	t_to_hex,
 	t_to_hex_u8,
 	t_to_hex_u16,
@@ -0,0 +1,241 @@
+//
+// base64.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// The SSSE3 code follows W. Muła and D. Lemire, "Faster Base64 Encoding and
+// Decoding Using AVX2 Instructions": bytes are spread into 6-bit fields by a
+// shuffle and two multiplications, and mapped onto the alphabet by range.
+//
+
+#include "ejfp/base64.h"
+#include "ejfp/error.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BASE64_SSSE3 1
+#include <tmmintrin.h>
+#else
+#define BASE64_SSSE3 0
+#endif
+
+static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+#if BASE64_SSSE3
+
+/// @return Number of bytes encoded, a multiple of 12
+static size_t base64EncodeSsse3(char *aOut, const uint8_t *aData, size_t aDataSize);
+
+/// @return Number of characters decoded, a multiple of 16. Stops before a
+/// block w/ characters outside of the alphabet, so the scalar code reports it
+static size_t base64DecodeSsse3(uint8_t *aOut, const char *aInput, size_t aInputSize);
+
+#endif  // BASE64_SSSE3
+
+/// @brief Value of each character, or 0xff, if it is not in the alphabet
+static const uint8_t kDecodeTable[256] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 62, 0xff, 0xff, 0xff, 63,
+	52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+	15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+	41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+#if BASE64_SSSE3
+
+__attribute__((target("ssse3")))
+static size_t base64EncodeSsse3(char *aOut, const uint8_t *aData, size_t aDataSize)
+{
+	size_t nEncoded = 0;
+
+	// 16 bytes are loaded, 12 of them are encoded
+	for (; aDataSize - nEncoded >= 16; nEncoded += 12, aOut += 16) {
+		__m128i in = _mm_loadu_si128((const __m128i *)(aData + nEncoded));
+
+		// Each 32-bit lane gets 3 bytes, so the 6-bit fields are in place for the multiplications
+		in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		const __m128i kHigh = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+			_mm_set1_epi32(0x04000040));
+		const __m128i kLow = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+			_mm_set1_epi32(0x01000010));
+		const __m128i kIndices = _mm_or_si128(kHigh, kLow);
+
+		// Ranges: A-Z (0..25) -> 13, a-z (26..51) -> 0, 0-9 (52..61) -> 1..10, + (62) -> 11, / (63) -> 12
+		__m128i range = _mm_subs_epu8(kIndices, _mm_set1_epi8(51));
+		range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), kIndices),
+			_mm_set1_epi8(13)));
+		const __m128i kOffsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+		_mm_storeu_si128((__m128i *)aOut, _mm_add_epi8(kIndices, _mm_shuffle_epi8(kOffsets, range)));
+	}
+
+	return nEncoded;
+}
+
+__attribute__((target("ssse3")))
+static size_t base64DecodeSsse3(uint8_t *aOut, const char *aInput, size_t aInputSize)
+{
+	size_t nDecoded = 0;
+
+	for (; aInputSize - nDecoded >= 16; nDecoded += 16, aOut += 12) {
+		const __m128i kIn = _mm_loadu_si128((const __m128i *)(aInput + nDecoded));
+
+		// Signed comparisons, so characters over 127 are outside of every range
+		const __m128i kUpper = _mm_and_si128(_mm_cmpgt_epi8(kIn, _mm_set1_epi8('A' - 1)),
+			_mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), kIn));
+		const __m128i kLower = _mm_and_si128(_mm_cmpgt_epi8(kIn, _mm_set1_epi8('a' - 1)),
+			_mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), kIn));
+		const __m128i kDigit = _mm_and_si128(_mm_cmpgt_epi8(kIn, _mm_set1_epi8('0' - 1)),
+			_mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), kIn));
+		const __m128i kPlus = _mm_cmpeq_epi8(kIn, _mm_set1_epi8('+'));
+		const __m128i kSlash = _mm_cmpeq_epi8(kIn, _mm_set1_epi8('/'));
+		const __m128i kValid = _mm_or_si128(_mm_or_si128(kUpper, kLower), _mm_or_si128(_mm_or_si128(kDigit, kPlus),
+			kSlash));
+
+		if (_mm_movemask_epi8(kValid) != 0xffff) {
+			break;
+		}
+
+		__m128i shift = _mm_and_si128(kUpper, _mm_set1_epi8(-'A'));
+		shift = _mm_or_si128(shift, _mm_and_si128(kLower, _mm_set1_epi8(26 - 'a')));
+		shift = _mm_or_si128(shift, _mm_and_si128(kDigit, _mm_set1_epi8(52 - '0')));
+		shift = _mm_or_si128(shift, _mm_and_si128(kPlus, _mm_set1_epi8(62 - '+')));
+		shift = _mm_or_si128(shift, _mm_and_si128(kSlash, _mm_set1_epi8(63 - '/')));
+		const __m128i kValues = _mm_add_epi8(kIn, shift);
+
+		// Pairs of 6-bit fields into 12 bits, pairs of those into 24 bits, then 3 bytes of each lane in order
+		const __m128i kPairs = _mm_maddubs_epi16(kValues, _mm_set1_epi32(0x01400140));
+		const __m128i kLanes = _mm_madd_epi16(kPairs, _mm_set1_epi32(0x00011000));
+		const __m128i kBytes = _mm_shuffle_epi8(kLanes, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1,
+			-1, -1));
+
+		// Only 12 bytes are stored, so the output is not overrun
+		_mm_storel_epi64((__m128i *)aOut, kBytes);
+		const uint32_t kLast = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(kBytes, 8));
+		memcpy(aOut + 8, &kLast, 4);
+	}
+
+	return nDecoded;
+}
+
+#endif  // BASE64_SSSE3
+
+size_t ejfpBase64Encode(char *aOut, const void *aData, size_t aDataSize)
+{
+	const uint8_t *data = (const uint8_t *)aData;
+	char *out = aOut;
+
+#if BASE64_SSSE3
+	if (__builtin_cpu_supports("ssse3")) {
+		const size_t kNEncoded = base64EncodeSsse3(out, data, aDataSize);
+		out += kNEncoded / 3 * 4;
+		data += kNEncoded;
+		aDataSize -= kNEncoded;
+	}
+#endif  // BASE64_SSSE3
+
+	for (; aDataSize >= 3; aDataSize -= 3, data += 3, out += 4) {
+		const uint32_t kTriple = (uint32_t)data[0] << 16 | (uint32_t)data[1] << 8 | data[2];
+		out[0] = kAlphabet[kTriple >> 18];
+		out[1] = kAlphabet[(kTriple >> 12) & 0x3f];
+		out[2] = kAlphabet[(kTriple >> 6) & 0x3f];
+		out[3] = kAlphabet[kTriple & 0x3f];
+	}
+
+	if (aDataSize > 0) {
+		const uint32_t kTriple = (uint32_t)data[0] << 16 | (aDataSize == 2 ? (uint32_t)data[1] << 8 : 0);
+		out[0] = kAlphabet[kTriple >> 18];
+		out[1] = kAlphabet[(kTriple >> 12) & 0x3f];
+		out[2] = aDataSize == 2 ? kAlphabet[(kTriple >> 6) & 0x3f] : '=';
+		out[3] = '=';
+		out += 4;
+	}
+
+	return out - aOut;
+}
+
+size_t ejfpBase64DecodedSize(const char *aInput, size_t aInputSize)
+{
+	// Up to 2 padding characters complete the last quad
+	if (aInputSize % 4 == 0) {
+		for (int i = 0; i < 2 && aInputSize > 0 && aInput[aInputSize - 1] == '='; ++i) {
+			--aInputSize;
+		}
+	}
+
+	if (aInputSize % 4 == 1) {
+		return 0;
+	}
+
+	return aInputSize / 4 * 3 + (aInputSize % 4 == 0 ? 0 : aInputSize % 4 - 1);
+}
+
+int ejfpBase64Decode(void *aOut, const char *aInput, size_t aInputSize)
+{
+	const size_t kOutSize = ejfpBase64DecodedSize(aInput, aInputSize);
+	const size_t kTailSize = kOutSize % 3;
+	const uint8_t *in = (const uint8_t *)aInput;
+	uint8_t *out = (uint8_t *)aOut;
+	size_t nQuads = kOutSize / 3;
+
+	if (kOutSize == 0 && aInputSize > 0) {
+		return EjfpErrorDeserializationInvalidSyntax;
+	}
+
+#if BASE64_SSSE3
+	// Full quads only, the padding is left to the scalar code
+	if (__builtin_cpu_supports("ssse3")) {
+		const size_t kNDecoded = base64DecodeSsse3(out, aInput, nQuads * 4);
+		in += kNDecoded;
+		out += kNDecoded / 4 * 3;
+		nQuads -= kNDecoded / 4;
+	}
+#endif  // BASE64_SSSE3
+
+	// Characters are read before bytes are written, so it works in place
+	for (; nQuads > 0; --nQuads, in += 4, out += 3) {
+		const unsigned kA = kDecodeTable[in[0]];
+		const unsigned kB = kDecodeTable[in[1]];
+		const unsigned kC = kDecodeTable[in[2]];
+		const unsigned kD = kDecodeTable[in[3]];
+
+		if ((kA | kB | kC | kD) & 0x80) {
+			return EjfpErrorDeserializationInvalidSyntax;
+		}
+
+		out[0] = (uint8_t)(kA << 2 | kB >> 4);
+		out[1] = (uint8_t)(kB << 4 | kC >> 2);
+		out[2] = (uint8_t)(kC << 6 | kD);
+	}
+
+	if (kTailSize > 0) {
+		const unsigned kA = kDecodeTable[in[0]];
+		const unsigned kB = kDecodeTable[in[1]];
+		const unsigned kC = kTailSize == 2 ? kDecodeTable[in[2]] : 0;
+
+		if ((kA | kB | kC) & 0x80) {
+			return EjfpErrorDeserializationInvalidSyntax;
+		}
+
+		out[0] = (uint8_t)(kA << 2 | kB >> 4);
+
+		if (kTailSize == 2) {
+			out[1] = (uint8_t)(kB << 4 | kC >> 2);
+		}
+	}
+
+	return EjfpOk;
+}
@@ -0,0 +1,44 @@
+//
+// base64.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// RFC 4648 base64 w/ the standard alphabet, used for `Binary` fields. On x86
+// hosts w/ SSSE3, 12 bytes are encoded (16 characters decoded) per
+// iteration; the CPU is checked at run time, so builds stay portable. Other
+// targets use the scalar code.
+//
+
+#ifndef EJFP_BASE64_H_
+#define EJFP_BASE64_H_
+
+#include <stddef.h>
+
+/// @brief Number of characters `aSize` bytes are encoded into, padding included
+#define EJFP_BASE64_ENCODED_SIZE(aSize) (((aSize) + 2) / 3 * 4)
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @brief Encodes bytes w/ padding. The output is not NULL-terminated
+/// @return `EJFP_BASE64_ENCODED_SIZE(aDataSize)`
+size_t ejfpBase64Encode(char *aOut, const void *aData, size_t aDataSize);
+
+/// @return Number of bytes `ejfpBase64Decode` produces, or 0, if the length
+/// is invalid. Padding is optional
+size_t ejfpBase64DecodedSize(const char *aInput, size_t aInputSize);
+
+/// @brief Decodes `ejfpBase64DecodedSize` bytes. Whitespaces are not allowed
+///
+/// @param aOut May be `aInput`, i.e. decoding in place is allowed
+/// @return `EjfpOk`, if succeeded. `EjfpErrorDeserializationInvalidSyntax`,
+/// if the input is not base64
+int ejfpBase64Decode(void *aOut, const char *aInput, size_t aInputSize);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // EJFP_BASE64_H_
@@ -0,0 +1,542 @@
+//
+// cbor.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/cbor.h"
+#include "ejfp/error.h"
+#include "ejfp/fieldVariant.h"
+#include "ejfp/format.h"
+#include "ejfp/sink.h"
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !EJFP_COMPACT  // Requires pointer-based fields, see `EJFP_COMPACT`
+
+typedef enum {
+	CborMajorUnsigned = 0,
+	CborMajorNegative = 1,
+	CborMajorBytes = 2,
+	CborMajorText = 3,
+	CborMajorArray = 4,
+	CborMajorMap = 5,
+	CborMajorTag = 6,
+	CborMajorSimple = 7,
+} CborMajor;
+
+typedef enum {
+	CborSimpleFalse = 20,
+	CborSimpleTrue = 21,
+	CborSimpleNull = 22,
+	CborSimpleUndefined = 23,
+	CborSimpleHalf = 25,
+	CborSimpleFloat = 26,
+	CborSimpleDouble = 27,
+} CborSimple;
+
+typedef enum {
+	CborTagDecimalFraction = 4,  ///< [exponent, mantissa], RFC 8949 3.4.4
+} CborTag;
+
+typedef struct {
+	EjfpSink *sink;
+} CborWriter;
+
+typedef struct {
+	const unsigned char *in;
+	const unsigned char *inEnd;
+} CborReader;
+
+/// @brief Writes a head w/ the shortest argument encoding
+static int cborWriteHead(CborWriter *aWriter, CborMajor aMajor, uint64_t aArgument);
+
+/// @brief Writes a head w/ the argument size given by `aAdditional` (24..27)
+static int cborWriteHeadFixed(CborWriter *aWriter, CborMajor aMajor, unsigned aAdditional, uint64_t aArgument);
+
+static int cborWriteBytes(CborWriter *aWriter, const void *aData, size_t aDataSize);
+
+static int cborWriteText(CborWriter *aWriter, const char *aText, size_t aTextLength);
+
+/// @brief Writes an integer as either the unsigned, or the negative major type
+static int cborWriteInteger(CborWriter *aWriter, int64_t aValue);
+
+/// @brief Reads a head
+/// @param aAdditional Additional information, the lower 5 bits of the initial byte
+static int cborReadHead(CborReader *aReader, CborMajor *aMajor, unsigned *aAdditional, uint64_t *aArgument);
+
+#if EJFP_ENABLE_FIXED
+/// @brief Reads the content of a decimal fraction tag into a fixed-point
+/// field. The exponent must be within [-EJFP_FIXED_DIGITS_MAX; 0]
+static int cborReadDecimalFraction(CborReader *aReader, EjfpFieldVariant *aFieldVariant);
+#endif  // EJFP_ENABLE_FIXED
+
+#if EJFP_ENABLE_REAL
+/// @brief IEEE 754 half precision to single precision conversion
+static float cborHalfToFloat(uint16_t aHalf);
+#endif  // EJFP_ENABLE_REAL
+
+static int cborWriteHead(CborWriter *aWriter, CborMajor aMajor, uint64_t aArgument)
+{
+	if (aArgument < 24) {
+		const unsigned char kHead = (unsigned char)((aMajor << 5) | aArgument);
+
+		return cborWriteBytes(aWriter, &kHead, 1);
+	} else if (aArgument <= UINT8_MAX) {
+		return cborWriteHeadFixed(aWriter, aMajor, 24, aArgument);
+	} else if (aArgument <= UINT16_MAX) {
+		return cborWriteHeadFixed(aWriter, aMajor, 25, aArgument);
+	} else if (aArgument <= UINT32_MAX) {
+		return cborWriteHeadFixed(aWriter, aMajor, 26, aArgument);
+	}
+
+	return cborWriteHeadFixed(aWriter, aMajor, 27, aArgument);
+}
+
+static int cborWriteHeadFixed(CborWriter *aWriter, CborMajor aMajor, unsigned aAdditional, uint64_t aArgument)
+{
+	unsigned char head[9];
+	const size_t kHeadSize = 1 + ((size_t)1 << (aAdditional - 24));
+	head[0] = (unsigned char)((aMajor << 5) | aAdditional);
+
+	// Big-endian argument
+	for (size_t i = kHeadSize - 1; i > 0; --i, aArgument >>= 8) {
+		head[i] = (unsigned char)aArgument;
+	}
+
+	return cborWriteBytes(aWriter, head, kHeadSize);
+}
+
+static inline int cborWriteBytes(CborWriter *aWriter, const void *aData, size_t aDataSize)
+{
+	return ejfpSinkWrite(aWriter->sink, (const char *)aData, aDataSize);
+}
+
+static int cborWriteText(CborWriter *aWriter, const char *aText, size_t aTextLength)
+{
+	int error = cborWriteHead(aWriter, CborMajorText, aTextLength);
+
+	return EjfpOk == error ? cborWriteBytes(aWriter, aText, aTextLength) : error;
+}
+
+static int cborWriteInteger(CborWriter *aWriter, int64_t aValue)
+{
+	return aValue >= 0 ? cborWriteHead(aWriter, CborMajorUnsigned, (uint64_t)aValue) :
+		cborWriteHead(aWriter, CborMajorNegative, (uint64_t)(-1 - aValue));
+}
+
+static int cborReadHead(CborReader *aReader, CborMajor *aMajor, unsigned *aAdditional, uint64_t *aArgument)
+{
+	size_t argumentSize = 0;
+
+	if (aReader->in == aReader->inEnd) {
+		return EjfpErrorDeserializationPartitioned;
+	}
+
+	*aMajor = (CborMajor)(*aReader->in >> 5);
+	*aAdditional = *aReader->in & 0x1f;
+	*aArgument = *aAdditional;
+	++aReader->in;
+
+	if (*aAdditional < 24) {
+		return EjfpOk;
+	} else if (*aAdditional <= 27) {
+		argumentSize = (size_t)1 << (*aAdditional - 24);
+	} else if (*aAdditional == 31) {
+		return EjfpErrorDeserializationUnsupportedJsonStructure;  // Indefinite length
+	} else {
+		return EjfpErrorDeserializationInvalidSyntax;  // Reserved
+	}
+
+	if ((size_t)(aReader->inEnd - aReader->in) < argumentSize) {
+		return EjfpErrorDeserializationPartitioned;
+	}
+
+	*aArgument = 0;
+
+	for (size_t i = 0; i < argumentSize; ++i) {
+		*aArgument = (*aArgument << 8) | *aReader->in++;
+	}
+
+	return EjfpOk;
+}
+
+#if EJFP_ENABLE_FIXED
+
+static int cborReadDecimalFraction(CborReader *aReader, EjfpFieldVariant *aFieldVariant)
+{
+	static const uint64_t kMax = EJFP_ENABLE_INT64 ? (uint64_t)INT64_MAX : (uint64_t)INT32_MAX;
+	CborMajor major;
+	unsigned additional = 0;
+	uint64_t argument = 0;
+	int error = cborReadHead(aReader, &major, &additional, &argument);
+
+	if (EjfpOk != error) {
+		return error;
+	} else if (major != CborMajorArray || argument != 2) {
+		return EjfpErrorDeserializationUnsupportedJsonStructure;
+	}
+
+	// Exponent
+	if (EjfpOk != (error = cborReadHead(aReader, &major, &additional, &argument))) {
+		return error;
+	} else if (major == CborMajorUnsigned && argument == 0) {
+		aFieldVariant->fixedDigits = 0;
+	} else if (major == CborMajorNegative && argument < EJFP_FIXED_DIGITS_MAX) {
+		aFieldVariant->fixedDigits = (uint8_t)(argument + 1);
+	} else {
+		return EjfpErrorDeserializationUnsupportedJsonStructure;
+	}
+
+	// Mantissa
+	if (EjfpOk != (error = cborReadHead(aReader, &major, &additional, &argument))) {
+		return error;
+	} else if (major == CborMajorUnsigned && argument <= kMax) {
+		aFieldVariant->fixedValue = (EjfpFixed)argument;
+	} else if (major == CborMajorNegative && argument <= kMax) {
+		aFieldVariant->fixedValue = (EjfpFixed)(-1 - (int64_t)argument);
+	} else {
+		return EjfpErrorDeserializationUnsupportedJsonStructure;
+	}
+
+	aFieldVariant->fieldType = EjfpFieldVariantTypeFixed;
+
+	return EjfpOk;
+}
+
+#endif  // EJFP_ENABLE_FIXED
+
+#if EJFP_ENABLE_REAL
+
+static float cborHalfToFloat(uint16_t aHalf)
+{
+	const uint32_t kSign = (uint32_t)(aHalf & 0x8000) << 16;
+	uint32_t exponent = (aHalf >> 10) & 0x1f;
+	uint32_t mantissa = aHalf & 0x3ff;
+	uint32_t bits = 0;
+	float value = 0;
+
+	if (exponent == 0x1f) {  // Inf, NaN
+		bits = kSign | 0x7f800000 | (mantissa << 13);
+	} else if (exponent != 0) {  // Normalized
+		bits = kSign | ((exponent + 112) << 23) | (mantissa << 13);
+	} else if (mantissa != 0) {  // Subnormal, normalize it
+		exponent = 113;
+
+		while ((mantissa & 0x400) == 0) {
+			mantissa <<= 1;
+			--exponent;
+		}
+
+		bits = kSign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+	} else {
+		bits = kSign;
+	}
+
+	memcpy(&value, &bits, sizeof(value));
+
+	return value;
+}
+
+#endif  // EJFP_ENABLE_REAL
+
+int ejfpCborSerialize(const EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize, char *aOut,
+	size_t aOutSize)
+{
+	EjfpSink sink;
+	ejfpSinkInitialize(&sink, aOut, aOutSize, NULL, NULL);
+
+	return ejfpCborSerializeToSink(aFieldVariants, aFieldVariantsSize, &sink);
+}
+
+int ejfpCborSerializeToSink(const EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize, EjfpSink *aSink)
+{
+	const size_t kTotalStart = aSink->total;
+	CborWriter writer = {aSink};
+	size_t nFieldVariants = 0;
+	int error = EjfpOk;
+
+	// Unsupported fields terminate the object, as they do in `ejfpSerialize`
+	while (nFieldVariants < aFieldVariantsSize
+			&& EJFP_FIELD_TYPE_IS_ENABLED(aFieldVariants[nFieldVariants].fieldType)) {
+		++nFieldVariants;
+	}
+
+	error = cborWriteHead(&writer, CborMajorMap, nFieldVariants);
+
+	for (size_t i = 0; EjfpOk == error && i < nFieldVariants; ++i) {
+		const EjfpFieldVariant *fieldVariant = &aFieldVariants[i];
+		error = cborWriteText(&writer, fieldVariant->fieldName, ejfpFieldVariantNameLength(fieldVariant));
+
+		if (EjfpOk != error) {
+			break;
+		}
+
+		switch (fieldVariant->fieldType) {
+			case EjfpFieldVariantTypeInteger:
+#if EJFP_ENABLE_INT64
+			case EjfpFieldVariantTypeInteger64:
+#endif  // EJFP_ENABLE_INT64
+			{
+				int64_t value = fieldVariant->integerValue;
+
+#if EJFP_ENABLE_INT64
+				if (fieldVariant->fieldType == EjfpFieldVariantTypeInteger64) {
+					value = fieldVariant->integer64Value;
+				}
+#endif  // EJFP_ENABLE_INT64
+
+				error = cborWriteInteger(&writer, value);
+
+				break;
+			}
+
+#if EJFP_ENABLE_INT64
+			case EjfpFieldVariantTypeUnsignedInteger64:
+				error = cborWriteHead(&writer, CborMajorUnsigned, fieldVariant->unsignedInteger64Value);
+
+				break;
+#endif  // EJFP_ENABLE_INT64
+
+			case EjfpFieldVariantTypeBoolean:
+				error = cborWriteHead(&writer, CborMajorSimple,
+					fieldVariant->booleanValue != 0 ? CborSimpleTrue : CborSimpleFalse);
+
+				break;
+
+			case EjfpFieldVariantTypeNull:
+				error = cborWriteHead(&writer, CborMajorSimple, CborSimpleNull);
+
+				break;
+
+			case EjfpFieldVariantTypeString:
+				error = fieldVariant->stringValue == NULL ?
+					cborWriteHead(&writer, CborMajorSimple, CborSimpleNull) :
+					cborWriteText(&writer, fieldVariant->stringValue, ejfpFieldVariantStringLength(fieldVariant));
+
+				break;
+
+#if EJFP_ENABLE_REAL
+			case EjfpFieldVariantTypeFloat: {
+				uint32_t bits;
+				memcpy(&bits, &fieldVariant->floatValue, sizeof(bits));
+				error = cborWriteHeadFixed(&writer, CborMajorSimple, CborSimpleFloat, bits);
+
+				break;
+			}
+
+			case EjfpFieldVariantTypeDouble: {
+				uint64_t bits;
+				memcpy(&bits, &fieldVariant->doubleValue, sizeof(bits));
+				error = cborWriteHeadFixed(&writer, CborMajorSimple, CborSimpleDouble, bits);
+
+				break;
+			}
+#endif  // EJFP_ENABLE_REAL
+
+#if EJFP_ENABLE_BINARY
+			case EjfpFieldVariantTypeBinary:
+				error = fieldVariant->binaryValue == NULL ?
+					cborWriteHead(&writer, CborMajorSimple, CborSimpleNull) :
+					cborWriteHead(&writer, CborMajorBytes, fieldVariant->binaryValueSize);
+				error = EjfpOk == error && fieldVariant->binaryValue != NULL ?
+					cborWriteBytes(&writer, fieldVariant->binaryValue, fieldVariant->binaryValueSize) : error;
+
+				break;
+#endif  // EJFP_ENABLE_BINARY
+
+#if EJFP_ENABLE_FIXED
+			case EjfpFieldVariantTypeFixed:
+				// value = mantissa * 10^exponent
+				error = cborWriteHead(&writer, CborMajorTag, CborTagDecimalFraction);
+				error = EjfpOk == error ? cborWriteHead(&writer, CborMajorArray, 2) : error;
+				error = EjfpOk == error ? cborWriteInteger(&writer, -(int64_t)fieldVariant->fixedDigits) : error;
+				error = EjfpOk == error ? cborWriteInteger(&writer, fieldVariant->fixedValue) : error;
+
+				break;
+#endif  // EJFP_ENABLE_FIXED
+
+			default:
+				break;
+		}
+	}
+
+	if (EjfpOk == error && aSink->flush != NULL) {
+		error = ejfpSinkFlush(aSink);
+	}
+
+	return EjfpOk == error ? (int)(aSink->total - kTotalStart) : error;
+}
+
+int ejfpCborDeserialize(EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const char *aInputBuffer, size_t aInputBufferSize)
+{
+	CborReader reader = {(const unsigned char *)aInputBuffer, (const unsigned char *)aInputBuffer + aInputBufferSize};
+	CborMajor major;
+	unsigned additional = 0;
+	uint64_t argument = 0;
+	uint64_t nFieldVariants = 0;
+	int error = cborReadHead(&reader, &major, &additional, &nFieldVariants);
+
+	if (EjfpOk != error) {
+		return error;
+	} else if (major != CborMajorMap) {
+		return EjfpErrorDeserializationUnsupportedJsonStructure;
+	} else if (nFieldVariants > aFieldVariantArraySize) {
+		return EjfpErrorDeserializationNoMemory;
+	}
+
+	for (size_t i = 0; i < nFieldVariants; ++i) {
+		EjfpFieldVariant *fieldVariant = &aFieldVariantArray[i];
+
+		// Key
+		if (EjfpOk != (error = cborReadHead(&reader, &major, &additional, &argument))) {
+			return error;
+		} else if (major != CborMajorText) {
+			return EjfpErrorDeserializationUnsupportedJsonStructure;
+		} else if ((uint64_t)(reader.inEnd - reader.in) < argument) {
+			return EjfpErrorDeserializationPartitioned;
+		}
+
+		// Empty strings cannot reference the buffer, see `fieldNameLength`
+		fieldVariant->fieldName = argument > 0 ? (const char *)reader.in : "";
+		fieldVariant->fieldNameLength = argument;
+		reader.in += argument;
+
+		// Value
+		if (EjfpOk != (error = cborReadHead(&reader, &major, &additional, &argument))) {
+			return error;
+		}
+
+		switch (major) {
+			case CborMajorUnsigned:
+				if (argument <= INT_MAX) {
+					fieldVariant->fieldType = EjfpFieldVariantTypeInteger;
+					fieldVariant->integerValue = (int)argument;
+#if EJFP_ENABLE_INT64
+				} else if (argument <= INT64_MAX) {
+					fieldVariant->fieldType = EjfpFieldVariantTypeInteger64;
+					fieldVariant->integer64Value = (int64_t)argument;
+				} else {
+					fieldVariant->fieldType = EjfpFieldVariantTypeUnsignedInteger64;
+					fieldVariant->unsignedInteger64Value = argument;
+#else
+				} else {
+					return EjfpErrorDeserializationUnsupportedJsonStructure;
+#endif  // EJFP_ENABLE_INT64
+				}
+
+				break;
+
+			case CborMajorNegative:
+				// The value is -1 - argument
+				if (argument <= INT_MAX) {
+					fieldVariant->fieldType = EjfpFieldVariantTypeInteger;
+					fieldVariant->integerValue = -1 - (int)argument;
+#if EJFP_ENABLE_INT64
+				} else if (argument <= INT64_MAX) {
+					fieldVariant->fieldType = EjfpFieldVariantTypeInteger64;
+					fieldVariant->integer64Value = -1 - (int64_t)argument;
+#endif  // EJFP_ENABLE_INT64
+				} else {
+					return EjfpErrorDeserializationUnsupportedJsonStructure;  // Below INT64_MIN, no exact representation
+				}
+
+				break;
+
+			case CborMajorText:
+				if ((uint64_t)(reader.inEnd - reader.in) < argument) {
+					return EjfpErrorDeserializationPartitioned;
+				}
+
+				fieldVariant->fieldType = EjfpFieldVariantTypeString;
+				fieldVariant->stringValue = argument > 0 ? (const char *)reader.in : "";
+				fieldVariant->stringValueLength = argument;
+				reader.in += argument;
+
+				break;
+
+#if EJFP_ENABLE_BINARY
+			case CborMajorBytes:
+				// Byte strings are binary fields as is, w/o a schema
+				if ((uint64_t)(reader.inEnd - reader.in) < argument) {
+					return EjfpErrorDeserializationPartitioned;
+				}
+
+				fieldVariant->fieldType = EjfpFieldVariantTypeBinary;
+				fieldVariant->binaryValue = reader.in;
+				fieldVariant->binaryValueSize = argument;
+				reader.in += argument;
+
+				break;
+#endif  // EJFP_ENABLE_BINARY
+
+			case CborMajorSimple:
+				switch (additional) {
+					case CborSimpleFalse:
+					case CborSimpleTrue:
+						fieldVariant->fieldType = EjfpFieldVariantTypeBoolean;
+						fieldVariant->booleanValue = additional == CborSimpleTrue;
+
+						break;
+
+					case CborSimpleNull:
+					case CborSimpleUndefined:
+						fieldVariant->fieldType = EjfpFieldVariantTypeNull;
+
+						break;
+
+#if EJFP_ENABLE_REAL
+					case CborSimpleHalf:
+						fieldVariant->fieldType = EjfpFieldVariantTypeFloat;
+						fieldVariant->floatValue = cborHalfToFloat((uint16_t)argument);
+
+						break;
+
+					case CborSimpleFloat: {
+						const uint32_t kBits = (uint32_t)argument;
+						fieldVariant->fieldType = EjfpFieldVariantTypeFloat;
+						memcpy(&fieldVariant->floatValue, &kBits, sizeof(kBits));
+
+						break;
+					}
+
+					case CborSimpleDouble:
+						fieldVariant->fieldType = EjfpFieldVariantTypeDouble;
+						memcpy(&fieldVariant->doubleValue, &argument, sizeof(argument));
+
+						break;
+#endif  // EJFP_ENABLE_REAL
+
+					default:
+						return EjfpErrorDeserializationUnsupportedJsonStructure;
+				}
+
+				break;
+
+#if EJFP_ENABLE_FIXED
+			case CborMajorTag:
+				if (argument != CborTagDecimalFraction) {
+					return EjfpErrorDeserializationUnsupportedJsonStructure;
+				} else if (EjfpOk != (error = cborReadDecimalFraction(&reader, fieldVariant))) {
+					return error;
+				}
+
+				break;
+#endif  // EJFP_ENABLE_FIXED
+
+			default:
+				return EjfpErrorDeserializationUnsupportedJsonStructure;
+		}
+	}
+
+	if (reader.in != reader.inEnd) {
+		return EjfpErrorDeserializationInvalidSyntax;  // Trailing bytes after the map
+	}
+
+	return (int)nFieldVariants;
+}
+
+#endif  // !EJFP_COMPACT
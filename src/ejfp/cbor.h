@@ -0,0 +1,50 @@
+//
+// cbor.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// CBOR (RFC 8949) backend. A message is a definite-length map w/ text string
+// keys, the same flat structure as the JSON one. Also selectable through
+// `ejfpSetEncoding`.
+//
+
+#ifndef EJFP_CBOR_H_
+#define EJFP_CBOR_H_
+
+#include "ejfp/fieldVariant.h"
+#include "ejfp/sink.h"
+#include <stddef.h>
+
+#if !EJFP_COMPACT  // Requires pointer-based fields, see `EJFP_COMPACT`
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @brief Encodes fields into a CBOR map
+/// @return Output size, if succeeded. Error code otherwise
+int ejfpCborSerialize(const EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize, char *aOut,
+	size_t aOutSize);
+
+/// @brief Encodes fields into a CBOR map through a sink, and flushes it, the
+/// way `ejfpSerializeToSink` does, e.g. to checksum it, see `ejfpSinkSetCrc`
+/// @return Output size, if succeeded. Error code otherwise
+int ejfpCborSerializeToSink(const EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize, EjfpSink *aSink);
+
+/// @brief Decodes a CBOR map. Keys and string values reference the input
+/// buffer, and are not NULL-terminated. The map must span the whole input.
+/// Negative integers below INT64_MIN are rejected, as they have no exact
+/// representation
+///
+/// @return Number of filled `EjfpFieldVariant` instances. Error code otherwise
+int ejfpCborDeserialize(EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const char *aInputBuffer, size_t aInputBufferSize);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !EJFP_COMPACT
+
+#endif  // EJFP_CBOR_H_
@@ -0,0 +1,81 @@
+//
+// config.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Compile-time configuration. Each macro may be overridden by the build
+// system, e.g. `-DEJFP_ENABLE_REAL=0`. `make size` in the repository root
+// reports the code size of the predefined profiles.
+//
+
+#ifndef EJFP_CONFIG_H_
+#define EJFP_CONFIG_H_
+
+/// @brief Compact mode for RAM-constrained targets. Names and strings are
+/// stored as 16-bit offsets relative to a base buffer (the deserialized input,
+/// see `Ejfp::base`), and the type tag is packed into a byte. Code which uses
+/// the `EJFP_FIELD_*` accessors builds in both modes
+#ifndef EJFP_COMPACT
+#define EJFP_COMPACT 0
+#endif
+
+/// @brief `Float` and `Double` field types. W/o them, neither `strtod`, nor
+/// the real number formatter are linked, and reals are rejected on input.
+/// Requires `MTOJSON_ENABLE_REAL`
+#ifndef EJFP_ENABLE_REAL
+#define EJFP_ENABLE_REAL 1
+#endif
+
+/// @brief `Integer64` and `UnsignedInteger64` field types. W/o them, integers
+/// which do not fit into `int` are rejected on input. Requires
+/// `MTOJSON_ENABLE_INT64`
+#ifndef EJFP_ENABLE_INT64
+#define EJFP_ENABLE_INT64 1
+#endif
+
+/// @brief `Fixed` field type: decimals stored as scaled integers, e.g.
+/// millivolts, for targets w/o an FPU. Fields are chosen by name, see
+/// `ejfpSetFixedSchema`. Parsing and formatting use integer arithmetics only,
+/// so it may be combined w/ `EJFP_ENABLE_REAL=0`
+#ifndef EJFP_ENABLE_FIXED
+#define EJFP_ENABLE_FIXED 0
+#endif
+
+/// @brief `Binary` field type: blobs which go as base64 strings in JSON, and
+/// as byte strings in CBOR. Fields are chosen by name, see
+/// `ejfpSetBinarySchema`. Not available in compact mode
+#ifndef EJFP_ENABLE_BINARY
+#define EJFP_ENABLE_BINARY 0
+#endif
+
+#if EJFP_ENABLE_BINARY && EJFP_COMPACT
+#error "EJFP_ENABLE_BINARY is not supported in compact mode"
+#endif
+
+/// @brief 64-bit positions in the parser and its tokens for inputs over
+/// 2 GiB, e.g. memory-mapped dumps. Doubles the size of tokens on the stack
+/// of `ejfpDeserialize`. W/o it, larger inputs are rejected. Not available in
+/// compact mode, which is limited to 64 KiB inputs
+#ifndef EJFP_LARGE_INPUT
+#define EJFP_LARGE_INPUT 0
+#endif
+
+/// @brief Latency tracing of `ejfpSerialize` and `ejfpDeserialize` by phase,
+/// see "ejfp/trace.h" and `ejfpSetTrace`. W/o it, neither the hooks, nor the
+/// `Ejfp::trace` field are compiled in
+#ifndef EJFP_TRACE
+#define EJFP_TRACE 0
+#endif
+
+#if EJFP_LARGE_INPUT
+#if EJFP_COMPACT
+#error "EJFP_LARGE_INPUT is not supported in compact mode"
+#endif
+
+#ifndef JSMN_LARGE
+#define JSMN_LARGE
+#endif
+#endif  // EJFP_LARGE_INPUT
+
+#endif  // EJFP_CONFIG_H_
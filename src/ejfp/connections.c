@@ -0,0 +1,153 @@
+//
+// connections.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#if defined(__linux__)
+
+#include "ejfp/connections.h"
+#include "ejfp/error.h"
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+/// @brief Receives whatever is available, and dispatches complete objects
+/// @return Number of deserialized objects
+static int connectionReceive(EjfpConnections *aConnections, EjfpConnection *aConnection);
+
+/// @brief Notifies the callback, and frees the slot. The descriptor is
+/// available to the callback, so it can be closed there
+static void connectionClose(EjfpConnections *aConnections, EjfpConnection *aConnection, int aReason);
+
+static void connectionClose(EjfpConnections *aConnections, EjfpConnection *aConnection, int aReason)
+{
+	epoll_ctl(aConnections->epollFd, EPOLL_CTL_DEL, aConnection->fd, NULL);
+	aConnections->callback(aConnections->context, aConnection, aReason, aConnections->fieldVariants);
+	aConnection->fd = -1;
+}
+
+static int connectionReceive(EjfpConnections *aConnections, EjfpConnection *aConnection)
+{
+	int nObjects = 0;
+	size_t freeSize = 0;
+	char *free = ejfpStreamReserve(&aConnection->stream, &freeSize);
+	const ssize_t kReceived = read(aConnection->fd, free, freeSize);
+
+	if (kReceived == 0) {
+		connectionClose(aConnections, aConnection, EjfpErrorStreamEnd);
+
+		return 0;
+	} else if (kReceived < 0) {
+		if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+			connectionClose(aConnections, aConnection, EjfpErrorSystem);
+		}
+
+		return 0;
+	}
+
+	ejfpStreamCommit(&aConnection->stream, (size_t)kReceived);
+
+	// The callback may remove the connection
+	for (int result; aConnection->fd >= 0 && (result = ejfpStreamNext(&aConnection->stream, &aConnection->ejfp,
+		aConnections->fieldVariants, aConnections->fieldVariantsSize)) != EjfpErrorDeserializationPartitioned;) {
+		aConnections->callback(aConnections->context, aConnection, result, aConnections->fieldVariants);
+		nObjects += result >= 0;
+	}
+
+	return nObjects;
+}
+
+int ejfpConnectionsInitialize(EjfpConnections *aConnections, EjfpConnection *aConnectionArray,
+	size_t aConnectionsSize, char *aBuffers, size_t aBufferSize, EjfpFieldVariant *aFieldVariants,
+	size_t aFieldVariantsSize, EjfpConnectionsCallback aCallback, void *aContext)
+{
+	aConnections->epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+	if (aConnections->epollFd < 0) {
+		return EjfpErrorSystem;
+	}
+
+	aConnections->connections = aConnectionArray;
+	aConnections->connectionsSize = aConnectionsSize;
+	aConnections->buffers = aBuffers;
+	aConnections->bufferSize = aBufferSize;
+	aConnections->fieldVariants = aFieldVariants;
+	aConnections->fieldVariantsSize = aFieldVariantsSize;
+	aConnections->callback = aCallback;
+	aConnections->context = aContext;
+
+	for (size_t i = 0; i < aConnectionsSize; ++i) {
+		aConnectionArray[i].fd = -1;
+	}
+
+	return EjfpOk;
+}
+
+void ejfpConnectionsDeinitialize(EjfpConnections *aConnections)
+{
+	close(aConnections->epollFd);
+	aConnections->epollFd = -1;
+}
+
+EjfpConnection *ejfpConnectionsAdd(EjfpConnections *aConnections, int aFd, void *aUserData)
+{
+	for (size_t i = 0; i < aConnections->connectionsSize; ++i) {
+		EjfpConnection *connection = &aConnections->connections[i];
+
+		if (connection->fd >= 0) {
+			continue;
+		}
+
+		struct epoll_event event = {0};
+		event.events = EPOLLIN | EPOLLRDHUP;
+		event.data.u64 = i;
+
+		if (epoll_ctl(aConnections->epollFd, EPOLL_CTL_ADD, aFd, &event) != 0) {
+			return NULL;
+		}
+
+		connection->fd = aFd;
+		connection->userData = aUserData;
+		ejfpInitialize(&connection->ejfp);
+		ejfpStreamInitialize(&connection->stream, aConnections->buffers + i * aConnections->bufferSize,
+			aConnections->bufferSize);
+
+		return connection;
+	}
+
+	return NULL;
+}
+
+void ejfpConnectionsRemove(EjfpConnections *aConnections, EjfpConnection *aConnection)
+{
+	if (aConnection->fd >= 0) {
+		epoll_ctl(aConnections->epollFd, EPOLL_CTL_DEL, aConnection->fd, NULL);
+		aConnection->fd = -1;
+	}
+}
+
+int ejfpConnectionsPoll(EjfpConnections *aConnections, int aTimeout)
+{
+	struct epoll_event events[EJFP_CONNECTIONS_EVENTS_MAX];
+	const int kNEvents = epoll_wait(aConnections->epollFd, events, EJFP_CONNECTIONS_EVENTS_MAX, aTimeout);
+	int nObjects = 0;
+
+	if (kNEvents < 0) {
+		return errno == EINTR ? 0 : EjfpErrorSystem;
+	}
+
+	for (int i = 0; i < kNEvents; ++i) {
+		EjfpConnection *connection = &aConnections->connections[events[i].data.u64];
+
+		// May have been removed by the callback while handling a previous event
+		if (connection->fd >= 0) {
+			nObjects += connectionReceive(aConnections, connection);
+		}
+	}
+
+	return nObjects;
+}
+
+#endif  // defined(__linux__)
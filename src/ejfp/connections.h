@@ -0,0 +1,94 @@
+//
+// connections.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// epoll-driven demultiplexer of many byte streams, e.g. Unix socket clients.
+// Every connection has its own parser state and receive buffer, both of which
+// live in caller-provided storage.
+//
+
+#ifndef EJFP_CONNECTIONS_H_
+#define EJFP_CONNECTIONS_H_
+
+#if defined(__linux__)
+
+#include "ejfp/ejfp.h"
+#include "ejfp/fieldVariant.h"
+#include "ejfp/stream.h"
+#include <stddef.h>
+
+/// @brief Max. number of events handled by one `ejfpConnectionsPoll`
+#ifndef EJFP_CONNECTIONS_EVENTS_MAX
+# define EJFP_CONNECTIONS_EVENTS_MAX 64
+#endif
+
+typedef struct {
+	/// @brief -1, if the slot is free
+	int fd;
+	Ejfp ejfp;
+	EjfpStream stream;
+	void *userData;
+} EjfpConnection;
+
+/// @brief Is called for each object received over a connection
+///
+/// @param aResult Number of fields, if an object has been deserialized.
+/// `EjfpErrorStreamEnd` or `EjfpErrorSystem`, if the connection has been
+/// closed by the peer or failed; it no longer receives, the descriptor may
+/// be closed, and the slot is freed once the callback returns. Other error
+/// codes are those of `ejfpStreamNext`
+typedef void (*EjfpConnectionsCallback)(void *aContext, EjfpConnection *aConnection, int aResult,
+	const EjfpFieldVariant *aFieldVariants);
+
+typedef struct {
+	int epollFd;
+	EjfpConnection *connections;
+	size_t connectionsSize;
+	char *buffers;
+	size_t bufferSize;
+
+	/// @brief Objects are handed over one at a time, so connections share the field storage
+	EjfpFieldVariant *fieldVariants;
+	size_t fieldVariantsSize;
+
+	EjfpConnectionsCallback callback;
+	void *context;
+} EjfpConnections;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @param aBuffers `aConnectionsSize * aBufferSize` bytes. An object must fit
+/// into `aBufferSize`
+/// @return `EjfpOk`, if succeeded. `EjfpErrorSystem` otherwise
+int ejfpConnectionsInitialize(EjfpConnections *aConnections, EjfpConnection *aConnectionArray,
+	size_t aConnectionsSize, char *aBuffers, size_t aBufferSize, EjfpFieldVariant *aFieldVariants,
+	size_t aFieldVariantsSize, EjfpConnectionsCallback aCallback, void *aContext);
+
+/// @brief Closes the epoll instance. Connection descriptors are left intact
+void ejfpConnectionsDeinitialize(EjfpConnections *aConnections);
+
+/// @brief Starts receiving from a connected descriptor
+/// @return Connection, if succeeded. NULL, if the pool is full, or `epoll_ctl` has failed
+EjfpConnection *ejfpConnectionsAdd(EjfpConnections *aConnections, int aFd, void *aUserData);
+
+/// @brief Stops receiving. Unprocessed bytes are dropped. May be called from the callback
+void ejfpConnectionsRemove(EjfpConnections *aConnections, EjfpConnection *aConnection);
+
+/// @brief Waits for incoming bytes, and invokes the callback for every
+/// completed object
+///
+/// @param aTimeout Milliseconds, as in `epoll_wait`
+/// @return Number of deserialized objects. `EjfpErrorSystem`, if `epoll_wait` has failed
+int ejfpConnectionsPoll(EjfpConnections *aConnections, int aTimeout);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // defined(__linux__)
+
+#endif  // EJFP_CONNECTIONS_H_
@@ -0,0 +1,246 @@
+//
+// coroutine.hpp
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// C++20 coroutine adapter over `EjfpStream`. A parser suspends while it waits
+// for bytes from an asynchronous source, and resumes as they arrive. It is
+// agnostic of the event loop: whatever resumes the source's awaitable drives
+// the parser.
+//
+
+#ifndef EJFP_COROUTINE_HPP_
+#define EJFP_COROUTINE_HPP_
+
+#include "ejfp/ejfp.hpp"
+#include "ejfp/error.h"
+#include "ejfp/stream.h"
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+namespace ejfp {
+
+template <class T>
+class Task;
+
+namespace detail {
+
+class TaskPromiseBase {
+public:
+	struct FinalAwaiter {
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		/// @brief Symmetric transfer to the awaiting coroutine, if any
+		template <class Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> aCoroutine) noexcept
+		{
+			return aCoroutine.promise().continuation;
+		}
+
+		void await_resume() const noexcept
+		{
+		}
+	};
+
+	std::suspend_always initial_suspend() const noexcept
+	{
+		return {};
+	}
+
+	FinalAwaiter final_suspend() const noexcept
+	{
+		return {};
+	}
+
+	/// @brief EJFP does not use exceptions, neither should byte sources
+	void unhandled_exception() const noexcept
+	{
+		std::terminate();
+	}
+
+	std::coroutine_handle<> continuation = std::noop_coroutine();
+};
+
+template <class T>
+class TaskPromise : public TaskPromiseBase {
+public:
+	Task<T> get_return_object();
+
+	void return_value(T aValue)
+	{
+		value = std::move(aValue);
+	}
+
+	T value{};
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+	Task<void> get_return_object();
+
+	void return_void() const
+	{
+	}
+};
+
+}  // namespace detail
+
+/// @brief Lazy coroutine. Starts when awaited, or by `start`
+template <class T>
+class Task {
+public:
+	using promise_type = detail::TaskPromise<T>;
+
+	explicit Task(std::coroutine_handle<promise_type> aCoroutine) :
+		coroutine{aCoroutine}
+	{
+	}
+
+	Task(Task &&aOther) noexcept :
+		coroutine{std::exchange(aOther.coroutine, {})}
+	{
+	}
+
+	Task(const Task &) = delete;
+	Task &operator=(const Task &) = delete;
+
+	~Task()
+	{
+		if (coroutine) {
+			coroutine.destroy();
+		}
+	}
+
+	/// @brief Runs the task up to its first suspension, for top-level tasks
+	/// which are not awaited by other coroutines
+	void start()
+	{
+		coroutine.resume();
+	}
+
+	bool done() const
+	{
+		return coroutine.done();
+	}
+
+	bool await_ready() const noexcept
+	{
+		return false;
+	}
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> aAwaiting) noexcept
+	{
+		coroutine.promise().continuation = aAwaiting;
+
+		return coroutine;
+	}
+
+	T await_resume()
+	{
+		if constexpr (!std::is_void_v<T>) {
+			return std::move(coroutine.promise().value);
+		}
+	}
+
+private:
+	std::coroutine_handle<promise_type> coroutine;
+};
+
+template <class T>
+inline Task<T> detail::TaskPromise<T>::get_return_object()
+{
+	return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
+
+inline Task<void> detail::TaskPromise<void>::get_return_object()
+{
+	return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+}
+
+/// @brief Asynchronous byte source. `read` returns an awaitable which
+/// completes w/ the number of bytes written into the buffer. 0 means the end
+/// of the stream
+template <class T>
+concept ByteSource = requires(T &aSource, char *aBuffer, std::size_t aSize) {
+	{ aSource.read(aBuffer, aSize).await_resume() } -> std::convertible_to<std::size_t>;
+};
+
+/// @brief Awaitable parser over a byte source. Holds up to `N` fields and
+/// `BufferSize` bytes of incoming data, so an object must fit into
+/// `BufferSize`
+template <ByteSource Source, std::size_t N, std::size_t BufferSize = 1024>
+class AsyncParser {
+public:
+	explicit AsyncParser(Source &aSource) :
+		source{aSource}
+	{
+		ejfpInitialize(&ejfp);
+		ejfpStreamInitialize(&stream, buffer, BufferSize);
+	}
+
+	AsyncParser(const AsyncParser &) = delete;
+	AsyncParser &operator=(const AsyncParser &) = delete;
+
+	/// @brief Awaits the next complete object, e.g.
+	/// `while ((result = co_await parser.next()) != EjfpErrorStreamEnd)`.
+	/// Parsing may proceed after errors, see `ejfpStreamNext`
+	///
+	/// @return Number of fields, see `fields`. `EjfpErrorStreamEnd`, when the
+	/// source is exhausted; an incomplete trailing object is discarded. Error
+	/// code otherwise
+	Task<int> next()
+	{
+		for (;;) {
+			result = ejfpStreamNext(&stream, &ejfp, fieldVariants, N);
+
+			if (result != EjfpErrorDeserializationPartitioned) {
+				co_return result;
+			} else if (isEnd) {
+				co_return EjfpErrorStreamEnd;
+			}
+
+			std::size_t freeSize = 0;
+			char *free = ejfpStreamReserve(&stream, &freeSize);
+			const std::size_t kReceived = co_await source.read(free, freeSize);
+
+			if (kReceived == 0) {
+				isEnd = true;
+			} else {
+				ejfpStreamCommit(&stream, kReceived);
+			}
+		}
+	}
+
+	/// @brief Fields of the last object returned by `next`. They refer to the
+	/// parser's buffer, and stay valid until the next call of `next`
+	Fields fields() const
+	{
+#if EJFP_COMPACT
+		return {fieldVariants, result > 0 ? static_cast<std::size_t>(result) : 0, ejfp.base};
+#else
+		return {fieldVariants, result > 0 ? static_cast<std::size_t>(result) : 0};
+#endif
+	}
+
+private:
+	Source &source;
+	Ejfp ejfp{};
+	EjfpStream stream{};
+	EjfpFieldVariant fieldVariants[N]{};
+	char buffer[BufferSize]{};
+	int result = 0;
+	bool isEnd = false;
+};
+
+}  // namespace ejfp
+
+#endif  // EJFP_COROUTINE_HPP_
@@ -0,0 +1,120 @@
+//
+// crc.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// Reflected CRCs are computed in the low bits of the register, LSB-first.
+// Others are computed in the high bits, MSB-first, so both take a byte per
+// table lookup regardless of the width.
+//
+
+#include "ejfp/crc.h"
+
+/// @brief Reverses the order of the lower `aWidth` bits
+static uint32_t reflect(uint32_t aValue, unsigned aWidth);
+
+static uint32_t reflect(uint32_t aValue, unsigned aWidth)
+{
+	uint32_t result = 0;
+
+	for (unsigned i = 0; i < aWidth; ++i, aValue >>= 1) {
+		result = (result << 1) | (aValue & 1);
+	}
+
+	return result;
+}
+
+void ejfpCrcInitialize(EjfpCrc *aCrc, const EjfpCrcParameters *aParameters, uint32_t *aTable, size_t aTableSize)
+{
+	const unsigned kShift = 32 - aParameters->width;
+	aCrc->parameters = *aParameters;
+	aCrc->table = aTable;
+	aCrc->isSliced = aTableSize >= EJFP_CRC_SLICED_TABLE_SIZE;
+
+	if (aParameters->isReflected) {
+		const uint32_t kPolynomial = reflect(aParameters->polynomial, aParameters->width);
+
+		for (uint32_t i = 0; i < EJFP_CRC_TABLE_SIZE; ++i) {
+			uint32_t entry = i;
+
+			for (int bit = 0; bit < 8; ++bit) {
+				entry = (entry >> 1) ^ ((entry & 1) ? kPolynomial : 0);
+			}
+
+			aTable[i] = entry;
+		}
+	} else {
+		const uint32_t kPolynomial = aParameters->polynomial << kShift;
+
+		for (uint32_t i = 0; i < EJFP_CRC_TABLE_SIZE; ++i) {
+			uint32_t entry = i << 24;
+
+			for (int bit = 0; bit < 8; ++bit) {
+				entry = (entry << 1) ^ ((entry & 0x80000000u) ? kPolynomial : 0);
+			}
+
+			aTable[i] = entry;
+		}
+	}
+
+	// Slice k is the CRC of a byte followed by k zero bytes
+	for (size_t i = EJFP_CRC_TABLE_SIZE; aCrc->isSliced && i < EJFP_CRC_SLICED_TABLE_SIZE; ++i) {
+		const uint32_t kPrevious = aTable[i - EJFP_CRC_TABLE_SIZE];
+		aTable[i] = aParameters->isReflected ? (kPrevious >> 8) ^ aTable[kPrevious & 0xff] :
+			(kPrevious << 8) ^ aTable[kPrevious >> 24];
+	}
+}
+
+uint32_t ejfpCrcStart(const EjfpCrc *aCrc)
+{
+	return aCrc->parameters.isReflected ? reflect(aCrc->parameters.initial, aCrc->parameters.width) :
+		aCrc->parameters.initial << (32 - aCrc->parameters.width);
+}
+
+uint32_t ejfpCrcUpdate(const EjfpCrc *aCrc, uint32_t aRegister, const void *aData, size_t aDataSize)
+{
+	const uint8_t *it = (const uint8_t *)aData;
+	const uint8_t *const kEnd = it + aDataSize;
+	const uint32_t *table = aCrc->table;
+
+	if (aCrc->parameters.isReflected) {
+		for (; aCrc->isSliced && kEnd - it >= 8; it += 8) {
+			aRegister ^= (uint32_t)it[0] | (uint32_t)it[1] << 8 | (uint32_t)it[2] << 16 | (uint32_t)it[3] << 24;
+			aRegister = table[7 * 256 + (aRegister & 0xff)] ^ table[6 * 256 + ((aRegister >> 8) & 0xff)]
+				^ table[5 * 256 + ((aRegister >> 16) & 0xff)] ^ table[4 * 256 + (aRegister >> 24)]
+				^ table[3 * 256 + it[4]] ^ table[2 * 256 + it[5]] ^ table[256 + it[6]] ^ table[it[7]];
+		}
+
+		for (; it != kEnd; ++it) {
+			aRegister = (aRegister >> 8) ^ table[(aRegister ^ *it) & 0xff];
+		}
+	} else {
+		for (; aCrc->isSliced && kEnd - it >= 8; it += 8) {
+			aRegister ^= (uint32_t)it[0] << 24 | (uint32_t)it[1] << 16 | (uint32_t)it[2] << 8 | (uint32_t)it[3];
+			aRegister = table[7 * 256 + (aRegister >> 24)] ^ table[6 * 256 + ((aRegister >> 16) & 0xff)]
+				^ table[5 * 256 + ((aRegister >> 8) & 0xff)] ^ table[4 * 256 + (aRegister & 0xff)]
+				^ table[3 * 256 + it[4]] ^ table[2 * 256 + it[5]] ^ table[256 + it[6]] ^ table[it[7]];
+		}
+
+		for (; it != kEnd; ++it) {
+			aRegister = (aRegister << 8) ^ table[(aRegister >> 24) ^ *it];
+		}
+	}
+
+	return aRegister;
+}
+
+uint32_t ejfpCrcFinish(const EjfpCrc *aCrc, uint32_t aRegister)
+{
+	if (!aCrc->parameters.isReflected) {
+		aRegister >>= 32 - aCrc->parameters.width;
+	}
+
+	return aRegister ^ aCrc->parameters.xorOut;
+}
+
+uint32_t ejfpCrcCompute(const EjfpCrc *aCrc, const void *aData, size_t aDataSize)
+{
+	return ejfpCrcFinish(aCrc, ejfpCrcUpdate(aCrc, ejfpCrcStart(aCrc), aData, aDataSize));
+}
@@ -0,0 +1,74 @@
+//
+// crc.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Table-driven CRCs of up to 32 bits, described by the Rocksoft model. The
+// table is caller-provided, and its size selects the algorithm: a byte at a
+// time w/ 256 entries (1 KiB), or slice-by-8 w/ 8 * 256 entries (8 KiB), which
+// is several times faster on hosts.
+//
+
+#ifndef EJFP_CRC_H_
+#define EJFP_CRC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define EJFP_CRC_TABLE_SIZE 256
+#define EJFP_CRC_SLICED_TABLE_SIZE (8 * EJFP_CRC_TABLE_SIZE)
+
+/// @brief CRC-32/ISO-HDLC, as in Ethernet and zlib
+#define EJFP_CRC32 {32, 1, 0x04c11db7u, 0xffffffffu, 0xffffffffu}
+
+/// @brief CRC-16/MODBUS
+#define EJFP_CRC16_MODBUS {16, 1, 0x8005u, 0xffffu, 0}
+
+/// @brief CRC-16/IBM-3740, a.k.a. CRC-16/CCITT-FALSE
+#define EJFP_CRC16_CCITT {16, 0, 0x1021u, 0xffffu, 0}
+
+typedef struct {
+	uint8_t width;  ///< 8 to 32 bits
+	uint8_t isReflected;  ///< Both the input and the output
+	uint32_t polynomial;  ///< W/o the top bit, MSB-first, e.g. 0x04c11db7
+	uint32_t initial;
+	uint32_t xorOut;
+} EjfpCrcParameters;
+
+typedef struct {
+	EjfpCrcParameters parameters;
+
+	/// @brief Caller-provided
+	uint32_t *table;
+	uint8_t isSliced;
+} EjfpCrc;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @brief Fills the table
+///
+/// @param aTableSize `EJFP_CRC_SLICED_TABLE_SIZE` or more enables slice-by-8.
+/// Must be at least `EJFP_CRC_TABLE_SIZE`
+void ejfpCrcInitialize(EjfpCrc *aCrc, const EjfpCrcParameters *aParameters, uint32_t *aTable, size_t aTableSize);
+
+/// @return Register at the start of a message
+uint32_t ejfpCrcStart(const EjfpCrc *aCrc);
+
+/// @brief Feeds bytes into the register. Messages may be fed in chunks of any size
+/// @return Updated register
+uint32_t ejfpCrcUpdate(const EjfpCrc *aCrc, uint32_t aRegister, const void *aData, size_t aDataSize);
+
+/// @return Checksum of the bytes fed into the register
+uint32_t ejfpCrcFinish(const EjfpCrc *aCrc, uint32_t aRegister);
+
+/// @brief Checksum of a message at once
+uint32_t ejfpCrcCompute(const EjfpCrc *aCrc, const void *aData, size_t aDataSize);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // EJFP_CRC_H_
@@ -0,0 +1,147 @@
+//
+// delta.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/delta.h"
+#include "ejfp/error.h"
+#include "ejfp/fieldVariant.h"
+#include "ejfp/format.h"
+#include "ejfp/serialization.h"
+#include <string.h>
+
+#if !EJFP_COMPACT  // Requires pointer-based fields, see `EJFP_COMPACT`
+
+#define FNV1A64_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV1A64_PRIME 0x100000001b3ULL
+
+void ejfpDeltaInitialize(EjfpDelta *aDelta, uint64_t *aDigests, size_t aDigestsSize, unsigned aSnapshotPeriod)
+{
+	aDelta->digests = aDigests;
+	aDelta->digestsSize = aDigestsSize;
+	aDelta->snapshotPeriod = aSnapshotPeriod;
+	aDelta->counter = 0;
+	aDelta->isSnapshotPending = 1;
+}
+
+void ejfpDeltaForceSnapshot(EjfpDelta *aDelta)
+{
+	aDelta->isSnapshotPending = 1;
+}
+
+uint64_t ejfpFieldVariantDigest(const EjfpFieldVariant *aFieldVariant)
+{
+	uint64_t digest = 0;
+
+	switch (aFieldVariant->fieldType) {
+		case EjfpFieldVariantTypeInteger:
+		case EjfpFieldVariantTypeBoolean:
+			digest = (uint64_t)(int64_t)aFieldVariant->integerValue;
+
+			break;
+
+#if EJFP_ENABLE_INT64
+		case EjfpFieldVariantTypeInteger64:
+		case EjfpFieldVariantTypeUnsignedInteger64:
+			digest = aFieldVariant->unsignedInteger64Value;
+
+			break;
+#endif  // EJFP_ENABLE_INT64
+
+#if EJFP_ENABLE_REAL
+		case EjfpFieldVariantTypeFloat: {
+			uint32_t bits;
+			memcpy(&bits, &aFieldVariant->floatValue, sizeof(bits));
+			digest = bits;
+
+			break;
+		}
+
+		case EjfpFieldVariantTypeDouble:
+			memcpy(&digest, &aFieldVariant->doubleValue, sizeof(digest));
+
+			break;
+#endif  // EJFP_ENABLE_REAL
+
+#if EJFP_ENABLE_FIXED
+		case EjfpFieldVariantTypeFixed:
+			// Mix the scale in, so e.g. 1.0 and 10 differ
+			digest = ((uint64_t)(int64_t)aFieldVariant->fixedValue ^ aFieldVariant->fixedDigits) * FNV1A64_PRIME;
+
+			break;
+#endif  // EJFP_ENABLE_FIXED
+
+		case EjfpFieldVariantTypeString: {
+			const size_t kLength = ejfpFieldVariantStringLength(aFieldVariant);
+			digest = FNV1A64_OFFSET_BASIS;
+
+			for (size_t i = 0; i < kLength; ++i) {
+				digest = (digest ^ (unsigned char)aFieldVariant->stringValue[i]) * FNV1A64_PRIME;
+			}
+
+			break;
+		}
+
+#if EJFP_ENABLE_BINARY
+		case EjfpFieldVariantTypeBinary:
+			digest = FNV1A64_OFFSET_BASIS;
+
+			for (size_t i = 0; aFieldVariant->binaryValue != NULL && i < aFieldVariant->binaryValueSize; ++i) {
+				digest = (digest ^ aFieldVariant->binaryValue[i]) * FNV1A64_PRIME;
+			}
+
+			break;
+#endif  // EJFP_ENABLE_BINARY
+
+		default:
+			break;
+	}
+
+	// Mix the type in, so e.g. `0` and `false` differ
+	return digest ^ ((uint64_t)aFieldVariant->fieldType * FNV1A64_PRIME);
+}
+
+int ejfpSerializeDelta(EjfpDelta *aDelta, Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize,
+	char *aOut, size_t aOutSize)
+{
+	EjfpFieldVariant changed[aFieldVariantsSize > 0 ? aFieldVariantsSize : 1];
+	uint64_t digests[aFieldVariantsSize > 0 ? aFieldVariantsSize : 1];
+	size_t nChanged = 0;
+	int isSnapshot = aDelta->isSnapshotPending
+		|| (aDelta->snapshotPeriod != 0 && aDelta->counter % aDelta->snapshotPeriod == 0);
+	int outputSize = 0;
+
+	if (aFieldVariantsSize > aDelta->digestsSize) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	for (size_t i = 0; i < aFieldVariantsSize; ++i) {
+		digests[i] = ejfpFieldVariantDigest(&aFieldVariants[i]);
+
+		if (isSnapshot || digests[i] != aDelta->digests[i]) {
+			changed[nChanged++] = aFieldVariants[i];
+		}
+	}
+
+	if (nChanged == 0) {
+		++aDelta->counter;
+
+		return 0;
+	}
+
+	outputSize = ejfpSerialize(aEjfp, changed, nChanged, aOut, aOutSize);
+
+	if (outputSize == 0) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	memcpy(aDelta->digests, digests, aFieldVariantsSize * sizeof(uint64_t));
+	aDelta->isSnapshotPending = 0;
+	++aDelta->counter;
+
+	return outputSize;
+}
+
+#endif  // !EJFP_COMPACT
@@ -0,0 +1,63 @@
+//
+// delta.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Delta serialization: only the fields which have changed since the last
+// emitted message are serialized, w/ a periodic full snapshot.
+//
+
+#ifndef EJFP_DELTA_H_
+#define EJFP_DELTA_H_
+
+#include "ejfp/ejfp.h"
+#include "ejfp/fieldVariant.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#if !EJFP_COMPACT  // Requires pointer-based fields, see `EJFP_COMPACT`
+
+/// @brief Remembers the last emitted value of each field as a 64-bit digest.
+/// Fields are identified by their position in the array
+typedef struct {
+	uint64_t *digests;
+	size_t digestsSize;
+
+	/// @brief Each `snapshotPeriod`-th message contains all fields. 0 disables periodic snapshots
+	unsigned snapshotPeriod;
+	unsigned counter;
+
+	/// @brief If set, the next message contains all fields
+	int isSnapshotPending;
+} EjfpDelta;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @param aDigests Storage for per-field digests, one per field of the message
+void ejfpDeltaInitialize(EjfpDelta *aDelta, uint64_t *aDigests, size_t aDigestsSize, unsigned aSnapshotPeriod);
+
+/// @brief Makes the next message a full snapshot, e.g. when the peer has reconnected
+void ejfpDeltaForceSnapshot(EjfpDelta *aDelta);
+
+/// @brief Digest of a field value: the value itself for scalars, FNV-1a hash
+/// for strings. The type is mixed in, so a type change is also a change
+uint64_t ejfpFieldVariantDigest(const EjfpFieldVariant *aFieldVariant);
+
+/// @brief Serializes the fields which have changed since the last call. The
+/// digests are updated only if the serialization succeeds
+///
+/// @return Output size, if succeeded. 0, if nothing has changed, and nothing
+/// has been written. Error code otherwise
+int ejfpSerializeDelta(EjfpDelta *aDelta, Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize,
+	char *aOut, size_t aOutSize);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !EJFP_COMPACT
+
+#endif  // EJFP_DELTA_H_
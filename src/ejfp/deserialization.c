@@ -5,11 +5,21 @@
 //  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
 //
 
+#include "ejfp/base64.h"
+#include "ejfp/cbor.h"
+#include "ejfp/deserialization.h"
 #include "ejfp/ejfp.h"
 #include "ejfp/error.h"
 #include "ejfp/fieldVariant.h"
+#include "ejfp/trace.h"
+#if EJFP_COMPACT
+#include <jsmn/jsmn_fwd.h>  // Tokens are split by `compactTokenize`
+#else
 #include <jsmn/jsmn.h>
+#endif
+#include <limits.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -26,22 +36,140 @@ typedef enum {
 /// expected in an incoming JSON
 static size_t maxJsmnTokens(size_t aFieldVariantArraySize);
 
-/// @brief  Checks whether JSON structure is supported
-Bool jsmntoksIsValid(jsmntok_t *aJsmntoks, int aNParsedTokens);
+/// @brief Converts a key/value pair of tokens into a field. Both field
+/// layouts are filled through the `EJFP_FIELD_SET_*` accessors, so the modes
+/// accept the same inputs
+///
+/// @return `EjfpOk`, if succeeded. Error code otherwise
+static EjfpError pairParse(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariant, const char *aInputBuffer,
+	size_t aNameStart, size_t aNameEnd, jsmntype_t aValueType, size_t aValueStart, size_t aValueEnd);
+
+#if EJFP_COMPACT
+
+/// @brief Tokens in the structure-of-arrays layout: 5 bytes per token instead
+/// of `sizeof(jsmntok_t)`. Positions fit into 16 bits, see
+/// `EJFP_COMPACT_BASE_SIZE_MAX`
+typedef struct {
+	uint16_t *start;
+	uint16_t *end;
+
+	/// @brief `jsmntype_t`, w/ `COMPACT_TOKEN_OPEN` set while an object or an
+	/// array is not closed
+	uint8_t *type;
+} CompactTokens;
+
+#define COMPACT_TOKEN_OPEN 0x80
+
+/// @brief Splits the input into tokens the way "jsmn" does in its non-strict
+/// mode, see `ringTokenize`
+/// @return Number of tokens, if succeeded. Error code otherwise
+static int compactTokenize(const char *aInputBuffer, size_t aInputBufferSize, CompactTokens *aTokens,
+	size_t aTokensSize);
+
+/// @brief Scans a string token, `aPosition` is expected to point at the
+/// opening quote, and is moved to the closing one
+static int compactTokenizeString(const char *aInputBuffer, size_t aInputBufferSize, size_t *aPosition);
+
+/// @brief Scans a primitive token, and moves `aPosition` past its last character
+static int compactTokenizePrimitive(const char *aInputBuffer, size_t aInputBufferSize, size_t *aPosition);
+
+/// @brief Same rules as `ejfpJsmntoksIsValid`
+static Bool compactTokensIsValid(const CompactTokens *aTokens, int aNParsedTokens);
+
+#else
 
 /// @brief Sets positions in an input string for input tokens
-static EjfpError jsmntoksTokenize(Ejfp *aEjfp, jsmntok_t *jsmntoks, size_t *jsmntoksSize, const char *aInputBuffer,
-	size_t aInputBufferSize);
+static EjfpError jsmntoksTokenize(Ejfp *aEjfp, jsmn_parser *aJsmnParser, jsmntok_t *jsmntoks, size_t *jsmntoksSize,
+	const char *aInputBuffer, size_t aInputBufferSize);
 
 /// @brief  Converts tokens into values
-static EjfpError jsmntoksParse(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+/// @return Number of filled `EjfpFieldVariant` instances. Error code otherwise
+static int jsmntoksParse(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
 	jsmntok_t *aJsmntokArray, size_t aJsmntokArraySize, const char *aInputBuffer);
 
+/// @brief Matches an object against the layout remembered by the shape cache,
+/// and converts its values. Accepts a subset of what the general path
+/// accepts, and produces the same fields for it
+///
+/// @return Number of filled `EjfpFieldVariant` instances. -1, if the object
+/// does not match, or its syntax has to be checked by the general path
+static int shapeParse(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const char *aInputBuffer, size_t aInputBufferSize);
+
+/// @brief Remembers the layout of a deserialized object. Forgets the previous
+/// one, if the new one does not fit into the buffer
+static void shapeRemember(EjfpShapeCache *aShapeCache, const EjfpFieldVariant *aFieldVariants,
+	size_t aNFieldVariants);
+
+/// @brief Skips the content of a string, and checks escape sequences the way
+/// "jsmn" does
+/// @return Position of the closing quote, or NULL
+static const char *shapeStringSkip(const char *aIt, const char *aEnd);
+
+static const char *whitespaceSkip(const char *aIt, const char *aEnd);
+
+/// @brief Walks an object the way `ejfpSerialize` writes it, see
+/// `ejfpSetTrusted`. Neither whitespaces, nor escape sequences are checked
+///
+/// @return Number of filled `EjfpFieldVariant` instances. Error code otherwise
+static int trustedParse(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const char *aInputBuffer, size_t aInputBufferSize);
+
+/// @return Position of the closing quote, or `aEnd`
+static const char *trustedStringSkip(const char *aIt, const char *aEnd);
+
+/// @brief Deserializes a JSON object by one of the paths above
+/// @return Number of filled `EjfpFieldVariant` instances. Error code otherwise
+static int jsonDeserialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const char *aInputBuffer, size_t aInputBufferSize);
+
+#if EJFP_ENABLE_BINARY
+/// @brief Decodes the string fields listed by `ejfpSetBinarySchema`. Runs
+/// after the object is parsed, so the paths above, and the shape cache, only
+/// see strings
+///
+/// @param aInPlace Writable `aInputBuffer`, see `ejfpDeserializeInPlace`.
+/// If NULL, blobs are decoded into the buffer of the schema
+/// @return `aNFieldVariants`, if succeeded. Error code otherwise
+static int binaryDecode(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, int aNFieldVariants,
+	const char *aInputBuffer, char *aInPlace);
+#endif  // EJFP_ENABLE_BINARY
+
+/// @brief `ejfpDeserialize`, and `ejfpDeserializeInPlace`, if `aInPlace` is not NULL
+static int deserialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const char *aInputBuffer, size_t aInputBufferSize, char *aInPlace);
+
+#endif  // EJFP_COMPACT
+
+/// @brief Converts a numeric primitive into the narrowest type which represents it exactly
+static void numericParse(EjfpFieldVariant *aFieldVariant, const char *aTokenStart, const char *aTokenEnd);
+
+/// @brief `ejfpFieldVariantParsePrimitive` w/ respect to the per-field
+/// settings of an instance, see `ejfpSetFixedSchema`
+static void primitiveParse(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariant, const char *aName,
+	size_t aNameLength, const char *aTokenStart, size_t aTokenLength);
+
+#if EJFP_ENABLE_FIXED
+
+/// @return Number of fractional digits of a fixed-point field, or -1, if the
+/// field is not one
+static int fixedDigitsFind(const Ejfp *aEjfp, const char *aName, size_t aNameLength);
+
+/// @brief Converts a JSON number into a fixed-point decimal using integer
+/// arithmetics only. Sets `EjfpFieldVariantTypeUninitialized` on overflow,
+/// or if the token is not a number
+static void fixedParse(EjfpFieldVariant *aFieldVariant, const char *aTokenStart, const char *aTokenEnd,
+	unsigned aDigits);
+
+#endif  // EJFP_ENABLE_FIXED
+
 static int intMin(int aLhs, int aRhs)
 {
 	return aLhs > aRhs ? aRhs : aLhs;
 }
 
+#if !EJFP_COMPACT
+
 /// @brief "jsmn" does not make distinctions between integers, floats, and
 /// booleans
 /// @pre The type must be `JSMN_PRIMITIVE`
@@ -49,31 +177,282 @@ EjfpFieldVariantType jsmntokGetRefinedPrimitiveType(jsmntok_t *aJsmntok)
 {
 }
 
+#endif  // !EJFP_COMPACT
+
+static void numericParse(EjfpFieldVariant *aFieldVariant, const char *aTokenStart, const char *aTokenEnd)
+{
+	const char *ch = aTokenStart;
+	Bool isNegative = BoolFalse;
+	Bool isOverflow = BoolFalse;
+	uint64_t magnitude = 0;
+
+	// Disabled types are reported as uninitialized, see "ejfp/config.h"
+	aFieldVariant->fieldType = EjfpFieldVariantTypeUninitialized;
+
+	// Check whether it is a float through looking for special characters unique to float format
+	for (const char *it = aTokenStart; it != aTokenEnd; ++it) {
+		if (*it == '.' || *it == 'E' || *it == 'e') {
+#if EJFP_ENABLE_REAL
+			double value = strtod(aTokenStart, NULL);
+
+			if ((double)(float)value == value) {
+				aFieldVariant->fieldType = EjfpFieldVariantTypeFloat;
+				aFieldVariant->floatValue = (float)value;
+			} else {
+				aFieldVariant->fieldType = EjfpFieldVariantTypeDouble;
+				aFieldVariant->doubleValue = value;
+			}
+#endif  // EJFP_ENABLE_REAL
+
+			return;
+		}
+	}
+
+	if (ch != aTokenEnd && *ch == '-') {
+		isNegative = BoolTrue;
+		++ch;
+	}
+
+	// Accumulate the magnitude w/ overflow detection instead of relying on `atoi`
+	for (; ch != aTokenEnd && *ch >= '0' && *ch <= '9'; ++ch) {
+		const unsigned digit = *ch - '0';
+
+		if (magnitude > (UINT64_MAX - digit) / 10) {
+			isOverflow = BoolTrue;
+
+			break;
+		}
+
+		magnitude = magnitude * 10 + digit;
+	}
+
+	if (isOverflow || (isNegative && magnitude > (uint64_t)INT64_MAX + 1)) {
+#if EJFP_ENABLE_REAL
+		aFieldVariant->fieldType = EjfpFieldVariantTypeDouble;
+		aFieldVariant->doubleValue = strtod(aTokenStart, NULL);
+#endif  // EJFP_ENABLE_REAL
+	} else if (isNegative) {
+		if (magnitude <= (uint64_t)INT_MAX + 1) {
+			aFieldVariant->fieldType = EjfpFieldVariantTypeInteger;
+			aFieldVariant->integerValue = (int)(0 - magnitude);
+		} else {
+#if EJFP_ENABLE_INT64
+			aFieldVariant->fieldType = EjfpFieldVariantTypeInteger64;
+			aFieldVariant->integer64Value = (int64_t)(0 - magnitude);
+#endif  // EJFP_ENABLE_INT64
+		}
+	} else if (magnitude <= INT_MAX) {
+		aFieldVariant->fieldType = EjfpFieldVariantTypeInteger;
+		aFieldVariant->integerValue = (int)magnitude;
+	} else {
+#if EJFP_ENABLE_INT64
+		if (magnitude <= INT64_MAX) {
+			aFieldVariant->fieldType = EjfpFieldVariantTypeInteger64;
+			aFieldVariant->integer64Value = (int64_t)magnitude;
+		} else {
+			aFieldVariant->fieldType = EjfpFieldVariantTypeUnsignedInteger64;
+			aFieldVariant->unsignedInteger64Value = magnitude;
+		}
+#endif  // EJFP_ENABLE_INT64
+	}
+}
+
+#if EJFP_ENABLE_FIXED
+
+static int fixedDigitsFind(const Ejfp *aEjfp, const char *aName, size_t aNameLength)
+{
+	for (size_t i = 0; i < aEjfp->fixedFieldsSize; ++i) {
+		const char *fieldName = aEjfp->fixedFields[i].fieldName;
+
+		if (strncmp(fieldName, aName, aNameLength) == 0 && fieldName[aNameLength] == '\0') {
+			return aEjfp->fixedFields[i].digits;
+		}
+	}
+
+	return -1;
+}
+
+static void fixedParse(EjfpFieldVariant *aFieldVariant, const char *aTokenStart, const char *aTokenEnd,
+	unsigned aDigits)
+{
+	static const uint64_t kMax = EJFP_ENABLE_INT64 ? (uint64_t)INT64_MAX : (uint64_t)INT32_MAX;
+	const char *ch = aTokenStart;
+	Bool isNegative = BoolFalse;
+	Bool isFraction = BoolFalse;
+	Bool hasDigits = BoolFalse;
+	Bool isTruncated = BoolFalse;
+	uint64_t mantissa = 0;
+	unsigned droppedDigit = 0;  // The first digit which has not fit into `mantissa`, for rounding
+	long exponent = 0;  // value = mantissa * 10^exponent
+	aFieldVariant->fieldType = EjfpFieldVariantTypeUninitialized;
+
+	if (ch != aTokenEnd && *ch == '-') {
+		isNegative = BoolTrue;
+		++ch;
+	}
+
+	for (; ch != aTokenEnd; ++ch) {
+		if (*ch == '.' && !isFraction) {
+			isFraction = BoolTrue;
+		} else if (*ch >= '0' && *ch <= '9') {
+			hasDigits = BoolTrue;
+
+			if (mantissa <= (UINT64_MAX - 9) / 10) {
+				mantissa = mantissa * 10 + (unsigned)(*ch - '0');
+				exponent -= isFraction;
+			} else {
+				if (!isTruncated) {
+					isTruncated = BoolTrue;
+					droppedDigit = (unsigned)(*ch - '0');
+				}
+
+				exponent += !isFraction;
+			}
+		} else {
+			break;
+		}
+	}
+
+	if (!hasDigits) {
+		return;
+	}
+
+	if (ch != aTokenEnd && (*ch == 'e' || *ch == 'E')) {
+		Bool isExponentNegative = BoolFalse;
+		long explicitExponent = 0;
+		++ch;
+
+		if (ch != aTokenEnd && (*ch == '-' || *ch == '+')) {
+			isExponentNegative = *ch == '-';
+			++ch;
+		}
+
+		if (ch == aTokenEnd) {
+			return;
+		}
+
+		for (; ch != aTokenEnd && *ch >= '0' && *ch <= '9'; ++ch) {
+			if (explicitExponent < 10000) {  // Saturate, the result is either 0, or an overflow anyway
+				explicitExponent = explicitExponent * 10 + (*ch - '0');
+			}
+		}
+
+		exponent += isExponentNegative ? -explicitExponent : explicitExponent;
+	}
+
+	if (ch != aTokenEnd) {
+		return;
+	}
+
+	// Scale: value * 10^digits = mantissa * 10^shift
+	long shift = exponent + (long)aDigits;
+
+	if (shift >= 0) {
+		if (shift == 0 && droppedDigit >= 5) {
+			++mantissa;
+		}
+
+		for (; shift > 0 && mantissa != 0; --shift) {
+			if (mantissa > kMax / 10) {
+				return;
+			}
+
+			mantissa *= 10;
+		}
+	} else if (shift < -20) {
+		mantissa = 0;  // 10^20 exceeds any `uint64_t`
+	} else {
+		for (; shift < -1; ++shift) {
+			mantissa /= 10;
+		}
+
+		// Half away from zero. Digits past the first dropped one cannot affect it
+		mantissa = mantissa / 10 + (mantissa % 10 >= 5);
+	}
+
+	if (mantissa > kMax + isNegative) {
+		return;
+	}
+
+	aFieldVariant->fieldType = EjfpFieldVariantTypeFixed;
+	aFieldVariant->fixedValue = isNegative ? (EjfpFixed)(0 - mantissa) : (EjfpFixed)mantissa;
+	aFieldVariant->fixedDigits = (uint8_t)aDigits;
+}
+
+#endif  // EJFP_ENABLE_FIXED
+
+static void primitiveParse(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariant, const char *aName,
+	size_t aNameLength, const char *aTokenStart, size_t aTokenLength)
+{
+#if EJFP_ENABLE_FIXED
+	const int kDigits = fixedDigitsFind(aEjfp, aName, aNameLength);
+
+	// `true`, `false`, and `null` are allowed for fixed-point fields too
+	if (kDigits >= 0 && aTokenLength > 0 && (*aTokenStart == '-' || (*aTokenStart >= '0' && *aTokenStart <= '9'))) {
+		fixedParse(aFieldVariant, aTokenStart, aTokenStart + aTokenLength, (unsigned)kDigits);
+
+		return;
+	}
+#else
+	(void)aEjfp;
+	(void)aName;
+	(void)aNameLength;
+#endif  // EJFP_ENABLE_FIXED
+
+	ejfpFieldVariantParsePrimitive(aFieldVariant, aTokenStart, aTokenLength);
+}
+
 static inline size_t maxJsmnTokens(size_t aFieldVariantArraySize)
 {
 	return 1 + aFieldVariantArraySize * 2;
 }
 
-/// @brief
-/// @param aJsmntoks
-/// @param aJsmntoksSize Is expected to be of valid length
-/// @return
-Bool jsmntoksIsValid(jsmntok_t *aJsmntoks, int aNParsedTokens)
+static EjfpError pairParse(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariant, const char *aInputBuffer,
+	size_t aNameStart, size_t aNameEnd, jsmntype_t aValueType, size_t aValueStart, size_t aValueEnd)
 {
-	size_t i = 0;
+	const char *kName = &aInputBuffer[aNameStart];
+	const size_t kNameLength = aNameEnd - aNameStart;
+	const char *kValue = &aInputBuffer[aValueStart];
+	const size_t kValueLength = aValueEnd - aValueStart;
+	EJFP_FIELD_SET_NAME(aInputBuffer, aFieldVariant, kName, kNameLength);
 
-	if (aJsmntoks[i].type == JSMN_OBJECT) {
-		++i;
+	if (aValueType == JSMN_STRING) {
+		aFieldVariant->fieldType = EjfpFieldVariantTypeString;
+		EJFP_FIELD_SET_STRING(aInputBuffer, aFieldVariant, kValue, kValueLength);
+
+		return EjfpOk;
+	}
+
+	// "jsmn" does not make a distinction b/w integer, null, float, and boolean types
+	primitiveParse(aEjfp, aFieldVariant, kName, kNameLength, kValue, kValueLength);
+
+	return aFieldVariant->fieldType == EjfpFieldVariantTypeUninitialized ?
+		EjfpErrorDeserializationUnsupportedJsonStructure : EjfpOk;
+}
+
+#if !EJFP_COMPACT
+
+int ejfpJsmntoksIsValid(const jsmntok_t *aJsmntoks, int aNParsedTokens)
+{
+	if (aNParsedTokens == 0) {
+		return BoolTrue;
+	} else if (aJsmntoks[0].type != JSMN_OBJECT) {
+		return BoolFalse;  // Pairs are expected to start at the 2nd token, see `jsmntoksParse`
 	}
 
-	for (; i < aNParsedTokens; i += 2) {
-		if (aJsmntoks[i].type != JSMN_STRING) {
+	for (int i = 1; i < aNParsedTokens; i += 2) {
+		if (aJsmntoks[i].type != JSMN_STRING || i + 1 == aNParsedTokens) {
 			return BoolFalse;
 		}
 
 		if (aJsmntoks[i + 1].type != JSMN_PRIMITIVE && aJsmntoks[i + 1].type != JSMN_STRING) {
 			return BoolFalse;
 		}
+
+		// Tokens which follow the object, e.g. `{"a": 1} "b" 2`
+		if (aJsmntoks[i + 1].end > aJsmntoks[0].end) {
+			return BoolFalse;
+		}
 	}
 
 	return BoolTrue;
@@ -81,16 +460,19 @@ Bool jsmntoksIsValid(jsmntok_t *aJsmntoks, int aNParsedTokens)
 
 /// @brief
 /// @param aEjfp
+/// @param aJsmnParser
 /// @param jsmntoks
 /// @param jsmntoksSize  Will be set to the actual number of parsed tokens
 /// @param aInputBuffer
 /// @param aInputBufferSize
 /// @return
-static inline EjfpError jsmntoksTokenize(Ejfp *aEjfp, jsmntok_t *jsmntoks, size_t *jsmntoksSize, const char *aInputBuffer,
-	size_t aInputBufferSize)
+static inline EjfpError jsmntoksTokenize(Ejfp *aEjfp, jsmn_parser *aJsmnParser, jsmntok_t *jsmntoks,
+	size_t *jsmntoksSize, const char *aInputBuffer, size_t aInputBufferSize)
 {
 	int error = EjfpOk;
-	int nParsedTokens = jsmn_parse(&aEjfp->jsmnParser, aInputBuffer, aInputBufferSize, jsmntoks, *jsmntoksSize);
+	EJFP_TRACE_MARK(aEjfp, traceMark);
+	int nParsedTokens = jsmn_parse(aJsmnParser, aInputBuffer, aInputBufferSize, jsmntoks, *jsmntoksSize);
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseTokenize, aInputBufferSize, traceMark);
 
 	if (nParsedTokens < 0) {
 		switch (nParsedTokens) {
@@ -108,7 +490,10 @@ static inline EjfpError jsmntoksTokenize(Ejfp *aEjfp, jsmntok_t *jsmntoks, size_
 				break;
 		}
 	} else {
-		if (!jsmntoksIsValid(jsmntoks, nParsedTokens)) {  // Verify JSON structure
+		const Bool kIsValid = ejfpJsmntoksIsValid(jsmntoks, nParsedTokens);  // Verify JSON structure
+		EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseValidate, aInputBufferSize, traceMark);
+
+		if (!kIsValid) {
 			error = EjfpErrorDeserializationUnsupportedJsonStructure;
 		}
 
@@ -119,7 +504,7 @@ static inline EjfpError jsmntoksTokenize(Ejfp *aEjfp, jsmntok_t *jsmntoks, size_
 }
 
 /// @brief Expects a sequence of ("key": true | false | null | INTEGER | FLOAT) pairs
-static inline EjfpError jsmntoksParse(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+static inline int jsmntoksParse(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
 	jsmntok_t *aJsmntokArray, size_t aJsmntokArraySize, const char *aInputBuffer)
 {
 	size_t iFieldVariant = 0;
@@ -132,99 +517,684 @@ static inline EjfpError jsmntoksParse(Ejfp *aEjfp, EjfpFieldVariant *aFieldVaria
 			return EjfpErrorDeserializationNoMemory;
 		}
 
-		// Initialize field name
-		size_t tokenLength = token->end - token->start;
-		const char *tokenStart = &aInputBuffer[token->start];
-		const char *tokenEnd = &aInputBuffer[token->end];
-		aFieldVariantArray[iFieldVariant].fieldName = tokenStart;
-		aFieldVariantArray[iFieldVariant].fieldNameLength = tokenLength;
+		const EjfpError kError = pairParse(aEjfp, &aFieldVariantArray[iFieldVariant], aInputBuffer, token[0].start,
+			token[0].end, token[1].type, token[1].start, token[1].end);
 
-		// Advance the token
+		if (EjfpOk != kError) {
+			return kError;
+		}
+
+		// Advance to the value token
 		++token;
-		tokenStart = &aInputBuffer[token->start];
-		tokenEnd = &aInputBuffer[token->end];
-		tokenLength = token->end - token->start;
-
-		{
-			switch (token->type) {
-				case JSMN_STRING:
-					aFieldVariantArray[iFieldVariant].fieldType = EjfpFieldVariantTypeString;
-					aFieldVariantArray[iFieldVariant].stringValue = tokenStart;
-					aFieldVariantArray[iFieldVariant].stringValueLength = tokenLength;
-
-					break;
-
-				// "jsml" does not make a distinction b/w integer, null, float, and boolean types
-				case JSMN_PRIMITIVE: {
-					static const char *trueValue = "true";
-					static const char *falseValue = "false";
-					static const char *nullValue = "null";
-					static const size_t trueValueLength = sizeof("true");
-					static const size_t falseValueLength = sizeof("false");
-					static const size_t nullValueLength = sizeof("null");
-
-					// Check booleans
-					if (strncmp(tokenStart, trueValue, intMin(tokenLength, trueValueLength)) == 0) {
-						aFieldVariantArray[iFieldVariant].fieldType = EjfpFieldVariantTypeBoolean;
-						aFieldVariantArray[iFieldVariant].booleanValue = BoolTrue;
-					} else if (strncmp(tokenStart, falseValue, intMin(tokenLength, falseValueLength)) == 0) {
-						aFieldVariantArray[iFieldVariant].fieldType = EjfpFieldVariantTypeBoolean;
-						aFieldVariantArray[iFieldVariant].booleanValue = BoolFalse;
-					// Check null
-					} else if (strncmp(tokenStart, nullValue, intMin(tokenLength, nullValueLength)) == 0) {
-						aFieldVariantArray[iFieldVariant].fieldType = EjfpFieldVariantTypeNull;
-					// Check numeric
-					} else {
-						// Temporary storage to provide null-terminated strings
-						aFieldVariantArray[iFieldVariant].fieldType = EjfpFieldVariantTypeInteger;  // Assume integer by default
-
-						// Check whether it is a float through looking for special characters unique to float format
-						enum {
-							FloatMarkerNone = 0,
-							FloatMarkerDot = '.',
-							FloatMarkerEBig = 'E',
-							FloatMarkerESmall = 'e'
-						} floatMarker = FloatMarkerNone;
-
-						for (const char *ch = tokenStart; ch != tokenEnd; ++ch) {
-							if (*ch == FloatMarkerDot || *ch == FloatMarkerEBig || *ch == FloatMarkerESmall) {
-								aFieldVariantArray[iFieldVariant].fieldType = EjfpFieldVariantTypeFloat;
-
-								break;
-							}
-						}
-
-						switch (aFieldVariantArray[iFieldVariant].fieldType) {
-							case EjfpFieldVariantTypeInteger:
-								aFieldVariantArray[iFieldVariant].integerValue = atoi(tokenStart);
-
-								break;
-
-							case EjfpFieldVariantTypeFloat:
-								aFieldVariantArray[iFieldVariant].floatValue = atof(tokenStart);
-
-								break;
-						}
-					}
+	}
+
+	return (int)iFieldVariant;
+}
+
+static inline const char *whitespaceSkip(const char *aIt, const char *aEnd)
+{
+	while (aIt != aEnd && (*aIt == ' ' || *aIt == '\t' || *aIt == '\n' || *aIt == '\r')) {
+		++aIt;
+	}
+
+	return aIt;
+}
+
+static const char *shapeStringSkip(const char *aIt, const char *aEnd)
+{
+	for (; aIt != aEnd && *aIt != '\0'; ++aIt) {
+		if (*aIt == '"') {
+			return aIt;
+		} else if (*aIt != '\\') {
+			continue;
+		}
+
+		if (++aIt == aEnd) {
+			return NULL;
+		} else if (*aIt == 'u') {
+			for (int i = 0; i < 4; ++i) {
+				if (++aIt == aEnd || !((*aIt >= '0' && *aIt <= '9') || (*aIt >= 'a' && *aIt <= 'f')
+					|| (*aIt >= 'A' && *aIt <= 'F'))) {
+					return NULL;
+				}
+			}
+		} else if (strchr("\"/\\bfrnt", *aIt) == NULL || *aIt == '\0') {
+			return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+static int shapeParse(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const char *aInputBuffer, size_t aInputBufferSize)
+{
+	const EjfpShapeCache *shapeCache = aEjfp->shapeCache;
+	const char *it = whitespaceSkip(aInputBuffer, aInputBuffer + aInputBufferSize);
+	const char *end = aInputBuffer + aInputBufferSize;
+	const char *record = shapeCache->buffer;
 
-					break;
+	if (shapeCache->size == 0 || shapeCache->nFields > aFieldVariantArraySize || it == end || *it++ != '{') {
+		return -1;
+	}
+
+	for (size_t i = 0; i < shapeCache->nFields; ++i) {
+		EjfpFieldVariant *fieldVariant = &aFieldVariantArray[i];
+		const EjfpFieldVariantType kType = (EjfpFieldVariantType)(uint8_t)record[0];
+		const size_t kKeyLength = (uint8_t)record[1];
+		const char *valueStart = NULL;
+
+		// Key at the predicted position
+		it = whitespaceSkip(it, end);
+
+		if ((size_t)(end - it) < kKeyLength + 2 || *it != '"' || it[kKeyLength + 1] != '"'
+			|| memcmp(it + 1, record + 2, kKeyLength) != 0) {
+			return -1;
+		}
+
+		fieldVariant->fieldName = it + 1;
+		fieldVariant->fieldNameLength = kKeyLength;
+		it = whitespaceSkip(it + kKeyLength + 2, end);
+		record += 2 + kKeyLength;
+
+		if (it == end || *it++ != ':') {
+			return -1;
+		}
+
+		it = whitespaceSkip(it, end);
+		valueStart = it;
+
+		if (kType == EjfpFieldVariantTypeString) {
+			if (it == end || *it++ != '"' || (it = shapeStringSkip(it, end)) == NULL) {
+				return -1;
+			}
+
+			fieldVariant->fieldType = EjfpFieldVariantTypeString;
+			fieldVariant->stringValue = valueStart + 1;
+			fieldVariant->stringValueLength = it - valueStart - 1;
+			++it;
+		} else {
+			// Same token boundaries as in "jsmn"
+			for (; it != end && *it != ',' && *it != '}' && *it != ' ' && *it != '\t' && *it != '\n'
+				&& *it != '\r'; ++it) {
+				if (*it < 32 || *it >= 127 || *it == '"' || *it == ':' || *it == '{' || *it == '[' || *it == ']') {
+					return -1;
 				}
 			}
+
+			if (it == valueStart) {
+				return -1;
+			}
+
+			primitiveParse(aEjfp, fieldVariant, fieldVariant->fieldName, kKeyLength, valueStart,
+				it - valueStart);
+
+			if (fieldVariant->fieldType == EjfpFieldVariantTypeUninitialized) {
+				return -1;  // Let the general path report the error
+			}
+		}
+
+		it = whitespaceSkip(it, end);
+
+		if (it == end || *it++ != (i + 1 == shapeCache->nFields ? '}' : ',')) {
+			return -1;
 		}
+	}
+
+	if (shapeCache->nFields == 0) {
+		it = whitespaceSkip(it, end);
 
+		if (it == end || *it++ != '}') {
+			return -1;
+		}
 	}
 
+	// "jsmn" stops at the NULL character
+	it = whitespaceSkip(it, end);
+
+	return it == end || *it == '\0' ? (int)shapeCache->nFields : -1;
+}
+
+static void shapeRemember(EjfpShapeCache *aShapeCache, const EjfpFieldVariant *aFieldVariants,
+	size_t aNFieldVariants)
+{
+	char *record = aShapeCache->buffer;
+	aShapeCache->size = 0;
+
+	for (size_t i = 0; i < aNFieldVariants; ++i) {
+		const size_t kKeyLength = aFieldVariants[i].fieldNameLength;
+
+		if (kKeyLength > UINT8_MAX || aShapeCache->bufferSize - (record - aShapeCache->buffer) < 2 + kKeyLength) {
+			return;
+		}
+
+		record[0] = (char)aFieldVariants[i].fieldType;
+		record[1] = (char)kKeyLength;
+		memcpy(record + 2, aFieldVariants[i].fieldName, kKeyLength);
+		record += 2 + kKeyLength;
+	}
+
+	// `{}` is remembered as well, hence an additional byte
+	if (record == aShapeCache->buffer) {
+		if (aShapeCache->bufferSize == 0) {
+			return;
+		}
+
+		++record;
+	}
+
+	aShapeCache->size = record - aShapeCache->buffer;
+	aShapeCache->nFields = aNFieldVariants;
+}
+
+static inline const char *trustedStringSkip(const char *aIt, const char *aEnd)
+{
+	for (const char *quote; (quote = (const char *)memchr(aIt, '"', aEnd - aIt)) != NULL; aIt = quote + 1) {
+		// A quote is escaped by an odd number of backslashes right before it
+		const char *backslash = quote;
+
+		while (backslash != aIt && backslash[-1] == '\\') {
+			--backslash;
+		}
+
+		if ((quote - backslash) % 2 == 0) {
+			return quote;
+		}
+	}
+
+	return aEnd;
+}
+
+static int trustedParse(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const char *aInputBuffer, size_t aInputBufferSize)
+{
+	const char *it = aInputBuffer;
+	const char *const kEnd = aInputBuffer + aInputBufferSize;
+	size_t nFieldVariants = 0;
+
+	if (kEnd - it < 2) {
+		return EjfpErrorDeserializationPartitioned;
+	} else if (*it++ != '{') {
+		return EjfpErrorDeserializationInvalidSyntax;
+	} else if (*it == '}') {
+		return 0;
+	}
+
+	for (;;) {
+		if (nFieldVariants == aFieldVariantArraySize) {
+			return EjfpErrorDeserializationNoMemory;
+		}
+
+		EjfpFieldVariant *fieldVariant = &aFieldVariantArray[nFieldVariants];
+
+		// "key":
+		if (*it++ != '"') {
+			return EjfpErrorDeserializationInvalidSyntax;
+		}
+
+		fieldVariant->fieldName = it;
+		it = trustedStringSkip(it, kEnd);
+		fieldVariant->fieldNameLength = it - fieldVariant->fieldName;
+
+		if (kEnd - it < 3) {
+			return EjfpErrorDeserializationPartitioned;
+		} else if (it[1] != ':') {
+			return EjfpErrorDeserializationInvalidSyntax;
+		}
+
+		it += 2;
+
+		// Value, followed by ',' or '}'
+		if (*it == '"') {
+			fieldVariant->fieldType = EjfpFieldVariantTypeString;
+			fieldVariant->stringValue = ++it;
+			it = trustedStringSkip(it, kEnd);
+			fieldVariant->stringValueLength = it - fieldVariant->stringValue;
+
+			if (kEnd - it < 2) {
+				return EjfpErrorDeserializationPartitioned;
+			}
+
+			++it;
+		} else {
+			const char *valueStart = it;
+
+			while (it != kEnd && *it != ',' && *it != '}') {
+				++it;
+			}
+
+			if (it == kEnd) {
+				return EjfpErrorDeserializationPartitioned;
+			}
+
+			primitiveParse(aEjfp, fieldVariant, fieldVariant->fieldName, fieldVariant->fieldNameLength, valueStart,
+				it - valueStart);
+
+			if (fieldVariant->fieldType == EjfpFieldVariantTypeUninitialized) {
+				return EjfpErrorDeserializationUnsupportedJsonStructure;
+			}
+		}
+
+		++nFieldVariants;
+
+		if (*it++ == '}') {
+			return (int)nFieldVariants;
+		} else if (it == kEnd) {
+			return EjfpErrorDeserializationPartitioned;
+		}
+	}
+}
+
+#endif  // !EJFP_COMPACT
+
+void ejfpFieldVariantParsePrimitive(EjfpFieldVariant *aFieldVariant, const char *aTokenStart, size_t aTokenLength)
+{
+	static const char *trueValue = "true";
+	static const char *falseValue = "false";
+	static const char *nullValue = "null";
+	static const size_t trueValueLength = sizeof("true");
+	static const size_t falseValueLength = sizeof("false");
+	static const size_t nullValueLength = sizeof("null");
+
+	// Check booleans
+	if (strncmp(aTokenStart, trueValue, intMin(aTokenLength, trueValueLength)) == 0) {
+		aFieldVariant->fieldType = EjfpFieldVariantTypeBoolean;
+		aFieldVariant->booleanValue = BoolTrue;
+	} else if (strncmp(aTokenStart, falseValue, intMin(aTokenLength, falseValueLength)) == 0) {
+		aFieldVariant->fieldType = EjfpFieldVariantTypeBoolean;
+		aFieldVariant->booleanValue = BoolFalse;
+	// Check null
+	} else if (strncmp(aTokenStart, nullValue, intMin(aTokenLength, nullValueLength)) == 0) {
+		aFieldVariant->fieldType = EjfpFieldVariantTypeNull;
+	// Check numeric
+	} else {
+		numericParse(aFieldVariant, aTokenStart, aTokenStart + aTokenLength);
+	}
+}
+
+void ejfpFieldVariantParseSchemaPrimitive(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariant, const char *aName,
+	size_t aNameLength, const char *aTokenStart, size_t aTokenLength)
+{
+	primitiveParse(aEjfp, aFieldVariant, aName, aNameLength, aTokenStart, aTokenLength);
+}
+
+#if EJFP_COMPACT
+
+static int compactTokenize(const char *aInputBuffer, size_t aInputBufferSize, CompactTokens *aTokens,
+	size_t aTokensSize)
+{
+	size_t nTokens = 0;
+
+	// Like "jsmn", treat the NULL character as the end of input
+	for (size_t position = 0; position < aInputBufferSize && aInputBuffer[position] != '\0'; ++position) {
+		const char kCharacter = aInputBuffer[position];
+		const uint8_t kOpen = (kCharacter == '{' || kCharacter == '}' ? JSMN_OBJECT : JSMN_ARRAY) | COMPACT_TOKEN_OPEN;
+		const size_t kStart = position;
+		int error = EjfpOk;
+		size_t i = nTokens;
+
+		switch (kCharacter) {
+			case '\t':
+			case '\r':
+			case '\n':
+			case ' ':
+			case ':':  // Separators only link tokens to their parents, which is not used
+			case ',':
+				break;
+
+			case '{':
+			case '[':
+				if (nTokens == aTokensSize) {
+					return EjfpErrorDeserializationNoMemory;
+				}
+
+				aTokens->type[nTokens] = kOpen;
+				aTokens->start[nTokens] = (uint16_t)position;
+				++nTokens;
+
+				break;
+
+			case '}':
+			case ']':
+				// Closes the innermost open container
+				while (i > 0 && !(aTokens->type[i - 1] & COMPACT_TOKEN_OPEN)) {
+					--i;
+				}
+
+				if (i == 0 || aTokens->type[i - 1] != kOpen) {
+					return EjfpErrorDeserializationInvalidSyntax;
+				}
+
+				aTokens->type[i - 1] &= ~COMPACT_TOKEN_OPEN;
+				aTokens->end[i - 1] = (uint16_t)(position + 1);
+
+				break;
+
+			default:
+				// Syntax errors take precedence over the lack of tokens, as in "jsmn"
+				error = kCharacter == '"' ? compactTokenizeString(aInputBuffer, aInputBufferSize, &position) :
+					compactTokenizePrimitive(aInputBuffer, aInputBufferSize, &position);
+
+				if (EjfpOk != error) {
+					return error;
+				} else if (nTokens == aTokensSize) {
+					return EjfpErrorDeserializationNoMemory;
+				}
+
+				if (kCharacter == '"') {
+					aTokens->type[nTokens] = JSMN_STRING;
+					aTokens->start[nTokens] = (uint16_t)(kStart + 1);
+					aTokens->end[nTokens] = (uint16_t)position;
+				} else {
+					aTokens->type[nTokens] = JSMN_PRIMITIVE;
+					aTokens->start[nTokens] = (uint16_t)kStart;
+					aTokens->end[nTokens] = (uint16_t)position--;
+				}
+
+				++nTokens;
+
+				break;
+		}
+	}
+
+	for (size_t i = 0; i < nTokens; ++i) {
+		if (aTokens->type[i] & COMPACT_TOKEN_OPEN) {
+			return EjfpErrorDeserializationPartitioned;  // Unmatched open container
+		}
+	}
+
+	return (int)nTokens;
+}
+
+static int compactTokenizeString(const char *aInputBuffer, size_t aInputBufferSize, size_t *aPosition)
+{
+	for (size_t position = *aPosition + 1; position < aInputBufferSize && aInputBuffer[position] != '\0';
+			++position) {
+		const char kCharacter = aInputBuffer[position];
+
+		if (kCharacter == '"') {
+			*aPosition = position;
+
+			return EjfpOk;
+		} else if (kCharacter != '\\' || position + 1 >= aInputBufferSize) {
+			continue;
+		}
+
+		switch (aInputBuffer[++position]) {
+			case '"':
+			case '/':
+			case '\\':
+			case 'b':
+			case 'f':
+			case 'r':
+			case 'n':
+			case 't':
+				break;
+
+			case 'u':
+				for (size_t i = 0; i < 4 && position + 1 < aInputBufferSize && aInputBuffer[position + 1] != '\0';
+						++i) {
+					const char kDigit = aInputBuffer[++position];
+
+					if (!((kDigit >= '0' && kDigit <= '9') || (kDigit >= 'A' && kDigit <= 'F')
+							|| (kDigit >= 'a' && kDigit <= 'f'))) {
+						return EjfpErrorDeserializationInvalidSyntax;
+					}
+				}
+
+				break;
+
+			default:
+				return EjfpErrorDeserializationInvalidSyntax;
+		}
+	}
+
+	return EjfpErrorDeserializationPartitioned;
+}
+
+static int compactTokenizePrimitive(const char *aInputBuffer, size_t aInputBufferSize, size_t *aPosition)
+{
+	size_t position = *aPosition;
+
+	for (; position < aInputBufferSize && aInputBuffer[position] != '\0'; ++position) {
+		const char kCharacter = aInputBuffer[position];
+
+		if (kCharacter == '\t' || kCharacter == '\r' || kCharacter == '\n' || kCharacter == ' '
+				|| kCharacter == ':' || kCharacter == ',' || kCharacter == ']' || kCharacter == '}') {
+			break;
+		} else if (kCharacter < 32 || kCharacter >= 127) {
+			return EjfpErrorDeserializationInvalidSyntax;
+		}
+	}
+
+	// A primitive is complete at the end of the input too
+	*aPosition = position;
+
 	return EjfpOk;
 }
 
+static Bool compactTokensIsValid(const CompactTokens *aTokens, int aNParsedTokens)
+{
+	if (aNParsedTokens == 0) {
+		return BoolTrue;
+	} else if (aTokens->type[0] != JSMN_OBJECT) {
+		return BoolFalse;
+	}
+
+	for (int i = 1; i < aNParsedTokens; i += 2) {
+		if (aTokens->type[i] != JSMN_STRING || i + 1 == aNParsedTokens) {
+			return BoolFalse;
+		}
+
+		if (aTokens->type[i + 1] != JSMN_PRIMITIVE && aTokens->type[i + 1] != JSMN_STRING) {
+			return BoolFalse;
+		}
+
+		if (aTokens->end[i + 1] > aTokens->end[0]) {
+			return BoolFalse;
+		}
+	}
+
+	return BoolTrue;
+}
+
 int ejfpDeserialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
 	const char *aInputBuffer, size_t aInputBufferSize)
 {
+	int result = EjfpOk;
+
+	// Offsets must fit into 16 bits
+	if (aInputBufferSize > EJFP_COMPACT_BASE_SIZE_MAX) {
+		return EjfpErrorDeserializationNoMemory;
+	}
+
+	// Tokens only live through the call
+	const size_t kTokensSize = maxJsmnTokens(aFieldVariantArraySize);
+	uint16_t tokenStarts[kTokensSize];
+	uint16_t tokenEnds[kTokensSize];
+	uint8_t tokenTypes[kTokensSize];
+	CompactTokens tokens = {tokenStarts, tokenEnds, tokenTypes};
+	EJFP_TRACE_MARK(aEjfp, callMark);
+	EJFP_TRACE_MARK(aEjfp, traceMark);
+	const int kNParsedTokens = compactTokenize(aInputBuffer, aInputBufferSize, &tokens, kTokensSize);
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseTokenize, aInputBufferSize, traceMark);
+
+	if (kNParsedTokens < 0) {
+		result = kNParsedTokens;
+	} else if (!compactTokensIsValid(&tokens, kNParsedTokens)) {
+		result = EjfpErrorDeserializationUnsupportedJsonStructure;
+	}
+
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseValidate, aInputBufferSize, traceMark);
+
+	// Pairs start at the 2nd token, see `compactTokensIsValid`
+	for (int i = 1; EjfpOk == result && i < kNParsedTokens; i += 2) {
+		if ((size_t)(i / 2) == aFieldVariantArraySize) {
+			result = EjfpErrorDeserializationNoMemory;
+		} else {
+			result = pairParse(aEjfp, &aFieldVariantArray[i / 2], aInputBuffer, tokens.start[i], tokens.end[i],
+				(jsmntype_t)tokens.type[i + 1], tokens.start[i + 1], tokens.end[i + 1]);
+		}
+	}
+
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseParse, aInputBufferSize, traceMark);
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseDeserialize, aInputBufferSize, callMark);
+
+	if (EjfpOk == result) {
+		result = kNParsedTokens / 2;
+		aEjfp->base = aInputBuffer;
+	}
+
+	return result;
+}
+
+#else
+
+#if EJFP_ENABLE_BINARY
+
+static int binaryDecode(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, int aNFieldVariants,
+	const char *aInputBuffer, char *aInPlace)
+{
+	char *out = aEjfp->binaryBuffer;
+	size_t outSize = aEjfp->binaryBufferSize;
+
+	for (int i = 0; i < aNFieldVariants; ++i) {
+		EjfpFieldVariant *fieldVariant = &aFieldVariants[i];
+
+		if (fieldVariant->fieldType != EjfpFieldVariantTypeString) {
+			continue;
+		}
+
+		for (size_t j = 0; j < aEjfp->binaryFieldsSize; ++j) {
+			const char *fieldName = aEjfp->binaryFields[j];
+
+			if (strncmp(fieldVariant->fieldName, fieldName, fieldVariant->fieldNameLength) != 0
+					|| fieldName[fieldVariant->fieldNameLength] != '\0') {
+				continue;
+			}
+
+			const char *kText = fieldVariant->stringValue;
+			const size_t kTextLength = fieldVariant->stringValueLength;
+			const size_t kSize = ejfpBase64DecodedSize(kText, kTextLength);
+
+			// In place, the blob takes the place of its text
+			char *blob = aInPlace != NULL ? aInPlace + (kText - aInputBuffer) : out;
+
+			if (aInPlace == NULL && (out == NULL || outSize < kSize)) {
+				return EjfpErrorDeserializationNoMemory;
+			}
+
+			const int kError = ejfpBase64Decode(blob, kText, kTextLength);
+
+			if (EjfpOk != kError) {
+				return kError;
+			}
+
+			fieldVariant->fieldType = EjfpFieldVariantTypeBinary;
+			fieldVariant->binaryValue = (const uint8_t *)blob;
+			fieldVariant->binaryValueSize = kSize;
+
+			if (aInPlace == NULL) {
+				out += kSize;
+				outSize -= kSize;
+			}
+
+			break;
+		}
+	}
+
+	return aNFieldVariants;
+}
+
+int ejfpFieldVariantsDecodeBinary(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, int aNFieldVariants)
+{
+	return binaryDecode(aEjfp, aFieldVariants, aNFieldVariants, NULL, NULL);
+}
+
+#endif  // EJFP_ENABLE_BINARY
+
+static int deserialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const char *aInputBuffer, size_t aInputBufferSize, char *aInPlace)
+{
+	EJFP_TRACE_MARK(aEjfp, traceMark);
+	int result = aEjfp->encoding == EjfpEncodingCbor ?
+		ejfpCborDeserialize(aFieldVariantArray, aFieldVariantArraySize, aInputBuffer, aInputBufferSize) :
+		jsonDeserialize(aEjfp, aFieldVariantArray, aFieldVariantArraySize, aInputBuffer, aInputBufferSize);
+
+#if EJFP_ENABLE_BINARY
+	// CBOR has byte strings of its own
+	if (aEjfp->encoding == EjfpEncodingJson && result > 0 && aEjfp->binaryFieldsSize > 0) {
+		result = binaryDecode(aEjfp, aFieldVariantArray, result, aInputBuffer, aInPlace);
+	}
+#else
+	(void)aInPlace;
+#endif  // EJFP_ENABLE_BINARY
+
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseDeserialize, aInputBufferSize, traceMark);
+
+	return result;
+}
+
+int ejfpDeserialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const char *aInputBuffer, size_t aInputBufferSize)
+{
+	return deserialize(aEjfp, aFieldVariantArray, aFieldVariantArraySize, aInputBuffer, aInputBufferSize, NULL);
+}
+
+#if EJFP_ENABLE_BINARY
+
+int ejfpDeserializeInPlace(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	char *aInputBuffer, size_t aInputBufferSize)
+{
+	return deserialize(aEjfp, aFieldVariantArray, aFieldVariantArraySize, aInputBuffer, aInputBufferSize,
+		aInputBuffer);
+}
+
+#endif  // EJFP_ENABLE_BINARY
+
+static int jsonDeserialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const char *aInputBuffer, size_t aInputBufferSize)
+{
+	EjfpShapeCache *shapeCache = aEjfp->shapeCache;
+
+#if !EJFP_LARGE_INPUT
+	// Positions would overflow, see `EJFP_LARGE_INPUT`
+	if (aInputBufferSize > INT_MAX) {
+		return EjfpErrorDeserializationNoMemory;
+	}
+#endif  // !EJFP_LARGE_INPUT
+
+	if (aEjfp->isTrusted) {
+		EJFP_TRACE_MARK(aEjfp, traceMark);
+		const int kNFieldVariants = trustedParse(aEjfp, aFieldVariantArray, aFieldVariantArraySize, aInputBuffer,
+			aInputBufferSize);
+		EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseParse, aInputBufferSize, traceMark);
+
+		return kNFieldVariants;
+	}
+
+	// Speculate only on a fresh input, as "jsmn" may be in the middle of one
+	if (shapeCache != NULL && aEjfp->jsmnParser.pos == 0 && aEjfp->jsmnParser.toknext == 0) {
+		EJFP_TRACE_MARK(aEjfp, traceMark);
+		const int kNFieldVariants = shapeParse(aEjfp, aFieldVariantArray, aFieldVariantArraySize, aInputBuffer,
+			aInputBufferSize);
+
+		if (kNFieldVariants >= 0) {
+			EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseParse, aInputBufferSize, traceMark);
+			++shapeCache->nHits;
+
+			return kNFieldVariants;
+		}
+
+		++shapeCache->nMisses;
+	}
+
 	size_t jsmntoksSize = maxJsmnTokens(aFieldVariantArraySize);
 	jsmntok_t jsmntoks[jsmntoksSize];
 	int parsingError = EjfpOk;
 	memset(jsmntoks, 0, sizeof(jsmntok_t) * jsmntoksSize);
-	parsingError = jsmntoksTokenize(aEjfp, jsmntoks, &jsmntoksSize, aInputBuffer, aInputBufferSize);
+	parsingError = jsmntoksTokenize(aEjfp, &aEjfp->jsmnParser, jsmntoks, &jsmntoksSize, aInputBuffer,
+		aInputBufferSize);
 
 	if (EjfpOk != parsingError) {
 		return parsingError;
@@ -239,12 +1209,16 @@ int ejfpDeserialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aF
 			return parsingError;
 	}
 
+	EJFP_TRACE_MARK(aEjfp, traceMark);
 	parsingError = jsmntoksParse(aEjfp, aFieldVariantArray, aFieldVariantArraySize, jsmntoks, jsmntoksSize,
 		aInputBuffer);
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseParse, aInputBufferSize, traceMark);
 
-	if (EjfpOk == parsingError) {
-
+	if (shapeCache != NULL && parsingError >= 0) {
+		shapeRemember(shapeCache, aFieldVariantArray, (size_t)parsingError);
 	}
 
 	return parsingError;
 }
+
+#endif  // EJFP_COMPACT
@@ -15,12 +15,60 @@
 extern "C" {
 #endif  // __cplusplus
 
-/// @brief Deserializes bytes into an array of `EjfpFieldVariant` instances
+/// @brief Deserializes bytes into an array of `EjfpFieldVariant` instances.
+/// The input is never written to
 ///
 /// @return Number of filled tokens in `EjfpFieldVariant`. Error code otherwise
 int ejfpDeserialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
 	const char *aInputBuffer, size_t aInputBufferSize);
 
+#if EJFP_ENABLE_BINARY && !EJFP_COMPACT
+
+/// @brief Same as `ejfpDeserialize`, except that blobs are decoded in place,
+/// i.e. over their base64 text, instead of the buffer set by
+/// `ejfpSetBinarySchema`. Other fields reference the input as usual
+int ejfpDeserializeInPlace(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	char *aInputBuffer, size_t aInputBufferSize);
+
+#endif  // EJFP_ENABLE_BINARY && !EJFP_COMPACT
+
+/// @brief Converts a JSON primitive (boolean, null, number) into a field
+/// value. Numbers are converted into the narrowest type which represents
+/// them exactly. Sets the type to `Uninitialized`, if the value requires a
+/// type disabled by "ejfp/config.h"
+///
+/// @pre The token must be followed by a non-numeric character
+void ejfpFieldVariantParsePrimitive(EjfpFieldVariant *aFieldVariant, const char *aTokenStart, size_t aTokenLength);
+
+/// @brief `ejfpFieldVariantParsePrimitive` w/ respect to the per-field
+/// settings of an instance, see `ejfpSetFixedSchema`. Is shared by the
+/// parsers, so they convert values the same way
+///
+/// @param aName Key of the value, `aNameLength` characters
+void ejfpFieldVariantParseSchemaPrimitive(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariant, const char *aName,
+	size_t aNameLength, const char *aTokenStart, size_t aTokenLength);
+
+#if EJFP_ENABLE_BINARY && !EJFP_COMPACT
+
+/// @brief Decodes the string fields listed by `ejfpSetBinarySchema` into the
+/// buffer of the schema, as `ejfpDeserialize` does
+///
+/// @return `aNFieldVariants`, if succeeded. Error code otherwise
+int ejfpFieldVariantsDecodeBinary(const Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, int aNFieldVariants);
+
+#endif  // EJFP_ENABLE_BINARY && !EJFP_COMPACT
+
+#if !EJFP_COMPACT
+
+/// @brief Checks whether tokens make a supported JSON structure: an object of
+/// key/value pairs w/ string and primitive values, and nothing after it. Is
+/// shared by the parsers, so they accept the same inputs
+///
+/// @return Non-zero, if the structure is supported. An empty input is
+int ejfpJsmntoksIsValid(const jsmntok_t *aJsmntoks, int aNParsedTokens);
+
+#endif  // !EJFP_COMPACT
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
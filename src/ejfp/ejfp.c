@@ -10,7 +10,118 @@
 #include "ejfp.h"
 #include <jsmn/jsmn.h>
 
+#if EJFP_COMPACT
+
+void ejfpInitialize(Ejfp *aEjfp)
+{
+	aEjfp->base = NULL;
+#if EJFP_ENABLE_FIXED
+	ejfpSetFixedSchema(aEjfp, NULL, 0);
+#endif
+#if EJFP_TRACE
+	ejfpSetTrace(aEjfp, NULL);
+#endif
+}
+
+void ejfpReset(Ejfp *aEjfp)
+{
+	aEjfp->base = NULL;
+}
+
+void ejfpSetBase(Ejfp *aEjfp, const char *aBase)
+{
+	aEjfp->base = aBase;
+}
+
+#else
+
 void ejfpInitialize(Ejfp *aEjfp)
 {
 	jsmn_init(&aEjfp->jsmnParser);
+	aEjfp->encoding = EjfpEncodingJson;
+	aEjfp->shapeCache = NULL;
+	aEjfp->isTrusted = 0;
+#if EJFP_ENABLE_FIXED
+	ejfpSetFixedSchema(aEjfp, NULL, 0);
+#endif
+#if EJFP_ENABLE_BINARY
+	ejfpSetBinarySchema(aEjfp, NULL, 0, NULL, 0);
+#endif
+#if EJFP_TRACE
+	ejfpSetTrace(aEjfp, NULL);
+#endif
+}
+
+void ejfpReset(Ejfp *aEjfp)
+{
+	jsmn_init(&aEjfp->jsmnParser);
+}
+
+void ejfpSetEncoding(Ejfp *aEjfp, EjfpEncoding aEncoding)
+{
+	aEjfp->encoding = aEncoding;
+}
+
+void ejfpShapeCacheInitialize(EjfpShapeCache *aShapeCache, char *aBuffer, size_t aBufferSize)
+{
+	aShapeCache->buffer = aBuffer;
+	aShapeCache->bufferSize = aBufferSize;
+	aShapeCache->size = 0;
+	aShapeCache->nFields = 0;
+	aShapeCache->nHits = 0;
+	aShapeCache->nMisses = 0;
+}
+
+void ejfpSetShapeCache(Ejfp *aEjfp, EjfpShapeCache *aShapeCache)
+{
+	aEjfp->shapeCache = aShapeCache;
 }
+
+void ejfpSetTrusted(Ejfp *aEjfp, int aIsTrusted)
+{
+	aEjfp->isTrusted = aIsTrusted != 0;
+}
+
+size_t ejfpShapeCacheHits(const EjfpShapeCache *aShapeCache)
+{
+	return aShapeCache->nHits;
+}
+
+size_t ejfpShapeCacheMisses(const EjfpShapeCache *aShapeCache)
+{
+	return aShapeCache->nMisses;
+}
+
+#endif  // EJFP_COMPACT
+
+#if EJFP_ENABLE_FIXED
+
+void ejfpSetFixedSchema(Ejfp *aEjfp, const EjfpFixedField *aFixedFields, size_t aFixedFieldsSize)
+{
+	aEjfp->fixedFields = aFixedFields;
+	aEjfp->fixedFieldsSize = aFixedFieldsSize;
+}
+
+#endif  // EJFP_ENABLE_FIXED
+
+#if EJFP_ENABLE_BINARY
+
+void ejfpSetBinarySchema(Ejfp *aEjfp, const char *const *aFieldNames, size_t aFieldNamesSize, char *aBuffer,
+	size_t aBufferSize)
+{
+	aEjfp->binaryFields = aFieldNames;
+	aEjfp->binaryFieldsSize = aFieldNamesSize;
+	aEjfp->binaryBuffer = aBuffer;
+	aEjfp->binaryBufferSize = aBufferSize;
+}
+
+#endif  // EJFP_ENABLE_BINARY
+
+#if EJFP_TRACE
+
+void ejfpSetTrace(Ejfp *aEjfp, EjfpTrace *aTrace)
+{
+	aEjfp->trace = aTrace;
+}
+
+#endif  // EJFP_TRACE
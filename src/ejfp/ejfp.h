@@ -8,12 +8,77 @@
 #ifndef EJFP_EJFP_H_
 #define EJFP_EJFP_H_
 
+#include "ejfp/fieldVariant.h"
+#include "ejfp/trace.h"
 #include <jsmn/jsmn_fwd.h>
 
+/// @brief Wire format
+typedef enum {
+	EjfpEncodingJson = 0,
+	EjfpEncodingCbor,  ///< RFC 8949, see "ejfp/cbor.h"
+} EjfpEncoding;
+
+#if EJFP_ENABLE_FIXED
+/// @brief Field which is deserialized as `EjfpFieldVariantTypeFixed`, see
+/// `ejfpSetFixedSchema`
+typedef struct {
+	const char *fieldName;  ///< NULL-terminated
+	uint8_t digits;  ///< Number of fractional digits, up to `EJFP_FIXED_DIGITS_MAX`
+} EjfpFixedField;
+#endif  // EJFP_ENABLE_FIXED
+
+#if !EJFP_COMPACT
+/// @brief Key layout of the last deserialized JSON object, see
+/// `ejfpSetShapeCache`. Treat as opaque
+typedef struct {
+	/// @brief Caller-provided. A record per field: the value type, the key
+	/// length, and the key
+	char *buffer;
+	size_t bufferSize;
+
+	/// @brief Used part of `buffer`. 0 means that no layout is remembered
+	size_t size;
+
+	size_t nFields;
+	size_t nHits;
+	size_t nMisses;
+} EjfpShapeCache;
+#endif  // !EJFP_COMPACT
+
 /// @brief Instance of EJFP
 typedef struct {
+#if EJFP_COMPACT
+	/// @brief Buffer the field offsets refer to. Is set by `ejfpDeserialize`
+	const char *base;
+#else
 	/// @brief Holding an instance of `jsmn_parser` allows for stateful parsing
 	jsmn_parser jsmnParser;
+
+	/// @brief Wire format of `ejfpSerialize` and `ejfpDeserialize`
+	EjfpEncoding encoding;
+
+	/// @brief May be NULL, see `ejfpSetShapeCache`
+	EjfpShapeCache *shapeCache;
+
+	/// @brief Input is canonical `ejfpSerialize` output, see `ejfpSetTrusted`
+	uint8_t isTrusted;
+#endif  // EJFP_COMPACT
+#if EJFP_ENABLE_FIXED
+	const EjfpFixedField *fixedFields;
+	size_t fixedFieldsSize;
+#endif  // EJFP_ENABLE_FIXED
+#if EJFP_ENABLE_BINARY
+	const char *const *binaryFields;
+	size_t binaryFieldsSize;
+
+	/// @brief May be NULL, see `ejfpSetBinarySchema`
+	char *binaryBuffer;
+	size_t binaryBufferSize;
+#endif  // EJFP_ENABLE_BINARY
+#if EJFP_TRACE
+	/// @brief May be NULL, see `ejfpSetTrace`
+	EjfpTrace *trace;
+#endif  // EJFP_TRACE
 } Ejfp;
 
 #ifdef __cplusplus
@@ -22,6 +87,76 @@ extern "C" {
 
 void ejfpInitialize(Ejfp *aEjfp);
 
+/// @brief Drops the state left by a previous message, but keeps the
+/// configuration, i.e. the encoding and the fixed-point schema
+void ejfpReset(Ejfp *aEjfp);
+
+#if EJFP_COMPACT
+/// @brief Sets the buffer field offsets refer to, e.g. a pool of names and
+/// strings for outgoing messages
+void ejfpSetBase(Ejfp *aEjfp, const char *aBase);
+#else
+void ejfpSetEncoding(Ejfp *aEjfp, EjfpEncoding aEncoding);
+
+/// @brief Uses the buffer to remember the layout of JSON objects
+void ejfpShapeCacheInitialize(EjfpShapeCache *aShapeCache, char *aBuffer, size_t aBufferSize);
+
+/// @brief Enables speculative parsing for sources whose messages repeat the
+/// same keys in the same order. An incoming object is matched against the
+/// keys and value kinds (string or primitive) of the last one, and only its
+/// values are converted. If it does not match, it is parsed as usual, and its
+/// layout is remembered instead. The results are the same either way. Only
+/// applies after `ejfpInitialize` or `ejfpReset`, i.e. not to a continuation
+/// of a partitioned input
+///
+/// @param aShapeCache May be shared by instances which receive messages of the
+/// same layout. NULL disables the cache
+void ejfpSetShapeCache(Ejfp *aEjfp, EjfpShapeCache *aShapeCache);
+
+/// @brief Skips validation for sources which run EJFP themselves. An object
+/// is expected to be the way `ejfpSerialize` writes it: w/o whitespaces, w/
+/// string keys, and w/ the values EJFP supports, so it is walked quote by
+/// colon by comma. The input length is still respected, and malformed input
+/// never causes reads outside of it, but it may be accepted, or rejected w/ a
+/// different error than by the validating path. Trusted messages must be
+/// complete, i.e. not partitioned. Takes precedence over the shape cache
+void ejfpSetTrusted(Ejfp *aEjfp, int aIsTrusted);
+
+/// @brief Number of objects which have matched the remembered layout
+size_t ejfpShapeCacheHits(const EjfpShapeCache *aShapeCache);
+
+/// @brief Number of objects which have been parsed in full, as they have not
+/// matched the remembered layout, or there was none
+size_t ejfpShapeCacheMisses(const EjfpShapeCache *aShapeCache);
+#endif  // EJFP_COMPACT
+
+#if EJFP_ENABLE_FIXED
+/// @brief Sets the fields which are deserialized as fixed-point decimals,
+/// i.e. w/o floating point arithmetics. A numeric value is rounded half away
+/// from zero to the field's number of fractional digits. Values which do not
+/// fit into `EjfpFixed` are rejected. The array must outlive the instance
+void ejfpSetFixedSchema(Ejfp *aEjfp, const EjfpFixedField *aFixedFields, size_t aFixedFieldsSize);
+#endif  // EJFP_ENABLE_FIXED
+
+#if EJFP_ENABLE_BINARY
+/// @brief Sets the fields which are deserialized as base64-encoded blobs.
+/// Other values of these fields keep their types. The array must outlive the
+/// instance
+///
+/// @param aFieldNames NULL-terminated
+/// @param aBuffer Blobs of a message are decoded into it one after another.
+/// `ejfpDeserialize` returns `EjfpErrorDeserializationNoMemory`, if it is NULL,
+/// or too small. May be NULL, if only `ejfpDeserializeInPlace` is used
+void ejfpSetBinarySchema(Ejfp *aEjfp, const char *const *aFieldNames, size_t aFieldNamesSize, char *aBuffer,
+	size_t aBufferSize);
+#endif  // EJFP_ENABLE_BINARY
+
+#if EJFP_TRACE
+/// @brief Times `ejfpSerialize` and `ejfpDeserialize` calls of the instance,
+/// and their phases. NULL disables tracing
+void ejfpSetTrace(Ejfp *aEjfp, EjfpTrace *aTrace);
+#endif  // EJFP_TRACE
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
@@ -0,0 +1,458 @@
+//
+// ejfp.hpp
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Header-only C++17 wrapper. Fields are exposed as views into the input
+// buffer, so neither parsing, nor iteration, nor serialization copies or
+// allocates anything.
+//
+
+#ifndef EJFP_EJFP_HPP_
+#define EJFP_EJFP_HPP_
+
+#include "ejfp/deserialization.h"
+#include "ejfp/ejfp.h"
+#include "ejfp/error.h"
+#include "ejfp/fieldVariant.h"
+#include "ejfp/format.h"
+#include "ejfp/sink.h"
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+namespace ejfp {
+
+/// @brief Non-owning view of a field. `aBase` is only used in compact mode,
+/// see `EJFP_COMPACT`
+class FieldView {
+public:
+	constexpr FieldView(const EjfpFieldVariant &aFieldVariant, const char *aBase = nullptr) :
+		fieldVariant{&aFieldVariant},
+		base{aBase}
+	{
+	}
+
+	std::string_view name() const
+	{
+		return {EJFP_FIELD_NAME(base, fieldVariant), ejfpFieldVariantNameLength(fieldVariant)};
+	}
+
+	EjfpFieldVariantType type() const
+	{
+		return static_cast<EjfpFieldVariantType>(fieldVariant->fieldType);
+	}
+
+	const EjfpFieldVariant &raw() const
+	{
+		return *fieldVariant;
+	}
+
+	/// @brief Typed access. Integers and reals are widened, when it is
+	/// lossless, e.g. `Integer` can be read as `std::int64_t`
+	///
+	/// @tparam T `int`, `bool`, `std::string_view`, `std::nullptr_t`,
+	/// `float`, `double`, `std::int64_t`, or `std::uint64_t`
+	/// @return Empty, if the field cannot be represented by `T`
+	template <class T>
+	std::optional<T> get() const;
+
+	template <class T>
+	bool is() const
+	{
+		return get<T>().has_value();
+	}
+
+	/// @brief Calls `aVisitor` w/ the value of the field's own type, like
+	/// `std::visit` does. Uninitialized and disabled types are passed as
+	/// `std::monostate`
+	template <class Visitor>
+	decltype(auto) visit(Visitor &&aVisitor) const;
+
+private:
+	const EjfpFieldVariant *fieldVariant;
+	const char *base;
+};
+
+template <class T>
+inline std::optional<T> FieldView::get() const
+{
+	const auto kType = type();
+
+	if constexpr (std::is_same_v<T, bool>) {
+		if (kType == EjfpFieldVariantTypeBoolean) {
+			return fieldVariant->booleanValue != 0;
+		}
+	} else if constexpr (std::is_same_v<T, int>) {
+		if (kType == EjfpFieldVariantTypeInteger) {
+			return fieldVariant->integerValue;
+		}
+	} else if constexpr (std::is_same_v<T, std::string_view>) {
+		if (kType == EjfpFieldVariantTypeString) {
+			return std::string_view{EJFP_FIELD_STRING(base, fieldVariant), ejfpFieldVariantStringLength(fieldVariant)};
+		}
+	} else if constexpr (std::is_same_v<T, std::nullptr_t>) {
+		if (kType == EjfpFieldVariantTypeNull) {
+			return nullptr;
+		}
+#if EJFP_ENABLE_INT64
+	} else if constexpr (std::is_same_v<T, std::int64_t>) {
+		if (kType == EjfpFieldVariantTypeInteger) {
+			return fieldVariant->integerValue;
+		} else if (kType == EjfpFieldVariantTypeInteger64) {
+			return fieldVariant->integer64Value;
+		}
+	} else if constexpr (std::is_same_v<T, std::uint64_t>) {
+		if (kType == EjfpFieldVariantTypeInteger && fieldVariant->integerValue >= 0) {
+			return fieldVariant->integerValue;
+		} else if (kType == EjfpFieldVariantTypeInteger64 && fieldVariant->integer64Value >= 0) {
+			return fieldVariant->integer64Value;
+		} else if (kType == EjfpFieldVariantTypeUnsignedInteger64) {
+			return fieldVariant->unsignedInteger64Value;
+		}
+#endif  // EJFP_ENABLE_INT64
+#if EJFP_ENABLE_REAL
+	} else if constexpr (std::is_same_v<T, float>) {
+		if (kType == EjfpFieldVariantTypeFloat) {
+			return fieldVariant->floatValue;
+		}
+	} else if constexpr (std::is_same_v<T, double>) {
+		if (kType == EjfpFieldVariantTypeFloat) {
+			return fieldVariant->floatValue;
+		} else if (kType == EjfpFieldVariantTypeDouble) {
+			return fieldVariant->doubleValue;
+		}
+#endif  // EJFP_ENABLE_REAL
+	} else {
+		static_assert(!std::is_same_v<T, T>, "Unsupported type");
+	}
+
+	return std::nullopt;
+}
+
+template <class Visitor>
+inline decltype(auto) FieldView::visit(Visitor &&aVisitor) const
+{
+	switch (type()) {
+		case EjfpFieldVariantTypeInteger:
+			return aVisitor(fieldVariant->integerValue);
+
+		case EjfpFieldVariantTypeBoolean:
+			return aVisitor(fieldVariant->booleanValue != 0);
+
+		case EjfpFieldVariantTypeString:
+			return aVisitor(*get<std::string_view>());
+
+		case EjfpFieldVariantTypeNull:
+			return aVisitor(nullptr);
+
+#if EJFP_ENABLE_REAL
+		case EjfpFieldVariantTypeFloat:
+			return aVisitor(fieldVariant->floatValue);
+
+		case EjfpFieldVariantTypeDouble:
+			return aVisitor(fieldVariant->doubleValue);
+#endif  // EJFP_ENABLE_REAL
+
+#if EJFP_ENABLE_INT64
+		case EjfpFieldVariantTypeInteger64:
+			return aVisitor(fieldVariant->integer64Value);
+
+		case EjfpFieldVariantTypeUnsignedInteger64:
+			return aVisitor(fieldVariant->unsignedInteger64Value);
+#endif  // EJFP_ENABLE_INT64
+
+		default:
+			return aVisitor(std::monostate{});
+	}
+}
+
+/// @brief Range of field views over an array of `EjfpFieldVariant`
+class Fields {
+public:
+	class Iterator {
+	public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = FieldView;
+		using pointer = void;
+		using reference = FieldView;
+		using iterator_category = std::forward_iterator_tag;
+
+		constexpr Iterator(const EjfpFieldVariant *aFieldVariant, const char *aBase) :
+			fieldVariant{aFieldVariant},
+			base{aBase}
+		{
+		}
+
+		FieldView operator*() const
+		{
+			return {*fieldVariant, base};
+		}
+
+		Iterator &operator++()
+		{
+			++fieldVariant;
+
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator previous = *this;
+			++fieldVariant;
+
+			return previous;
+		}
+
+		bool operator==(const Iterator &aOther) const
+		{
+			return fieldVariant == aOther.fieldVariant;
+		}
+
+		bool operator!=(const Iterator &aOther) const
+		{
+			return fieldVariant != aOther.fieldVariant;
+		}
+
+	private:
+		const EjfpFieldVariant *fieldVariant;
+		const char *base;
+	};
+
+	constexpr Fields(const EjfpFieldVariant *aFieldVariants, std::size_t aSize, const char *aBase = nullptr) :
+		fieldVariants{aFieldVariants},
+		fieldVariantsSize{aSize},
+		base{aBase}
+	{
+	}
+
+	Iterator begin() const
+	{
+		return {fieldVariants, base};
+	}
+
+	Iterator end() const
+	{
+		return {fieldVariants + fieldVariantsSize, base};
+	}
+
+	std::size_t size() const
+	{
+		return fieldVariantsSize;
+	}
+
+	bool empty() const
+	{
+		return fieldVariantsSize == 0;
+	}
+
+	FieldView operator[](std::size_t aIndex) const
+	{
+		return {fieldVariants[aIndex], base};
+	}
+
+	/// @brief Linear lookup, the first match wins
+	std::optional<FieldView> find(std::string_view aKey) const
+	{
+		for (FieldView field : *this) {
+			if (field.name() == aKey) {
+				return field;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+private:
+	const EjfpFieldVariant *fieldVariants;
+	std::size_t fieldVariantsSize;
+	const char *base;
+};
+
+/// @brief Deserializes up to `N` fields into storage it owns. Views refer to
+/// the input, which must outlive them
+template <std::size_t N>
+class Parser {
+public:
+	/// @return Number of fields, if succeeded. Error code otherwise
+	int parse(std::string_view aInput)
+	{
+		ejfpInitialize(&ejfp);  // Drop the state left by a previous input
+		result = ejfpDeserialize(&ejfp, fieldVariants, N, aInput.data(), aInput.size());
+
+		return result;
+	}
+
+	/// @brief Fields of the last successful `parse`. Empty otherwise
+	Fields fields() const
+	{
+#if EJFP_COMPACT
+		return {fieldVariants, result > 0 ? static_cast<std::size_t>(result) : 0, ejfp.base};
+#else
+		return {fieldVariants, result > 0 ? static_cast<std::size_t>(result) : 0};
+#endif
+	}
+
+private:
+	Ejfp ejfp{};
+	EjfpFieldVariant fieldVariants[N]{};
+	int result = 0;
+};
+
+#if !EJFP_COMPACT
+
+/// @brief Key/value pair for `serialize`. Keys and string values are
+/// referenced, not copied
+class KeyValue {
+public:
+	KeyValue(std::string_view aKey, bool aValue) :
+		fieldVariant{}
+	{
+		setKey(aKey);
+		fieldVariant.fieldType = EjfpFieldVariantTypeBoolean;
+		fieldVariant.booleanValue = aValue;
+	}
+
+	template <class T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+	KeyValue(std::string_view aKey, T aValue) :
+		fieldVariant{}
+	{
+#if !EJFP_ENABLE_INT64
+		// Otherwise, values out of the range would end the object, see `ejfpSerialize`
+		static_assert(fitsInto<int>(std::numeric_limits<T>::min()) && fitsInto<int>(std::numeric_limits<T>::max()),
+			"Not every value of the type fits into `int`, and 64-bit integers are disabled, see `EJFP_ENABLE_INT64`");
+#endif  // !EJFP_ENABLE_INT64
+		setKey(aKey);
+
+		if (fitsInto<int>(aValue)) {
+			fieldVariant.fieldType = EjfpFieldVariantTypeInteger;
+			fieldVariant.integerValue = static_cast<int>(aValue);
+		} else {
+#if EJFP_ENABLE_INT64
+			if (fitsInto<std::int64_t>(aValue)) {
+				fieldVariant.fieldType = EjfpFieldVariantTypeInteger64;
+				fieldVariant.integer64Value = static_cast<std::int64_t>(aValue);
+			} else {
+				fieldVariant.fieldType = EjfpFieldVariantTypeUnsignedInteger64;
+				fieldVariant.unsignedInteger64Value = static_cast<std::uint64_t>(aValue);
+			}
+#endif  // EJFP_ENABLE_INT64
+		}
+	}
+
+#if EJFP_ENABLE_REAL
+	KeyValue(std::string_view aKey, float aValue) :
+		fieldVariant{}
+	{
+		setKey(aKey);
+		fieldVariant.fieldType = EjfpFieldVariantTypeFloat;
+		fieldVariant.floatValue = aValue;
+	}
+
+	KeyValue(std::string_view aKey, double aValue) :
+		fieldVariant{}
+	{
+		setKey(aKey);
+		fieldVariant.fieldType = EjfpFieldVariantTypeDouble;
+		fieldVariant.doubleValue = aValue;
+	}
+#endif  // EJFP_ENABLE_REAL
+
+	KeyValue(std::string_view aKey, std::string_view aValue) :
+		fieldVariant{}
+	{
+		setKey(aKey);
+		fieldVariant.fieldType = EjfpFieldVariantTypeString;
+		fieldVariant.stringValue = aValue.empty() ? "" : aValue.data();
+		fieldVariant.stringValueLength = aValue.size();
+	}
+
+	KeyValue(std::string_view aKey, const char *aValue) :
+		KeyValue{aKey, std::string_view{aValue}}
+	{
+	}
+
+	KeyValue(std::string_view aKey, std::nullptr_t) :
+		fieldVariant{}
+	{
+		setKey(aKey);
+		fieldVariant.fieldType = EjfpFieldVariantTypeNull;
+	}
+
+	const EjfpFieldVariant &raw() const
+	{
+		return fieldVariant;
+	}
+
+private:
+	/// @brief 0 length means a NULL-terminated string, see `EjfpFieldVariant`
+	void setKey(std::string_view aKey)
+	{
+		fieldVariant.fieldName = aKey.empty() ? "" : aKey.data();
+		fieldVariant.fieldNameLength = aKey.size();
+	}
+
+	template <class R, class T>
+	static constexpr bool fitsInto(T aValue)
+	{
+		if constexpr (std::is_signed_v<T>) {
+			return static_cast<std::intmax_t>(aValue) >= static_cast<std::intmax_t>(std::numeric_limits<R>::min())
+				&& static_cast<std::intmax_t>(aValue) <= static_cast<std::intmax_t>(std::numeric_limits<R>::max());
+		} else {
+			return static_cast<std::uintmax_t>(aValue) <= static_cast<std::uintmax_t>(std::numeric_limits<R>::max());
+		}
+	}
+
+	EjfpFieldVariant fieldVariant;
+};
+
+/// @brief Serializes key/value pairs, e.g. `serialize(out, {{"id", 1}, {"name", "x"}})`
+///
+/// @return Output size, NULL character excluded, if succeeded. Error code otherwise
+template <std::size_t N>
+inline int serialize(char (&aOut)[N], std::initializer_list<KeyValue> aKeyValues);
+
+/// @overload
+inline int serialize(char *aOut, std::size_t aOutSize, std::initializer_list<KeyValue> aKeyValues)
+{
+	static_assert(sizeof(KeyValue) == sizeof(EjfpFieldVariant), "`KeyValue` must be layout-compatible");
+	Ejfp ejfp{};
+	EjfpSink sink{};
+	int result = 0;
+
+	if (aOutSize == 0) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	ejfpInitialize(&ejfp);
+	ejfpSinkInitialize(&sink, aOut, aOutSize - 1, nullptr, nullptr);  // Reserve the NULL character
+
+	// `KeyValue` is a wrapper over `EjfpFieldVariant`, so the list is serialized in place
+	result = ejfpSerializeToSink(&ejfp, aKeyValues.size() > 0 ? &aKeyValues.begin()->raw() : nullptr,
+		aKeyValues.size(), &sink);
+
+	if (result >= 0) {
+		aOut[result] = '\0';
+	}
+
+	return result;
+}
+
+template <std::size_t N>
+inline int serialize(char (&aOut)[N], std::initializer_list<KeyValue> aKeyValues)
+{
+	return serialize(aOut, N, aKeyValues);
+}
+
+#endif  // !EJFP_COMPACT
+
+}  // namespace ejfp
+
+#endif  // EJFP_EJFP_HPP_
@@ -15,6 +15,19 @@ typedef enum {
 	EjfpErrorDeserializationPartitioned = -3,
 	EjfpErrorDeserializationNoMemory = -4,
 	EjfpErrorDeserializationUnsupportedJsonStructure = -5,  // EJFP does not support complicated JSON structures
+	EjfpErrorSerializationLayoutMismatch = -6,  // Fields do not match the compiled serialization plan
+	EjfpErrorSerializationSink = -7,  // Sink flush callback has failed
+	EjfpErrorStreamEnd = -8,  // Byte source is exhausted, see "ejfp/coroutine.hpp"
+	EjfpErrorSystem = -9,  // System call has failed, see `errno`
+	EjfpErrorRouterNoMemory = -10,  // Route table is full
+	EjfpErrorRouterNoRoute = -11,  // Neither a route, nor a fallback handler matches the message
+	EjfpErrorQueryInvalidPath = -12,  // Not a JSON Pointer, see "ejfp/query.h"
+	EjfpErrorQueryNoMemory = -13,  // Path has more segments than provided
+	EjfpErrorQueryNotFound = -14,  // Path does not lead to a value
+	EjfpErrorFrameChecksum = -15,  // Frame is corrupted, see "ejfp/frame.h"
+	EjfpErrorSerializationUnsupportedType = -16,  // Field type has no JSON representation in this build
+	EjfpErrorSerializationNoBase = -17,  // Compact fields have no buffer to refer to, see `ejfpSetBase`
+	EjfpErrorDeserializationUnsupportedEncoding = -18,  // Parser does not handle the encoding, see `ejfpSetEncoding`
 } EjfpError;
 
 #ifdef __cplusplus
@@ -8,7 +8,9 @@
 #ifndef EJFP_FIELDVARIANT_H_
 #define EJFP_FIELDVARIANT_H_
 
+#include "ejfp/config.h"
 #include <stddef.h>
+#include <stdint.h>
 
 typedef enum {
 	EjfpFieldVariantTypeUninitialized = 0,
@@ -17,8 +19,68 @@ typedef enum {
 	EjfpFieldVariantTypeString,
 	EjfpFieldVariantTypeFloat,
 	EjfpFieldVariantTypeNull,
+	EjfpFieldVariantTypeInteger64,  ///< Integer that does not fit into `int`
+	EjfpFieldVariantTypeUnsignedInteger64,  ///< Positive integer that does not fit into `int64_t`
+	EjfpFieldVariantTypeDouble,  ///< Real that cannot be represented by `float` exactly
+	EjfpFieldVariantTypeFixed,  ///< Decimal w/ `fixedDigits` fractional digits, see `EJFP_ENABLE_FIXED`
+	EjfpFieldVariantTypeBinary,  ///< `binaryValueSize` bytes, see `EJFP_ENABLE_BINARY`
 } EjfpFieldVariantType;
 
+#if EJFP_ENABLE_FIXED
+
+/// @brief Fixed-point value scaled by 10^`fixedDigits`, e.g. 12.34 w/ 2 digits is stored as 1234
+#if EJFP_ENABLE_INT64
+typedef int64_t EjfpFixed;
+#define EJFP_FIXED_DIGITS_MAX 18
+#else
+typedef int32_t EjfpFixed;
+#define EJFP_FIXED_DIGITS_MAX 9
+#endif  // EJFP_ENABLE_INT64
+
+#endif  // EJFP_ENABLE_FIXED
+
+#if EJFP_COMPACT
+
+typedef struct {
+	uint8_t fieldType;  ///< `EjfpFieldVariantType`
+#if EJFP_ENABLE_FIXED
+	uint8_t fixedDigits;  ///< Scale of `fixedValue`. Occupies what would otherwise be padding
+#endif
+	uint16_t fieldNameOffset;
+	uint16_t fieldNameLength;
+	uint16_t stringValueLength;
+	union {
+		int integerValue;
+		int booleanValue;
+		uint16_t stringValueOffset;
+#if EJFP_ENABLE_REAL
+		float floatValue;
+		double doubleValue;
+#endif
+#if EJFP_ENABLE_INT64
+		int64_t integer64Value;
+		uint64_t unsignedInteger64Value;
+#endif
+#if EJFP_ENABLE_FIXED
+		EjfpFixed fixedValue;
+#endif
+	};
+} EjfpFieldVariant;
+
+/// @brief Max. size of a buffer the offsets may refer to
+#define EJFP_COMPACT_BASE_SIZE_MAX UINT16_MAX
+
+#define EJFP_FIELD_NAME(aBase, aFieldVariant) ((aBase) + (aFieldVariant)->fieldNameOffset)
+#define EJFP_FIELD_STRING(aBase, aFieldVariant) ((aBase) + (aFieldVariant)->stringValueOffset)
+#define EJFP_FIELD_SET_NAME(aBase, aFieldVariant, aName, aNameLength) \
+	((aFieldVariant)->fieldNameOffset = (uint16_t)((aName) - (aBase)), \
+	(aFieldVariant)->fieldNameLength = (uint16_t)(aNameLength))
+#define EJFP_FIELD_SET_STRING(aBase, aFieldVariant, aString, aStringLength) \
+	((aFieldVariant)->stringValueOffset = (uint16_t)((aString) - (aBase)), \
+	(aFieldVariant)->stringValueLength = (uint16_t)(aStringLength))
+
+#else
+
 typedef struct {
 	EjfpFieldVariantType fieldType;
 	const char *fieldName;
@@ -26,7 +88,20 @@ typedef struct {
 		int integerValue;
 		int booleanValue;
 		const char *stringValue;
+#if EJFP_ENABLE_REAL
 		float floatValue;
+		double doubleValue;
+#endif
+#if EJFP_ENABLE_INT64
+		int64_t integer64Value;
+		uint64_t unsignedInteger64Value;
+#endif
+#if EJFP_ENABLE_FIXED
+		EjfpFixed fixedValue;
+#endif
+#if EJFP_ENABLE_BINARY
+		const uint8_t *binaryValue;
+#endif
 	};
 
 	/// @brief Required for deserialization, when the string is not
@@ -36,12 +111,42 @@ typedef struct {
 	/// value MUST be equal to the actual string length.
 	size_t fieldNameLength;
 
-	/// @brief Required for deserialization, when the string is not
-	/// null-terminated.
-	///
-	/// @pre If 0, `stringValue` is a NULL-terminated string. Otherwise, this
-	/// value MUST be equal to the actual string length
-	size_t stringValueLength;
+	union {
+		/// @brief Required for deserialization, when the string is not
+		/// null-terminated.
+		///
+		/// @pre If 0, `stringValue` is a NULL-terminated string. Otherwise, this
+		/// value MUST be equal to the actual string length
+		size_t stringValueLength;
+#if EJFP_ENABLE_BINARY
+		size_t binaryValueSize;  ///< Size of `binaryValue` in bytes
+#endif
+	};
+
+#if EJFP_ENABLE_FIXED
+	/// @brief Scale of `fixedValue`. Is last, so positional initializers
+	/// keep working
+	uint8_t fixedDigits;
+#endif
 } EjfpFieldVariant;
 
+#define EJFP_FIELD_NAME(aBase, aFieldVariant) ((aFieldVariant)->fieldName)
+#define EJFP_FIELD_STRING(aBase, aFieldVariant) ((aFieldVariant)->stringValue)
+#define EJFP_FIELD_SET_NAME(aBase, aFieldVariant, aName, aNameLength) \
+	((aFieldVariant)->fieldName = (aName), (aFieldVariant)->fieldNameLength = (aNameLength))
+#define EJFP_FIELD_SET_STRING(aBase, aFieldVariant, aString, aStringLength) \
+	((aFieldVariant)->stringValue = (aString), (aFieldVariant)->stringValueLength = (aStringLength))
+
+#endif  // EJFP_COMPACT
+
+/// @brief Whether the type is supported by this build, see "ejfp/config.h"
+#define EJFP_FIELD_TYPE_IS_ENABLED(aFieldType) \
+	((aFieldType) != EjfpFieldVariantTypeUninitialized && (aFieldType) <= EjfpFieldVariantTypeBinary \
+	&& (EJFP_ENABLE_REAL || ((aFieldType) != EjfpFieldVariantTypeFloat \
+		&& (aFieldType) != EjfpFieldVariantTypeDouble)) \
+	&& (EJFP_ENABLE_INT64 || ((aFieldType) != EjfpFieldVariantTypeInteger64 \
+		&& (aFieldType) != EjfpFieldVariantTypeUnsignedInteger64)) \
+	&& (EJFP_ENABLE_FIXED || (aFieldType) != EjfpFieldVariantTypeFixed) \
+	&& (EJFP_ENABLE_BINARY || (aFieldType) != EjfpFieldVariantTypeBinary))
+
 #endif  // EJFP_FIELDVARIANT_H_
@@ -0,0 +1,316 @@
+//
+// format.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/format.h"
+#include "ejfp/fieldVariant.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char kDigitPairs[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+#if EJFP_ENABLE_REAL
+
+/// @brief Shortest "%.*g" representation that reads back as the same value,
+/// see `mtojson_dtoa`
+static size_t formatReal(char *aOut, double aValue, int aIsFloat, int aPrecisionMin, int aPrecisionMax);
+
+static size_t formatReal(char *aOut, double aValue, int aIsFloat, int aPrecisionMin, int aPrecisionMax)
+{
+	int length = 0;
+
+	if (aValue != aValue || aValue - aValue != 0.0) {  // NaN, +-inf
+		memcpy(aOut, "null", 4);
+
+		return 4;
+	}
+
+	for (int precision = aPrecisionMin; precision <= aPrecisionMax; ++precision) {
+		length = snprintf(aOut, EJFP_FORMAT_SCALAR_MAX_LENGTH, "%.*g", precision, aValue);
+		double readBack = strtod(aOut, NULL);
+
+		if (aIsFloat ? (float)readBack == (float)aValue : readBack == aValue) {
+			break;
+		}
+	}
+
+	if (strpbrk(aOut, ".eE") == NULL) {
+		aOut[length++] = '.';
+		aOut[length++] = '0';
+	}
+
+	return length;
+}
+
+#endif  // EJFP_ENABLE_REAL
+
+size_t ejfpFormatUnsigned(char *aOut, uint64_t aValue)
+{
+	char reversed[20];
+	char *it = reversed + sizeof(reversed);
+	size_t length = 0;
+
+	while (aValue >= 100) {
+		const unsigned pair = (unsigned)(aValue % 100) * 2;
+		aValue /= 100;
+		*--it = kDigitPairs[pair + 1];
+		*--it = kDigitPairs[pair];
+	}
+
+	if (aValue >= 10) {
+		*--it = kDigitPairs[aValue * 2 + 1];
+		*--it = kDigitPairs[aValue * 2];
+	} else {
+		*--it = (char)('0' + aValue);
+	}
+
+	length = reversed + sizeof(reversed) - it;
+	memcpy(aOut, it, length);
+
+	return length;
+}
+
+/// @brief Formats a signed decimal
+static size_t formatSigned(char *aOut, int64_t aValue)
+{
+	if (aValue < 0) {
+		*aOut = '-';
+
+		return 1 + ejfpFormatUnsigned(aOut + 1, 0 - (uint64_t)aValue);
+	}
+
+	return ejfpFormatUnsigned(aOut, (uint64_t)aValue);
+}
+
+#if EJFP_ENABLE_FIXED
+
+/// @brief Formats a fixed-point decimal w/ exactly `aDigits` fractional digits
+static size_t formatFixed(char *aOut, EjfpFixed aValue, unsigned aDigits)
+{
+	char digits[20];
+	char *out = aOut;
+
+	if (aValue < 0) {
+		*out++ = '-';
+	}
+
+	const size_t kLength = ejfpFormatUnsigned(digits, aValue < 0 ? 0 - (uint64_t)aValue : (uint64_t)aValue);
+
+	if (aDigits == 0) {
+		memcpy(out, digits, kLength);
+
+		return out + kLength - aOut;
+	}
+
+	if (kLength > aDigits) {
+		memcpy(out, digits, kLength - aDigits);
+		out += kLength - aDigits;
+		*out++ = '.';
+		memcpy(out, digits + kLength - aDigits, aDigits);
+		out += aDigits;
+	} else {
+		*out++ = '0';
+		*out++ = '.';
+		memset(out, '0', aDigits - kLength);
+		out += aDigits - kLength;
+		memcpy(out, digits, kLength);
+		out += kLength;
+	}
+
+	return out - aOut;
+}
+
+#endif  // EJFP_ENABLE_FIXED
+
+size_t ejfpFormatScalar(char *aOut, const EjfpFieldVariant *aFieldVariant)
+{
+	switch (aFieldVariant->fieldType) {
+		case EjfpFieldVariantTypeInteger:
+			return formatSigned(aOut, aFieldVariant->integerValue);
+
+#if EJFP_ENABLE_INT64
+		case EjfpFieldVariantTypeInteger64:
+			return formatSigned(aOut, aFieldVariant->integer64Value);
+
+		case EjfpFieldVariantTypeUnsignedInteger64:
+			return ejfpFormatUnsigned(aOut, aFieldVariant->unsignedInteger64Value);
+#endif  // EJFP_ENABLE_INT64
+
+		case EjfpFieldVariantTypeBoolean:
+			if (aFieldVariant->booleanValue != 0) {
+				memcpy(aOut, "true", 4);
+
+				return 4;
+			}
+
+			memcpy(aOut, "false", 5);
+
+			return 5;
+
+		case EjfpFieldVariantTypeNull:
+			memcpy(aOut, "null", 4);
+
+			return 4;
+
+#if EJFP_ENABLE_REAL
+		case EjfpFieldVariantTypeFloat:
+			return formatReal(aOut, aFieldVariant->floatValue, 1, 6, 9);
+
+		case EjfpFieldVariantTypeDouble:
+			return formatReal(aOut, aFieldVariant->doubleValue, 0, 15, 17);
+#endif  // EJFP_ENABLE_REAL
+
+#if EJFP_ENABLE_FIXED
+		case EjfpFieldVariantTypeFixed:
+			// Larger scales would not fit into `EJFP_FORMAT_SCALAR_MAX_LENGTH`
+			if (aFieldVariant->fixedDigits > EJFP_FIXED_DIGITS_MAX) {
+				return 0;
+			}
+
+			return formatFixed(aOut, aFieldVariant->fixedValue, aFieldVariant->fixedDigits);
+#endif  // EJFP_ENABLE_FIXED
+
+		default:
+			return 0;
+	}
+}
+
+size_t ejfpFormatScalarMaxLength(EjfpFieldVariantType aFieldVariantType)
+{
+	switch (aFieldVariantType) {
+		case EjfpFieldVariantTypeInteger:
+			return sizeof("-2147483648") - 1;
+
+#if EJFP_ENABLE_INT64
+		case EjfpFieldVariantTypeInteger64:
+			return sizeof("-9223372036854775808") - 1;
+
+		case EjfpFieldVariantTypeUnsignedInteger64:
+			return sizeof("18446744073709551615") - 1;
+#endif  // EJFP_ENABLE_INT64
+
+		case EjfpFieldVariantTypeBoolean:
+			return sizeof("false") - 1;
+
+		case EjfpFieldVariantTypeNull:
+			return sizeof("null") - 1;
+
+#if EJFP_ENABLE_REAL
+		case EjfpFieldVariantTypeFloat:
+			return sizeof("-1.17549435e-38") - 1;
+
+		case EjfpFieldVariantTypeDouble:
+			return sizeof("-2.2250738585072014e-308") - 1;
+#endif  // EJFP_ENABLE_REAL
+
+#if EJFP_ENABLE_FIXED
+		case EjfpFieldVariantTypeFixed:
+#if EJFP_ENABLE_INT64
+			return sizeof("-0.000000000000000001") - 1;
+#else
+			return sizeof("-0.000000001") - 1;
+#endif  // EJFP_ENABLE_INT64
+#endif  // EJFP_ENABLE_FIXED
+
+		default:
+			return 0;
+	}
+}
+
+char *ejfpFormatString(char *aOut, const char *aOutEnd, const char *aString, size_t aStringLength)
+{
+	const char *end = aString + aStringLength;
+
+	if (aOutEnd - aOut < 2) {
+		return NULL;
+	}
+
+	*aOut++ = '"';
+
+	while (aString != end) {
+		const char *chunkEnd = aString;
+
+		// Copy runs of bytes which do not require escaping at once
+		while (chunkEnd != end && *chunkEnd != '"' && *chunkEnd != '\\') {
+			++chunkEnd;
+		}
+
+		if ((size_t)(aOutEnd - aOut) < (size_t)(chunkEnd - aString) + 1) {
+			return NULL;
+		}
+
+		memcpy(aOut, aString, chunkEnd - aString);
+		aOut += chunkEnd - aString;
+		aString = chunkEnd;
+
+		if (aString != end) {
+			if (aOutEnd - aOut < 3) {
+				return NULL;
+			}
+
+			*aOut++ = '\\';
+			*aOut++ = *aString++;
+		}
+	}
+
+	*aOut++ = '"';
+
+	return aOut;
+}
+
+size_t ejfpFormatStringLength(const char *aString, size_t aStringLength)
+{
+	size_t length = aStringLength + 2;
+
+	for (const char *it = aString; it != aString + aStringLength; ++it) {
+		if (*it == '"' || *it == '\\') {
+			++length;
+		}
+	}
+
+	return length;
+}
+
+#if EJFP_COMPACT
+
+size_t ejfpFieldVariantNameLength(const EjfpFieldVariant *aFieldVariant)
+{
+	return aFieldVariant->fieldNameLength;  // Offsets do not reference NULL-terminated strings
+}
+
+size_t ejfpFieldVariantStringLength(const EjfpFieldVariant *aFieldVariant)
+{
+	return aFieldVariant->stringValueLength;
+}
+
+#else
+
+size_t ejfpFieldVariantNameLength(const EjfpFieldVariant *aFieldVariant)
+{
+	return aFieldVariant->fieldNameLength != 0 ? aFieldVariant->fieldNameLength : strlen(aFieldVariant->fieldName);
+}
+
+size_t ejfpFieldVariantStringLength(const EjfpFieldVariant *aFieldVariant)
+{
+	if (aFieldVariant->stringValueLength != 0 || aFieldVariant->stringValue == NULL) {
+		return aFieldVariant->stringValueLength;
+	}
+
+	return strlen(aFieldVariant->stringValue);
+}
+
+#endif  // EJFP_COMPACT
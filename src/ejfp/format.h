@@ -0,0 +1,57 @@
+//
+// format.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Value formatting primitives shared by serialization backends which do not
+// go through "mtojson". The output is byte-compatible with `ejfpSerialize`.
+//
+
+#ifndef EJFP_FORMAT_H_
+#define EJFP_FORMAT_H_
+
+#include "ejfp/fieldVariant.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief Upper bound of a formatted scalar (non-string) value length
+#define EJFP_FORMAT_SCALAR_MAX_LENGTH 32
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @brief Formats a scalar (number, boolean, null) value
+///
+/// @param aOut Must have at least `EJFP_FORMAT_SCALAR_MAX_LENGTH` bytes
+/// @return Number of bytes written. 0, if the type is not a scalar one
+size_t ejfpFormatScalar(char *aOut, const EjfpFieldVariant *aFieldVariant);
+
+/// @brief Max. length of a scalar value of the given type. 0 for non-scalar types
+size_t ejfpFormatScalarMaxLength(EjfpFieldVariantType aFieldVariantType);
+
+/// @brief Formats an unsigned decimal using a two-digit table
+/// @return Number of bytes written
+size_t ejfpFormatUnsigned(char *aOut, uint64_t aValue);
+
+/// @brief Escapes and quotes a string the same way "mtojson" does
+///
+/// @return Pointer past the last written byte, or NULL, if the output does
+/// not fit into [aOut; aOutEnd)
+char *ejfpFormatString(char *aOut, const char *aOutEnd, const char *aString, size_t aStringLength);
+
+/// @brief Length of the escaped and quoted string
+size_t ejfpFormatStringLength(const char *aString, size_t aStringLength);
+
+/// @brief Resolves the "0 means NULL-terminated" convention for field names
+size_t ejfpFieldVariantNameLength(const EjfpFieldVariant *aFieldVariant);
+
+/// @brief Resolves the "0 means NULL-terminated" convention for string values
+size_t ejfpFieldVariantStringLength(const EjfpFieldVariant *aFieldVariant);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // EJFP_FORMAT_H_
@@ -0,0 +1,117 @@
+//
+// frame.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/cbor.h"
+#include "ejfp/deserialization.h"
+#include "ejfp/error.h"
+#include "ejfp/frame.h"
+#include "ejfp/sink.h"
+
+static size_t crcSize(const EjfpFrameFormat *aFormat);
+
+static void littleEndianWrite(char *aOut, uint32_t aValue, size_t aSize);
+
+static uint32_t littleEndianRead(const char *aInput, size_t aSize);
+
+static inline size_t crcSize(const EjfpFrameFormat *aFormat)
+{
+	return aFormat->crc == NULL ? 0 : aFormat->crc->parameters.width / 8;
+}
+
+static void littleEndianWrite(char *aOut, uint32_t aValue, size_t aSize)
+{
+	for (size_t i = 0; i < aSize; ++i, aValue >>= 8) {
+		aOut[i] = (char)(aValue & 0xff);
+	}
+}
+
+static uint32_t littleEndianRead(const char *aInput, size_t aSize)
+{
+	uint32_t result = 0;
+
+	for (size_t i = aSize; i > 0; --i) {
+		result = (result << 8) | (uint8_t)aInput[i - 1];
+	}
+
+	return result;
+}
+
+size_t ejfpFrameOverhead(const EjfpFrameFormat *aFormat)
+{
+	return aFormat->lengthSize + crcSize(aFormat);
+}
+
+int ejfpSerializeFramed(Ejfp *aEjfp, const EjfpFrameFormat *aFormat, const EjfpFieldVariant *aFieldVariants,
+	size_t aFieldVariantsSize, char *aOut, size_t aOutSize)
+{
+	const size_t kOverhead = ejfpFrameOverhead(aFormat);
+	const size_t kLengthMax = aFormat->lengthSize == 0 || aFormat->lengthSize >= 4 ? UINT32_MAX :
+		((size_t)1 << (8 * aFormat->lengthSize)) - 1;
+	char *object = aOut + aFormat->lengthSize;
+	int objectSize = 0;
+	uint32_t crc = 0;
+
+	if (aOutSize < kOverhead) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	const size_t kObjectSizeMax = aOutSize - kOverhead < kLengthMax ? aOutSize - kOverhead : kLengthMax;
+
+	EjfpSink sink;
+	ejfpSinkInitialize(&sink, object, kObjectSizeMax, NULL, NULL);
+	ejfpSinkSetCrc(&sink, aFormat->crc);
+#if !EJFP_COMPACT
+	objectSize = aEjfp != NULL && aEjfp->encoding == EjfpEncodingCbor ?
+		ejfpCborSerializeToSink(aFieldVariants, aFieldVariantsSize, &sink) :
+		ejfpSerializeToSink(aEjfp, aFieldVariants, aFieldVariantsSize, &sink);
+#else
+	objectSize = ejfpSerializeToSink(aEjfp, aFieldVariants, aFieldVariantsSize, &sink);
+#endif  // !EJFP_COMPACT
+
+	if (objectSize < 0) {
+		return objectSize;
+	}
+
+	if (aFormat->crc != NULL) {
+		crc = ejfpSinkCrc(&sink);
+	}
+
+	littleEndianWrite(aOut, (uint32_t)objectSize, aFormat->lengthSize);
+	littleEndianWrite(object + objectSize, crc, crcSize(aFormat));
+
+	return (int)kOverhead + objectSize;
+}
+
+int ejfpDeserializeFramed(Ejfp *aEjfp, const EjfpFrameFormat *aFormat, EjfpFieldVariant *aFieldVariants,
+	size_t aFieldVariantsSize, const char *aInput, size_t aInputSize, size_t *aFrameSize)
+{
+	const size_t kOverhead = ejfpFrameOverhead(aFormat);
+	const char *object = aInput + aFormat->lengthSize;
+	size_t objectSize = 0;
+
+	if (aInputSize < kOverhead) {
+		return EjfpErrorDeserializationPartitioned;
+	}
+
+	objectSize = aFormat->lengthSize == 0 ? aInputSize - kOverhead : littleEndianRead(aInput, aFormat->lengthSize);
+
+	if (objectSize > aInputSize - kOverhead) {
+		return EjfpErrorDeserializationPartitioned;
+	}
+
+	if (aFrameSize != NULL) {
+		*aFrameSize = kOverhead + objectSize;
+	}
+
+	// The object is only tokenized once it is known to be intact
+	if (aFormat->crc != NULL && ejfpCrcCompute(aFormat->crc, object, objectSize)
+		!= littleEndianRead(object + objectSize, crcSize(aFormat))) {
+		return EjfpErrorFrameChecksum;
+	}
+
+	return ejfpDeserialize(aEjfp, aFieldVariants, aFieldVariantsSize, object, objectSize);
+}
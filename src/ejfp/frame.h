@@ -0,0 +1,67 @@
+//
+// frame.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Framing for byte links, e.g. UART: a length prefix, the serialized object,
+// and a checksum. The checksum is updated while the object is serialized, a
+// batch of up to 256 bytes at a time, so the output is read back only while it
+// is still in cache, see `ejfpSinkSetCrc`. Both encodings are checksummed so.
+//
+// Layout: | length, `lengthSize` bytes | object | CRC, `width / 8` bytes |.
+// Both numbers are little-endian. The length is that of the object, the CRC
+// covers the object.
+//
+
+#ifndef EJFP_FRAME_H_
+#define EJFP_FRAME_H_
+
+#include "ejfp/crc.h"
+#include "ejfp/ejfp.h"
+#include "ejfp/fieldVariant.h"
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+	/// @brief NULL, if frames have no checksum. The width must be a multiple of 8
+	const EjfpCrc *crc;
+
+	/// @brief 0 (no prefix), 1, 2, or 4
+	uint8_t lengthSize;
+} EjfpFrameFormat;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @return Size of the prefix and the checksum
+size_t ejfpFrameOverhead(const EjfpFrameFormat *aFormat);
+
+/// @brief Serializes fields into a frame. The object is the same as that of
+/// `ejfpSerialize`, or `ejfpCborSerialize`, and is not NULL-terminated. Both
+/// encodings write through a sink, which updates the checksum
+///
+/// @return Frame size, if succeeded. `EjfpErrorSerializationNoMemory`, if
+/// the frame does not fit into the buffer, or its length into the prefix.
+/// Error code otherwise
+int ejfpSerializeFramed(Ejfp *aEjfp, const EjfpFrameFormat *aFormat, const EjfpFieldVariant *aFieldVariants,
+	size_t aFieldVariantsSize, char *aOut, size_t aOutSize);
+
+/// @brief Checks the length and the checksum of a frame, and deserializes
+/// the object. Bytes past the frame are ignored. W/o a length prefix, the
+/// input is taken for a single frame
+///
+/// @param aFrameSize If not NULL, receives the frame size, if the frame is
+/// complete, e.g. to skip a corrupted one
+/// @return Number of fields, if succeeded. `EjfpErrorDeserializationPartitioned`,
+/// if the frame is incomplete. `EjfpErrorFrameChecksum`, if the checksum does
+/// not match. Error code otherwise
+int ejfpDeserializeFramed(Ejfp *aEjfp, const EjfpFrameFormat *aFormat, EjfpFieldVariant *aFieldVariants,
+	size_t aFieldVariantsSize, const char *aInput, size_t aInputSize, size_t *aFrameSize);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // EJFP_FRAME_H_
@@ -0,0 +1,196 @@
+//
+// iovec.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/iovec.h"
+
+#if (defined(__unix__) || defined(__APPLE__)) && !EJFP_COMPACT
+
+#include "ejfp/base64.h"
+#include "ejfp/error.h"
+#include "ejfp/fieldVariant.h"
+#include "ejfp/format.h"
+#include <string.h>
+
+typedef struct {
+	struct iovec *iovec;
+	size_t iovecSize;
+	size_t iovecUsed;
+	char *scratch;
+	const char *scratchEnd;
+
+	/// @brief Beginning of the scratch bytes which have not been added to the list yet
+	char *pending;
+} IovecWriter;
+
+/// @brief Turns pending scratch bytes into an entry
+static int iovecWriterCommit(IovecWriter *aWriter);
+
+/// @brief Adds a reference to external bytes
+static int iovecWriterReference(IovecWriter *aWriter, const char *aData, size_t aDataSize);
+
+static int iovecWriterCopy(IovecWriter *aWriter, const char *aData, size_t aDataSize);
+
+static int iovecWriterCopyString(IovecWriter *aWriter, const char *aString, size_t aStringLength);
+
+#if EJFP_ENABLE_BINARY
+static int iovecWriterCopyBase64(IovecWriter *aWriter, const uint8_t *aData, size_t aDataSize);
+#endif
+
+static int iovecWriterCommit(IovecWriter *aWriter)
+{
+	if (aWriter->scratch == aWriter->pending) {
+		return EjfpOk;
+	}
+
+	if (aWriter->iovecUsed == aWriter->iovecSize) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	aWriter->iovec[aWriter->iovecUsed].iov_base = aWriter->pending;
+	aWriter->iovec[aWriter->iovecUsed].iov_len = aWriter->scratch - aWriter->pending;
+	++aWriter->iovecUsed;
+	aWriter->pending = aWriter->scratch;
+
+	return EjfpOk;
+}
+
+static int iovecWriterReference(IovecWriter *aWriter, const char *aData, size_t aDataSize)
+{
+	int error = iovecWriterCommit(aWriter);
+
+	if (EjfpOk != error) {
+		return error;
+	}
+
+	if (aWriter->iovecUsed == aWriter->iovecSize) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	aWriter->iovec[aWriter->iovecUsed].iov_base = (void *)aData;
+	aWriter->iovec[aWriter->iovecUsed].iov_len = aDataSize;
+	++aWriter->iovecUsed;
+
+	return EjfpOk;
+}
+
+static int iovecWriterCopy(IovecWriter *aWriter, const char *aData, size_t aDataSize)
+{
+	if ((size_t)(aWriter->scratchEnd - aWriter->scratch) < aDataSize) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	memcpy(aWriter->scratch, aData, aDataSize);
+	aWriter->scratch += aDataSize;
+
+	return EjfpOk;
+}
+
+/// @brief Copies escaped and quoted string into the scratch buffer
+static int iovecWriterCopyString(IovecWriter *aWriter, const char *aString, size_t aStringLength)
+{
+	char *out = ejfpFormatString(aWriter->scratch, aWriter->scratchEnd, aString, aStringLength);
+
+	if (out == NULL) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	aWriter->scratch = out;
+
+	return EjfpOk;
+}
+
+#if EJFP_ENABLE_BINARY
+/// @brief Copies a base64-encoded and quoted blob into the scratch buffer
+static int iovecWriterCopyBase64(IovecWriter *aWriter, const uint8_t *aData, size_t aDataSize)
+{
+	if ((size_t)(aWriter->scratchEnd - aWriter->scratch) < 2 + EJFP_BASE64_ENCODED_SIZE(aDataSize)) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	*aWriter->scratch++ = '"';
+	aWriter->scratch += ejfpBase64Encode(aWriter->scratch, aData, aDataSize);
+	*aWriter->scratch++ = '"';
+
+	return EjfpOk;
+}
+#endif
+
+int ejfpSerializeToIovec(Ejfp *aEjfp, const EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize,
+	struct iovec *aIovec, size_t aIovecSize, char *aScratch, size_t aScratchSize)
+{
+	IovecWriter writer = {aIovec, aIovecSize, 0, aScratch, aScratch + aScratchSize, aScratch};
+	int error = iovecWriterCopy(&writer, "{", 1);
+	(void)aEjfp;
+
+	for (size_t i = 0; EjfpOk == error && i < aFieldVariantsSize; ++i) {
+		const EjfpFieldVariant *fieldVariant = &aFieldVariants[i];
+		char scalar[EJFP_FORMAT_SCALAR_MAX_LENGTH];
+		size_t scalarLength = ejfpFormatScalar(scalar, fieldVariant);
+
+		// Unsupported fields terminate the object, as they do in `ejfpSerialize`
+		if (scalarLength == 0 && fieldVariant->fieldType != EjfpFieldVariantTypeString
+				&& !(EJFP_ENABLE_BINARY && fieldVariant->fieldType == EjfpFieldVariantTypeBinary)) {
+			break;
+		}
+
+		if (i > 0) {
+			error = iovecWriterCopy(&writer, ",", 1);
+		}
+
+		if (EjfpOk == error) {
+			error = iovecWriterCopyString(&writer, fieldVariant->fieldName, ejfpFieldVariantNameLength(fieldVariant));
+		}
+
+		if (EjfpOk == error) {
+			error = iovecWriterCopy(&writer, ":", 1);
+		}
+
+		if (EjfpOk != error) {
+			break;
+		}
+
+		if (scalarLength > 0) {
+			error = iovecWriterCopy(&writer, scalar, scalarLength);
+		} else if (fieldVariant->stringValue == NULL) {
+			error = iovecWriterCopy(&writer, "null", 4);
+#if EJFP_ENABLE_BINARY
+		} else if (fieldVariant->fieldType == EjfpFieldVariantTypeBinary) {
+			error = iovecWriterCopyBase64(&writer, fieldVariant->binaryValue, fieldVariant->binaryValueSize);
+#endif
+		} else {
+			const size_t kLength = ejfpFieldVariantStringLength(fieldVariant);
+
+			if (kLength < EJFP_IOVEC_IN_PLACE_MIN_LENGTH
+					|| memchr(fieldVariant->stringValue, '"', kLength) != NULL
+					|| memchr(fieldVariant->stringValue, '\\', kLength) != NULL) {
+				error = iovecWriterCopyString(&writer, fieldVariant->stringValue, kLength);
+			} else {
+				error = iovecWriterCopy(&writer, "\"", 1);
+
+				if (EjfpOk == error) {
+					error = iovecWriterReference(&writer, fieldVariant->stringValue, kLength);
+				}
+
+				if (EjfpOk == error) {
+					error = iovecWriterCopy(&writer, "\"", 1);
+				}
+			}
+		}
+	}
+
+	if (EjfpOk == error) {
+		error = iovecWriterCopy(&writer, "}", 1);
+	}
+
+	if (EjfpOk == error) {
+		error = iovecWriterCommit(&writer);
+	}
+
+	return EjfpOk == error ? (int)writer.iovecUsed : error;
+}
+
+#endif  // (defined(__unix__) || defined(__APPLE__)) && !EJFP_COMPACT
@@ -0,0 +1,49 @@
+//
+// iovec.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Scatter-gather serialization for `writev`. Keys and punctuation go into a
+// small scratch buffer, long string values which need no escaping are
+// referenced in place.
+//
+
+#ifndef EJFP_IOVEC_H_
+#define EJFP_IOVEC_H_
+
+#if (defined(__unix__) || defined(__APPLE__)) && !EJFP_COMPACT
+
+#include "ejfp/ejfp.h"
+#include "ejfp/fieldVariant.h"
+#include <stddef.h>
+#include <sys/uio.h>
+
+/// @brief String values shorter than this are copied into the scratch
+/// buffer, as an extra `iovec` entry costs more than copying them
+#ifndef EJFP_IOVEC_IN_PLACE_MIN_LENGTH
+# define EJFP_IOVEC_IN_PLACE_MIN_LENGTH 64
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @brief Serializes fields into an `iovec` list. The concatenation of
+/// the entries is the same as the output of `ejfpSerialize`, except that it
+/// is not NULL-terminated
+///
+/// @param aScratch Storage for keys, punctuation, scalars, escaped strings,
+/// and base64-encoded blobs. The list references it, and the field values
+///
+/// @return Number of filled `iovec` entries, if succeeded. Error code otherwise
+int ejfpSerializeToIovec(Ejfp *aEjfp, const EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize,
+	struct iovec *aIovec, size_t aIovecSize, char *aScratch, size_t aScratchSize);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // (defined(__unix__) || defined(__APPLE__)) && !EJFP_COMPACT
+
+#endif  // EJFP_IOVEC_H_
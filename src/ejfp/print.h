@@ -9,9 +9,14 @@
 #define EJFP_PRINT_H_
 
 #include "ejfp/fieldVariant.h"
+#include "ejfp/format.h"
+#include "ejfp/trace.h"
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
+#if !EJFP_COMPACT  // Requires pointer-based fields, see `EJFP_COMPACT`
+
 static inline void ejfpFieldVariantPrint(EjfpFieldVariant const *aEjfpFieldVariant)
 {
 	// Print field name
@@ -36,10 +41,12 @@ static inline void ejfpFieldVariantPrint(EjfpFieldVariant const *aEjfpFieldVaria
 
 			break;
 
+#if EJFP_ENABLE_REAL
 		case EjfpFieldVariantTypeFloat:
 			printf("%.4f", aEjfpFieldVariant->floatValue);
 
 			break;
+#endif  // EJFP_ENABLE_REAL
 
 		case EjfpFieldVariantTypeNull:
 			printf("null");
@@ -51,6 +58,41 @@ static inline void ejfpFieldVariantPrint(EjfpFieldVariant const *aEjfpFieldVaria
 
 			break;
 
+#if EJFP_ENABLE_INT64
+		case EjfpFieldVariantTypeInteger64:
+			printf("%" PRId64, aEjfpFieldVariant->integer64Value);
+
+			break;
+
+		case EjfpFieldVariantTypeUnsignedInteger64:
+			printf("%" PRIu64, aEjfpFieldVariant->unsignedInteger64Value);
+
+			break;
+#endif  // EJFP_ENABLE_INT64
+
+#if EJFP_ENABLE_REAL
+		case EjfpFieldVariantTypeDouble:
+			printf("%.17g", aEjfpFieldVariant->doubleValue);
+
+			break;
+#endif  // EJFP_ENABLE_REAL
+
+#if EJFP_ENABLE_FIXED
+		case EjfpFieldVariantTypeFixed: {
+			char formatted[EJFP_FORMAT_SCALAR_MAX_LENGTH];
+			printf("%.*s", (int)ejfpFormatScalar(formatted, aEjfpFieldVariant), formatted);
+
+			break;
+		}
+#endif  // EJFP_ENABLE_FIXED
+
+#if EJFP_ENABLE_BINARY
+		case EjfpFieldVariantTypeBinary:
+			printf("<%zu bytes>", aEjfpFieldVariant->binaryValueSize);
+
+			break;
+#endif  // EJFP_ENABLE_BINARY
+
 		case EjfpFieldVariantTypeBoolean:
 			if (aEjfpFieldVariant->booleanValue) {
 				printf("true");
@@ -77,12 +119,12 @@ static inline std::ostream &operator<<(std::ostream &aOut, const EjfpFieldVarian
 		aOut << aEjfpFieldVariant.fieldName[i];
 	}
 
-	printf("\":");
+	aOut << "\":";
 
 	// Print field value
 	switch (aEjfpFieldVariant.fieldType) {
 		case EjfpFieldVariantTypeString:
-			printf("\"");
+			aOut << "\"";
 
 			for (size_t i = 0; i < aEjfpFieldVariant.stringValueLength; ++i) {
 				aOut << aEjfpFieldVariant.stringValue[i];
@@ -92,10 +134,12 @@ static inline std::ostream &operator<<(std::ostream &aOut, const EjfpFieldVarian
 
 			break;
 
+#if EJFP_ENABLE_REAL
 		case EjfpFieldVariantTypeFloat:
 			aOut << aEjfpFieldVariant.floatValue;
 
 			break;
+#endif  // EJFP_ENABLE_REAL
 
 		case EjfpFieldVariantTypeNull:
 			aOut << "null";
@@ -107,6 +151,41 @@ static inline std::ostream &operator<<(std::ostream &aOut, const EjfpFieldVarian
 
 			break;
 
+#if EJFP_ENABLE_INT64
+		case EjfpFieldVariantTypeInteger64:
+			aOut << aEjfpFieldVariant.integer64Value;
+
+			break;
+
+		case EjfpFieldVariantTypeUnsignedInteger64:
+			aOut << aEjfpFieldVariant.unsignedInteger64Value;
+
+			break;
+#endif  // EJFP_ENABLE_INT64
+
+#if EJFP_ENABLE_REAL
+		case EjfpFieldVariantTypeDouble:
+			aOut << aEjfpFieldVariant.doubleValue;
+
+			break;
+#endif  // EJFP_ENABLE_REAL
+
+#if EJFP_ENABLE_FIXED
+		case EjfpFieldVariantTypeFixed: {
+			char formatted[EJFP_FORMAT_SCALAR_MAX_LENGTH];
+			aOut.write(formatted, ejfpFormatScalar(formatted, &aEjfpFieldVariant));
+
+			break;
+		}
+#endif  // EJFP_ENABLE_FIXED
+
+#if EJFP_ENABLE_BINARY
+		case EjfpFieldVariantTypeBinary:
+			aOut << "<" << aEjfpFieldVariant.binaryValueSize << " bytes>";
+
+			break;
+#endif  // EJFP_ENABLE_BINARY
+
 		case EjfpFieldVariantTypeBoolean:
 			if (aEjfpFieldVariant.booleanValue) {
 				aOut << "true";
@@ -124,4 +203,35 @@ static inline std::ostream &operator<<(std::ostream &aOut, const EjfpFieldVarian
 
 #endif  // __cplusplus
 
+#endif  // !EJFP_COMPACT
+
+#if EJFP_TRACE
+
+/// @brief Dumps the histograms of a trace: percentiles and the max. number
+/// of ticks of each phase by message size
+static inline void ejfpTracePrint(const EjfpTrace *aTrace)
+{
+	printf("%-12s %8s %10s %10s %10s %10s %10s\n", "phase", "size", "count", "p50", "p99", "p99.9", "max");
+
+	for (int phase = 0; phase < EjfpTracePhaseN; ++phase) {
+		const EjfpTraceHistogram *histogram = aTrace->histograms[phase];
+
+		for (size_t sizeClass = 0; histogram != NULL && sizeClass < EJFP_TRACE_SIZE_CLASSES; ++sizeClass) {
+			const uint32_t kCount = ejfpTraceHistogramCount(histogram, sizeClass);
+
+			if (kCount == 0) {
+				continue;
+			}
+
+			printf("%-12s %7zu+ %10" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu32 "\n",
+				ejfpTracePhaseName((EjfpTracePhase)phase), ejfpTraceSizeClassMin(sizeClass), kCount,
+				ejfpTraceHistogramPercentile(histogram, sizeClass, 500),
+				ejfpTraceHistogramPercentile(histogram, sizeClass, 990),
+				ejfpTraceHistogramPercentile(histogram, sizeClass, 999), histogram->max[sizeClass]);
+		}
+	}
+}
+
+#endif  // EJFP_TRACE
+
 #endif  // EJFP_PRINT_H_
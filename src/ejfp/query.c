@@ -0,0 +1,477 @@
+//
+// query.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/deserialization.h"
+#include "ejfp/error.h"
+#include "ejfp/query.h"
+#include <limits.h>
+#include <string.h>
+
+#if !EJFP_COMPACT  // Requires pointer-based fields, see `EJFP_COMPACT`
+
+/// @brief What the tokenizer expects next
+typedef enum {
+	IndexerStateValue = 0,
+	IndexerStateValueOrClose,  ///< First item of an array
+	IndexerStateKey,
+	IndexerStateKeyOrClose,  ///< First key of an object
+	IndexerStateColon,
+	IndexerStateCommaOrClose,
+	IndexerStateDone,  ///< The root value is complete
+} IndexerState;
+
+typedef struct {
+	const char *input;
+	jsmntok_t *tokens;
+	int tokensSize;
+	int nTokens;
+
+	/// @brief Innermost open object or array, -1 at the root. While a container
+	/// is open, its `end` holds the enclosing one, and its `size` the key it is
+	/// the value of, so no stack is required
+	int open;
+
+	/// @brief Key whose value is being scanned, or -1
+	int key;
+	IndexerState state;
+} Indexer;
+
+/// @return Array index encoded by a segment, or `SIZE_MAX`, if it is not
+/// one. RFC 6901 forbids leading zeros
+static size_t segmentIndex(const char *aName, size_t aNameLength);
+
+/// @brief Compares an object key w/ a segment, decoding "~0" and "~1" in the latter
+static int segmentMatches(const EjfpPathSegment *aSegment, const char *aKey, size_t aKeyLength);
+
+static jsmntok_t *indexerTokenAdd(Indexer *aIndexer, jsmntype_t aType, size_t aStart);
+
+/// @brief Records the subtree of the key of a complete value, if there is one
+static void indexerValueComplete(Indexer *aIndexer);
+
+/// @return Position past the closing quote. `aIt` is expected to point past
+/// the opening one
+static const char *stringSkip(const char *aIt, const char *aEnd, EjfpError *aError);
+
+/// @return Position of the delimiter which ends a primitive
+static const char *primitiveSkip(const char *aIt, const char *aEnd);
+
+/// @brief Tokenizes the input in a single pass. Subtree sizes are recorded
+/// as soon as objects, arrays, and keys are complete
+static EjfpError indexerRun(Indexer *aIndexer, size_t aInputSize);
+
+static size_t segmentIndex(const char *aName, size_t aNameLength)
+{
+	size_t result = 0;
+
+	if (aNameLength == 0 || (aNameLength > 1 && aName[0] == '0')) {
+		return SIZE_MAX;
+	}
+
+	for (size_t i = 0; i < aNameLength; ++i) {
+		const unsigned kDigit = (unsigned)(aName[i] - '0');
+
+		if (kDigit > 9 || result > (SIZE_MAX - 1 - kDigit) / 10) {
+			return SIZE_MAX;
+		}
+
+		result = result * 10 + kDigit;
+	}
+
+	return result;
+}
+
+static int segmentMatches(const EjfpPathSegment *aSegment, const char *aKey, size_t aKeyLength)
+{
+	if (!aSegment->isEscaped) {
+		return aSegment->nameLength == aKeyLength && memcmp(aSegment->name, aKey, aKeyLength) == 0;
+	}
+
+	size_t iKey = 0;
+
+	for (size_t i = 0; i < aSegment->nameLength; ++i, ++iKey) {
+		char ch = aSegment->name[i];
+
+		if (ch == '~') {
+			ch = aSegment->name[++i] == '0' ? '~' : '/';
+		}
+
+		if (iKey == aKeyLength || aKey[iKey] != ch) {
+			return 0;
+		}
+	}
+
+	return iKey == aKeyLength;
+}
+
+static jsmntok_t *indexerTokenAdd(Indexer *aIndexer, jsmntype_t aType, size_t aStart)
+{
+	if (aIndexer->nTokens == aIndexer->tokensSize) {
+		return NULL;
+	}
+
+	jsmntok_t *token = &aIndexer->tokens[aIndexer->nTokens++];
+	token->type = aType;
+	token->start = (jsmnint_t)aStart;
+	token->end = -1;
+	token->size = 1;
+
+	return token;
+}
+
+static void indexerValueComplete(Indexer *aIndexer)
+{
+	if (aIndexer->key >= 0) {
+		aIndexer->tokens[aIndexer->key].size = aIndexer->nTokens - aIndexer->key;
+		aIndexer->key = -1;
+	}
+
+	aIndexer->state = aIndexer->open < 0 ? IndexerStateDone : IndexerStateCommaOrClose;
+}
+
+static const char *stringSkip(const char *aIt, const char *aEnd, EjfpError *aError)
+{
+	for (; aIt != aEnd; ++aIt) {
+		if (*aIt == '"') {
+			return aIt + 1;
+		} else if ((unsigned char)*aIt < 0x20) {
+			*aError = EjfpErrorDeserializationInvalidSyntax;
+
+			return aIt;
+		} else if (*aIt == '\\') {
+			if (++aIt == aEnd) {
+				break;
+			} else if (*aIt == 'u') {
+				for (int i = 0; i < 4; ++i) {
+					if (++aIt == aEnd) {
+						*aError = EjfpErrorDeserializationPartitioned;
+
+						return aIt;
+					} else if (!((*aIt >= '0' && *aIt <= '9') || (*aIt >= 'a' && *aIt <= 'f')
+						|| (*aIt >= 'A' && *aIt <= 'F'))) {
+						*aError = EjfpErrorDeserializationInvalidSyntax;
+
+						return aIt;
+					}
+				}
+			} else if (strchr("\"\\/bfnrt", *aIt) == NULL || *aIt == '\0') {
+				*aError = EjfpErrorDeserializationInvalidSyntax;
+
+				return aIt;
+			}
+		}
+	}
+
+	*aError = EjfpErrorDeserializationPartitioned;
+
+	return aIt;
+}
+
+static const char *primitiveSkip(const char *aIt, const char *aEnd)
+{
+	while (aIt != aEnd && *aIt != ',' && *aIt != '}' && *aIt != ']' && *aIt != ':' && *aIt != ' ' && *aIt != '\t'
+		&& *aIt != '\n' && *aIt != '\r' && *aIt != '"' && *aIt != '\0') {
+		++aIt;
+	}
+
+	return aIt;
+}
+
+static EjfpError indexerRun(Indexer *aIndexer, size_t aInputSize)
+{
+	const char *const kBegin = aIndexer->input;
+	const char *const kEnd = kBegin + aInputSize;
+	EjfpError error = EjfpOk;
+	jsmntok_t *token = NULL;
+
+	// Like "jsmn", treat the NULL character as the end of input
+	for (const char *it = kBegin; it != kEnd && *it != '\0';) {
+		switch (*it) {
+			case ' ':
+			case '\t':
+			case '\n':
+			case '\r':
+				++it;
+
+				break;
+
+			case '{':
+			case '[':
+				if (aIndexer->state != IndexerStateValue && aIndexer->state != IndexerStateValueOrClose) {
+					return EjfpErrorDeserializationInvalidSyntax;
+				} else if ((token = indexerTokenAdd(aIndexer, *it == '{' ? JSMN_OBJECT : JSMN_ARRAY,
+					(size_t)(it - kBegin))) == NULL) {
+					return EjfpErrorDeserializationNoMemory;
+				}
+
+				token->end = aIndexer->open;
+				token->size = aIndexer->key;
+				aIndexer->open = aIndexer->nTokens - 1;
+				aIndexer->key = -1;
+				aIndexer->state = *it == '{' ? IndexerStateKeyOrClose : IndexerStateValueOrClose;
+				++it;
+
+				break;
+
+			case '}':
+			case ']':
+				if (aIndexer->open < 0 || aIndexer->tokens[aIndexer->open].type != (*it == '}' ? JSMN_OBJECT : JSMN_ARRAY)
+					|| (aIndexer->state != IndexerStateCommaOrClose && aIndexer->state != IndexerStateKeyOrClose
+					&& aIndexer->state != IndexerStateValueOrClose)) {
+					return EjfpErrorDeserializationInvalidSyntax;
+				}
+
+				token = &aIndexer->tokens[aIndexer->open];
+				aIndexer->open = token->end;
+				aIndexer->key = token->size;
+				token->end = (jsmnint_t)(++it - kBegin);
+				token->size = aIndexer->nTokens - (int)(token - aIndexer->tokens);
+				indexerValueComplete(aIndexer);
+
+				break;
+
+			case ':':
+				if (aIndexer->state != IndexerStateColon) {
+					return EjfpErrorDeserializationInvalidSyntax;
+				}
+
+				aIndexer->state = IndexerStateValue;
+				++it;
+
+				break;
+
+			case ',':
+				if (aIndexer->state != IndexerStateCommaOrClose) {
+					return EjfpErrorDeserializationInvalidSyntax;
+				}
+
+				aIndexer->state = aIndexer->tokens[aIndexer->open].type == JSMN_OBJECT ? IndexerStateKey :
+					IndexerStateValue;
+				++it;
+
+				break;
+
+			case '"':
+				if (aIndexer->state == IndexerStateColon || aIndexer->state == IndexerStateCommaOrClose
+					|| aIndexer->state == IndexerStateDone) {
+					return EjfpErrorDeserializationInvalidSyntax;
+				} else if ((token = indexerTokenAdd(aIndexer, JSMN_STRING, (size_t)(it - kBegin) + 1)) == NULL) {
+					return EjfpErrorDeserializationNoMemory;
+				}
+
+				it = stringSkip(it + 1, kEnd, &error);
+
+				if (error != EjfpOk) {
+					return error;
+				}
+
+				token->end = (jsmnint_t)(it - kBegin - 1);
+
+				if (aIndexer->state == IndexerStateKey || aIndexer->state == IndexerStateKeyOrClose) {
+					aIndexer->key = aIndexer->nTokens - 1;
+					aIndexer->state = IndexerStateColon;
+				} else {
+					indexerValueComplete(aIndexer);
+				}
+
+				break;
+
+			default:
+				if (aIndexer->state != IndexerStateValue && aIndexer->state != IndexerStateValueOrClose) {
+					return EjfpErrorDeserializationInvalidSyntax;
+				} else if ((token = indexerTokenAdd(aIndexer, JSMN_PRIMITIVE, (size_t)(it - kBegin))) == NULL) {
+					return EjfpErrorDeserializationNoMemory;
+				}
+
+				it = primitiveSkip(it, kEnd);
+
+				// A number may go on
+				if (it == kEnd) {
+					return EjfpErrorDeserializationPartitioned;
+				}
+
+				token->end = (jsmnint_t)(it - kBegin);
+				indexerValueComplete(aIndexer);
+
+				break;
+		}
+	}
+
+	return aIndexer->state == IndexerStateDone ? EjfpOk : EjfpErrorDeserializationPartitioned;
+}
+
+int ejfpPathCompile(EjfpPath *aPath, EjfpPathSegment *aSegments, size_t aSegmentsSize, const char *aPointer)
+{
+	aPath->segments = aSegments;
+	aPath->nSegments = 0;
+
+	if (*aPointer != '\0' && *aPointer != '/') {
+		return EjfpErrorQueryInvalidPath;
+	}
+
+	while (*aPointer == '/') {
+		if (aPath->nSegments == aSegmentsSize) {
+			return EjfpErrorQueryNoMemory;
+		}
+
+		EjfpPathSegment *segment = &aSegments[aPath->nSegments];
+		segment->name = ++aPointer;
+		segment->isEscaped = 0;
+
+		for (; *aPointer != '\0' && *aPointer != '/'; ++aPointer) {
+			if (*aPointer == '~') {
+				if (aPointer[1] != '0' && aPointer[1] != '1') {
+					return EjfpErrorQueryInvalidPath;
+				}
+
+				segment->isEscaped = 1;
+				++aPointer;
+			}
+		}
+
+		segment->nameLength = (size_t)(aPointer - segment->name);
+		segment->index = segment->isEscaped ? SIZE_MAX : segmentIndex(segment->name, segment->nameLength);
+		++aPath->nSegments;
+	}
+
+	return (int)aPath->nSegments;
+}
+
+int ejfpDocumentIndex(EjfpDocument *aDocument, jsmntok_t *aTokens, size_t aTokensSize, const char *aInput,
+	size_t aInputSize)
+{
+	Indexer indexer = {aInput, aTokens, aTokensSize > INT_MAX ? INT_MAX : (int)aTokensSize, 0, -1, -1,
+		IndexerStateValue};
+	aDocument->input = aInput;
+	aDocument->tokens = aTokens;
+	aDocument->nTokens = 0;
+
+#if !EJFP_LARGE_INPUT
+	// Positions would overflow, see `EJFP_LARGE_INPUT`
+	if (aInputSize > INT_MAX) {
+		return EjfpErrorDeserializationNoMemory;
+	}
+#endif  // !EJFP_LARGE_INPUT
+
+	const EjfpError kError = indexerRun(&indexer, aInputSize);
+
+	if (kError != EjfpOk) {
+		return kError;
+	}
+
+	aDocument->nTokens = indexer.nTokens;
+
+	return indexer.nTokens;
+}
+
+int ejfpDocumentFind(const EjfpDocument *aDocument, int aToken, const EjfpPath *aPath)
+{
+	const jsmntok_t *tokens = aDocument->tokens;
+
+	if (aToken < 0 || aToken >= aDocument->nTokens) {
+		return EjfpErrorQueryNotFound;
+	}
+
+	for (size_t iSegment = 0; iSegment < aPath->nSegments; ++iSegment) {
+		const EjfpPathSegment *segment = &aPath->segments[iSegment];
+		const int kEnd = aToken + tokens[aToken].size;
+		int child = aToken + 1;
+
+		switch (tokens[aToken].type) {
+			case JSMN_OBJECT:
+				for (; child < kEnd; child += tokens[child].size) {
+					if (segmentMatches(segment, aDocument->input + tokens[child].start,
+						(size_t)(tokens[child].end - tokens[child].start))) {
+						break;
+					}
+				}
+
+				++child;  // From the key to the value
+
+				break;
+
+			case JSMN_ARRAY:
+				if (segment->index == SIZE_MAX) {
+					return EjfpErrorQueryNotFound;
+				}
+
+				for (size_t i = 0; i < segment->index && child < kEnd; ++i) {
+					child += tokens[child].size;
+				}
+
+				break;
+
+			default:
+				return EjfpErrorQueryNotFound;
+		}
+
+		if (child >= kEnd) {
+			return EjfpErrorQueryNotFound;
+		}
+
+		aToken = child;
+	}
+
+	return aToken;
+}
+
+int ejfpDocumentValue(const EjfpDocument *aDocument, int aToken, EjfpFieldVariant *aFieldVariant)
+{
+	const jsmntok_t *token = &aDocument->tokens[aToken];
+	const char *tokenStart = aDocument->input + token->start;
+	const size_t kTokenLength = (size_t)(token->end - token->start);
+
+	// The key is the only token whose subtree is one token larger than that of the value
+	if (aToken > 0 && token[-1].type == JSMN_STRING && token[-1].size == token->size + 1) {
+		aFieldVariant->fieldName = aDocument->input + token[-1].start;
+		aFieldVariant->fieldNameLength = (size_t)(token[-1].end - token[-1].start);
+	} else {
+		aFieldVariant->fieldName = NULL;
+		aFieldVariant->fieldNameLength = 0;
+	}
+
+	switch (token->type) {
+		case JSMN_STRING:
+			aFieldVariant->fieldType = EjfpFieldVariantTypeString;
+			aFieldVariant->stringValue = tokenStart;
+			aFieldVariant->stringValueLength = kTokenLength;
+
+			return 1;
+
+		case JSMN_PRIMITIVE:
+			ejfpFieldVariantParsePrimitive(aFieldVariant, tokenStart, kTokenLength);
+
+			if (aFieldVariant->fieldType == EjfpFieldVariantTypeUninitialized) {
+				return EjfpErrorDeserializationUnsupportedJsonStructure;
+			}
+
+			return 1;
+
+		default:
+			return EjfpErrorDeserializationUnsupportedJsonStructure;
+	}
+}
+
+int ejfpDocumentQuery(const EjfpDocument *aDocument, const char *aPointer, EjfpFieldVariant *aFieldVariant)
+{
+	EjfpPathSegment segments[EJFP_QUERY_SEGMENTS_MAX];
+	EjfpPath path;
+	int result = ejfpPathCompile(&path, segments, EJFP_QUERY_SEGMENTS_MAX, aPointer);
+
+	if (result < 0) {
+		return result;
+	}
+
+	result = ejfpDocumentFind(aDocument, 0, &path);
+
+	if (result < 0) {
+		return result;
+	}
+
+	return ejfpDocumentValue(aDocument, result, aFieldVariant);
+}
+
+#endif  // !EJFP_COMPACT
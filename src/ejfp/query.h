@@ -0,0 +1,110 @@
+//
+// query.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Lookup of values in nested JSON documents by JSON Pointer (RFC 6901), e.g.
+// "/sensors/3/temp". A document is tokenized once into an index, where each
+// token knows the size of its subtree, so a lookup steps over siblings in
+// O(1) each, and never converts values off the path.
+//
+
+#ifndef EJFP_QUERY_H_
+#define EJFP_QUERY_H_
+
+#include "ejfp/fieldVariant.h"
+#include <jsmn/jsmn_fwd.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if !EJFP_COMPACT  // Requires pointer-based fields, see `EJFP_COMPACT`
+
+/// @brief Max. number of segments of a pointer passed to `ejfpDocumentQuery`,
+/// which compiles it on the stack
+#ifndef EJFP_QUERY_SEGMENTS_MAX
+# define EJFP_QUERY_SEGMENTS_MAX 8
+#endif
+
+/// @brief Reference token of a path. Treat as opaque
+typedef struct {
+	/// @brief Points into the path, may contain "~0" and "~1" escapes
+	const char *name;
+	size_t nameLength;
+
+	/// @brief Array index, if the segment is one. `SIZE_MAX` otherwise
+	size_t index;
+	uint8_t isEscaped;
+} EjfpPathSegment;
+
+/// @brief Compiled JSON Pointer, see `ejfpPathCompile`. May be reused across
+/// documents
+typedef struct {
+	EjfpPathSegment *segments;
+	size_t nSegments;
+} EjfpPath;
+
+/// @brief Tokenized document. Treat as opaque
+typedef struct {
+	const char *input;
+
+	/// @brief Caller-provided. Once indexed, `jsmntok_t::size` holds the
+	/// number of tokens in the subtree, the token itself included. The
+	/// subtree of a key comprises its value
+	jsmntok_t *tokens;
+	int nTokens;
+} EjfpDocument;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @brief Splits a JSON Pointer into segments. The pointer is referenced, not
+/// copied
+///
+/// @param aPointer NULL-terminated. "" refers to the whole document
+/// @return Number of segments, if succeeded. `EjfpErrorQueryInvalidPath`, if
+/// the pointer is malformed. `EjfpErrorQueryNoMemory`, if there are more than
+/// `aSegmentsSize` segments
+int ejfpPathCompile(EjfpPath *aPath, EjfpPathSegment *aSegments, size_t aSegmentsSize, const char *aPointer);
+
+/// @brief Tokenizes a document of any structure, and records subtree sizes.
+/// The input is referenced, not copied
+///
+/// @param aTokens One per key, value, object, and array
+/// @return Number of tokens, if succeeded. Deserialization error code otherwise
+int ejfpDocumentIndex(EjfpDocument *aDocument, jsmntok_t *aTokens, size_t aTokensSize, const char *aInput,
+	size_t aInputSize);
+
+/// @brief Looks a value up. Object keys are compared the way they are
+/// written in the input, i.e. escape sequences are not decoded, the same as
+/// `EjfpFieldVariant::fieldName`
+///
+/// @param aToken Token the path is relative to, e.g. one found earlier. 0 is
+/// the root
+/// @return Token of the value, if succeeded. `EjfpErrorQueryNotFound`, if
+/// there is no such value. Error code otherwise
+int ejfpDocumentFind(const EjfpDocument *aDocument, int aToken, const EjfpPath *aPath);
+
+/// @brief Converts a scalar value. The name is set to its key, or to NULL
+/// for array items and the root
+///
+/// @return 1, if succeeded. `EjfpErrorDeserializationUnsupportedJsonStructure`,
+/// if the value is an object, an array, or a type disabled by "ejfp/config.h"
+int ejfpDocumentValue(const EjfpDocument *aDocument, int aToken, EjfpFieldVariant *aFieldVariant);
+
+/// @brief Compiles the pointer, and converts the value it refers to. Prefer
+/// `ejfpPathCompile` and `ejfpDocumentFind` for paths which are looked up
+/// repeatedly, or which are longer
+///
+/// @return 1, if succeeded. `EjfpErrorQueryNoMemory`, if the pointer has
+/// more than `EJFP_QUERY_SEGMENTS_MAX` segments. Error code otherwise
+int ejfpDocumentQuery(const EjfpDocument *aDocument, const char *aPointer, EjfpFieldVariant *aFieldVariant);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !EJFP_COMPACT
+
+#endif  // EJFP_QUERY_H_
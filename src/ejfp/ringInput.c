@@ -0,0 +1,376 @@
+//
+// ringInput.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/deserialization.h"
+#include "ejfp/error.h"
+#include "ejfp/fieldVariant.h"
+#include "ejfp/ringInput.h"
+#include "ejfp/trace.h"
+#include <jsmn/jsmn_fwd.h>
+#include <limits.h>
+#include <string.h>
+
+#if !EJFP_COMPACT  // Requires pointer-based fields, see `EJFP_COMPACT`
+
+/// @brief Max. length of a primitive token copied on the stack, e.g.
+/// "-2.2250738585072014e-308". Longer ones take spill space
+#define RING_PRIMITIVE_MAX_LENGTH 63
+
+typedef struct {
+	const EjfpRingInput *input;
+	size_t position;
+	size_t size;
+
+	/// @brief Free space in the spill buffer
+	char *spill;
+	const char *spillEnd;
+} RingCursor;
+
+static int ringAt(const RingCursor *aCursor, size_t aPosition);
+
+/// @brief Copies [aStart; aEnd) out of the ring
+static void ringCopy(const RingCursor *aCursor, char *aOut, size_t aStart, size_t aEnd);
+
+/// @brief Resolves [aStart; aEnd) into a pointer. Spills the range, if it straddles the boundary
+/// @return NULL, if there is not enough spill space
+static const char *ringResolve(RingCursor *aCursor, size_t aStart, size_t aEnd);
+
+/// @return True, where "jsmn" stops: past the input, or at a NULL character
+static int ringIsEnd(const RingCursor *aCursor, size_t aPosition);
+
+/// @brief Tokenizes the input the way "jsmn" does in the non-strict mode
+/// `ejfpDeserialize` uses it in, so both accept the same inputs. Positions of
+/// the tokens are relative to the start of `head`
+///
+/// @return Number of tokens, if succeeded. Error code otherwise
+static int ringTokenize(RingCursor *aCursor, jsmntok_t *aTokens, size_t aTokensSize);
+
+/// @brief Scans a string token, `position` is expected to point at the opening quote
+static int ringTokenizeString(RingCursor *aCursor, jsmntok_t *aToken);
+
+/// @brief Scans a primitive token, and leaves `position` at its last character
+static int ringTokenizePrimitive(RingCursor *aCursor, jsmntok_t *aToken);
+
+/// @brief Tokenizes, validates, and parses the fields of a ring input. Blobs
+/// are decoded by the caller
+static int ringDeserialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const EjfpRingInput *aRingInput, char *aSpill, size_t aSpillSize);
+
+static inline int ringAt(const RingCursor *aCursor, size_t aPosition)
+{
+	if (aPosition < aCursor->input->headSize) {
+		return aCursor->input->head[aPosition];
+	}
+
+	return aCursor->input->tail[aPosition - aCursor->input->headSize];
+}
+
+static void ringCopy(const RingCursor *aCursor, char *aOut, size_t aStart, size_t aEnd)
+{
+	const size_t kHeadSize = aCursor->input->headSize;
+
+	if (aStart < kHeadSize) {
+		const size_t kHeadEnd = aEnd < kHeadSize ? aEnd : kHeadSize;
+		memcpy(aOut, aCursor->input->head + aStart, kHeadEnd - aStart);
+		aOut += kHeadEnd - aStart;
+		aStart = kHeadEnd;
+	}
+
+	if (aStart < aEnd) {
+		memcpy(aOut, aCursor->input->tail + (aStart - kHeadSize), aEnd - aStart);
+	}
+}
+
+static const char *ringResolve(RingCursor *aCursor, size_t aStart, size_t aEnd)
+{
+	const size_t kHeadSize = aCursor->input->headSize;
+	const char *resolved = aCursor->spill;
+
+	if (aEnd <= kHeadSize) {
+		return aCursor->input->head + aStart;
+	} else if (aStart >= kHeadSize) {
+		return aCursor->input->tail + (aStart - kHeadSize);
+	}
+
+	if ((size_t)(aCursor->spillEnd - aCursor->spill) < aEnd - aStart) {
+		return NULL;
+	}
+
+	ringCopy(aCursor, aCursor->spill, aStart, aEnd);
+	aCursor->spill += aEnd - aStart;
+
+	return resolved;
+}
+
+static inline int ringIsEnd(const RingCursor *aCursor, size_t aPosition)
+{
+	return aPosition >= aCursor->size || ringAt(aCursor, aPosition) == '\0';
+}
+
+static int ringTokenize(RingCursor *aCursor, jsmntok_t *aTokens, size_t aTokensSize)
+{
+	size_t nTokens = 0;
+
+	for (; !ringIsEnd(aCursor, aCursor->position); ++aCursor->position) {
+		const int kCharacter = ringAt(aCursor, aCursor->position);
+		int error = EjfpOk;
+		size_t i = nTokens;
+		jsmntok_t token;
+
+		switch (kCharacter) {
+			case '\t':
+			case '\r':
+			case '\n':
+			case ' ':
+			case ':':  // Separators only link tokens to their parents, which is not used
+			case ',':
+				break;
+
+			case '{':
+			case '[':
+				if (nTokens == aTokensSize) {
+					return EjfpErrorDeserializationNoMemory;
+				}
+
+				aTokens[nTokens].type = kCharacter == '{' ? JSMN_OBJECT : JSMN_ARRAY;
+				aTokens[nTokens].start = (jsmnint_t)aCursor->position;
+				aTokens[nTokens].end = -1;
+				++nTokens;
+
+				break;
+
+			case '}':
+			case ']':
+				// Closes the innermost open container
+				while (i > 0 && !(aTokens[i - 1].start != -1 && aTokens[i - 1].end == -1)) {
+					--i;
+				}
+
+				if (i == 0 || aTokens[i - 1].type != (kCharacter == '}' ? JSMN_OBJECT : JSMN_ARRAY)) {
+					return EjfpErrorDeserializationInvalidSyntax;
+				}
+
+				aTokens[i - 1].end = (jsmnint_t)aCursor->position + 1;
+
+				break;
+
+			default:
+				// Syntax errors take precedence over the lack of tokens, as in "jsmn"
+				error = kCharacter == '"' ? ringTokenizeString(aCursor, &token) : ringTokenizePrimitive(aCursor, &token);
+
+				if (EjfpOk != error) {
+					return error;
+				} else if (nTokens == aTokensSize) {
+					return EjfpErrorDeserializationNoMemory;
+				}
+
+				aTokens[nTokens++] = token;
+
+				break;
+		}
+	}
+
+	for (size_t i = 0; i < nTokens; ++i) {
+		if (aTokens[i].end == -1) {
+			return EjfpErrorDeserializationPartitioned;  // Unmatched open container
+		}
+	}
+
+	return (int)nTokens;
+}
+
+static int ringTokenizeString(RingCursor *aCursor, jsmntok_t *aToken)
+{
+	const size_t kStart = aCursor->position + 1;
+
+	for (size_t position = kStart; !ringIsEnd(aCursor, position); ++position) {
+		const int kCharacter = ringAt(aCursor, position);
+
+		if (kCharacter == '"') {
+			aToken->type = JSMN_STRING;
+			aToken->start = (jsmnint_t)kStart;
+			aToken->end = (jsmnint_t)position;
+			aCursor->position = position;
+
+			return EjfpOk;
+		} else if (kCharacter != '\\' || position + 1 >= aCursor->size) {
+			continue;
+		}
+
+		switch (ringAt(aCursor, ++position)) {
+			case '"':
+			case '/':
+			case '\\':
+			case 'b':
+			case 'f':
+			case 'r':
+			case 'n':
+			case 't':
+				break;
+
+			case 'u':
+				for (size_t i = 0; i < 4 && !ringIsEnd(aCursor, position + 1); ++i) {
+					const int kDigit = ringAt(aCursor, ++position);
+
+					if (!((kDigit >= '0' && kDigit <= '9') || (kDigit >= 'A' && kDigit <= 'F')
+							|| (kDigit >= 'a' && kDigit <= 'f'))) {
+						return EjfpErrorDeserializationInvalidSyntax;
+					}
+				}
+
+				break;
+
+			default:
+				return EjfpErrorDeserializationInvalidSyntax;
+		}
+	}
+
+	return EjfpErrorDeserializationPartitioned;
+}
+
+static int ringTokenizePrimitive(RingCursor *aCursor, jsmntok_t *aToken)
+{
+	size_t position = aCursor->position;
+
+	for (; !ringIsEnd(aCursor, position); ++position) {
+		const int kCharacter = ringAt(aCursor, position);
+
+		if (kCharacter == '\t' || kCharacter == '\r' || kCharacter == '\n' || kCharacter == ' '
+				|| kCharacter == ':' || kCharacter == ',' || kCharacter == ']' || kCharacter == '}') {
+			break;
+		} else if (kCharacter < 32 || kCharacter >= 127) {
+			return EjfpErrorDeserializationInvalidSyntax;
+		}
+	}
+
+	// A primitive is complete at the end of the input too
+	aToken->type = JSMN_PRIMITIVE;
+	aToken->start = (jsmnint_t)aCursor->position;
+	aToken->end = (jsmnint_t)position;
+	aCursor->position = position - 1;
+
+	return EjfpOk;
+}
+
+void ejfpRingInputInitialize(EjfpRingInput *aRingInput, const char *aRing, size_t aRingSize, size_t aOffset,
+	size_t aSize)
+{
+	aRingInput->head = aRing + aOffset;
+
+	if (aOffset + aSize <= aRingSize) {
+		aRingInput->headSize = aSize;
+		aRingInput->tail = aRing;
+		aRingInput->tailSize = 0;
+	} else {
+		aRingInput->headSize = aRingSize - aOffset;
+		aRingInput->tail = aRing;
+		aRingInput->tailSize = aSize - aRingInput->headSize;
+	}
+}
+
+static int ringDeserialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const EjfpRingInput *aRingInput, char *aSpill, size_t aSpillSize)
+{
+	RingCursor cursor = {aRingInput, 0, aRingInput->headSize + aRingInput->tailSize, aSpill, aSpill + aSpillSize};
+	const size_t kTokensSize = 1 + 2 * aFieldVariantArraySize;  // Same as `ejfpDeserialize`
+	jsmntok_t tokens[kTokensSize];
+	size_t iFieldVariant = 0;
+
+#if !EJFP_LARGE_INPUT
+	// Positions would overflow, see `EJFP_LARGE_INPUT`
+	if (cursor.size > INT_MAX) {
+		return EjfpErrorDeserializationNoMemory;
+	}
+#endif  // !EJFP_LARGE_INPUT
+
+	EJFP_TRACE_MARK(aEjfp, traceMark);
+	const int kNTokens = ringTokenize(&cursor, tokens, kTokensSize);
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseTokenize, cursor.size, traceMark);
+
+	if (kNTokens < 0) {
+		return kNTokens;
+	} else if (!ejfpJsmntoksIsValid(tokens, kNTokens)) {
+		return EjfpErrorDeserializationUnsupportedJsonStructure;
+	}
+
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseValidate, cursor.size, traceMark);
+
+	for (int i = 1; i < kNTokens; i += 2, ++iFieldVariant) {
+		EjfpFieldVariant *fieldVariant = &aFieldVariantArray[iFieldVariant];
+		const jsmntok_t *name = &tokens[i];
+		const jsmntok_t *value = &tokens[i + 1];
+
+		if (iFieldVariant == aFieldVariantArraySize) {
+			return EjfpErrorDeserializationNoMemory;
+		} else if ((fieldVariant->fieldName = ringResolve(&cursor, name->start, name->end)) == NULL) {
+			return EjfpErrorDeserializationNoMemory;
+		}
+
+		fieldVariant->fieldNameLength = name->end - name->start;
+
+		if (value->type == JSMN_STRING) {
+			if ((fieldVariant->stringValue = ringResolve(&cursor, value->start, value->end)) == NULL) {
+				return EjfpErrorDeserializationNoMemory;
+			}
+
+			fieldVariant->fieldType = EjfpFieldVariantTypeString;
+			fieldVariant->stringValueLength = value->end - value->start;
+		} else {
+			// Primitives are always copied, so the number parsers stop at the NULL character. Long ones are spilled
+			const size_t kLength = value->end - value->start;
+			char primitive[RING_PRIMITIVE_MAX_LENGTH + 1];
+			char *copy = primitive;
+
+			if (kLength > RING_PRIMITIVE_MAX_LENGTH) {
+				if ((size_t)(cursor.spillEnd - cursor.spill) < kLength + 1) {
+					return EjfpErrorDeserializationNoMemory;
+				}
+
+				copy = cursor.spill;
+				cursor.spill += kLength + 1;
+			}
+
+			ringCopy(&cursor, copy, value->start, value->end);
+			copy[kLength] = '\0';
+			ejfpFieldVariantParseSchemaPrimitive(aEjfp, fieldVariant, fieldVariant->fieldName,
+				fieldVariant->fieldNameLength, copy, kLength);
+
+			if (fieldVariant->fieldType == EjfpFieldVariantTypeUninitialized) {
+				return EjfpErrorDeserializationUnsupportedJsonStructure;
+			}
+		}
+	}
+
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseParse, cursor.size, traceMark);
+
+	return (int)iFieldVariant;
+}
+
+int ejfpDeserializeRing(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const EjfpRingInput *aRingInput, char *aSpill, size_t aSpillSize)
+{
+	// Only JSON is tokenized here
+	if (aEjfp->encoding != EjfpEncodingJson) {
+		return EjfpErrorDeserializationUnsupportedEncoding;
+	}
+
+	EJFP_TRACE_MARK(aEjfp, traceMark);
+	int result = ringDeserialize(aEjfp, aFieldVariantArray, aFieldVariantArraySize, aRingInput, aSpill, aSpillSize);
+
+#if EJFP_ENABLE_BINARY
+	// Blobs never stay in place, the ring is read-only
+	if (result > 0 && aEjfp->binaryFieldsSize > 0) {
+		result = ejfpFieldVariantsDecodeBinary(aEjfp, aFieldVariantArray, result);
+	}
+#endif  // EJFP_ENABLE_BINARY
+
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseDeserialize, aRingInput->headSize + aRingInput->tailSize, traceMark);
+
+	return result;
+}
+
+#endif  // !EJFP_COMPACT
@@ -0,0 +1,56 @@
+//
+// ringInput.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Deserialization from a circular buffer w/o linearizing it. A message which
+// wraps past the end of the ring is represented as two segments.
+//
+
+#ifndef EJFP_RINGINPUT_H_
+#define EJFP_RINGINPUT_H_
+
+#include "ejfp/ejfp.h"
+#include "ejfp/fieldVariant.h"
+#include <stddef.h>
+
+#if !EJFP_COMPACT  // Requires pointer-based fields, see `EJFP_COMPACT`
+
+/// @brief Two-segment input. Bytes of `head` go first, then those of `tail`
+typedef struct {
+	const char *head;
+	size_t headSize;
+	const char *tail;
+	size_t tailSize;
+} EjfpRingInput;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @brief Initializes a two-segment view of `aSize` bytes starting at
+/// `aOffset` in a ring of `aRingSize` bytes
+void ejfpRingInputInitialize(EjfpRingInput *aRingInput, const char *aRing, size_t aRingSize, size_t aOffset,
+	size_t aSize);
+
+/// @brief Deserializes a message which may be split between the segments.
+/// Field names and string values reference the segments directly. Only those
+/// which straddle the boundary are copied into the spill buffer, as are
+/// primitives longer than 63 characters. Inputs are accepted or rejected as
+/// they are by a fresh `Ejfp` instance w/ `ejfpDeserialize`, and the settings
+/// of `aEjfp` apply the same way: fixed-point and binary schemas, and trace
+/// hooks. Blobs are always decoded into the buffer of the binary schema
+///
+/// @return Number of filled `EjfpFieldVariant` instances. Error code otherwise,
+/// e.g. `EjfpErrorDeserializationUnsupportedEncoding` for CBOR instances
+int ejfpDeserializeRing(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray, size_t aFieldVariantArraySize,
+	const EjfpRingInput *aRingInput, char *aSpill, size_t aSpillSize);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !EJFP_COMPACT
+
+#endif  // EJFP_RINGINPUT_H_
@@ -0,0 +1,146 @@
+//
+// router.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/deserialization.h"
+#include "ejfp/error.h"
+#include "ejfp/router.h"
+#include "ejfp/validation.h"
+#include <string.h>
+
+typedef struct {
+	const EjfpRouter *router;
+	const char *inputBuffer;
+	const char *value;
+	size_t valueLength;
+} Peek;
+
+/// @brief FNV-1a
+static uint32_t hash(const char *aData, size_t aDataSize);
+
+/// @brief Finds the slot of a value, or the free slot it would occupy
+static EjfpRoute *routeFind(const EjfpRouter *aRouter, const char *aValue, size_t aValueLength, uint32_t aHash);
+
+/// @brief `EjfpScanCallback`. Stops the scan at the discriminator
+static int peekPair(void *aContext, const EjfpScanPair *aPair);
+
+static uint32_t hash(const char *aData, size_t aDataSize)
+{
+	uint32_t result = 2166136261u;
+
+	for (size_t i = 0; i < aDataSize; ++i) {
+		result = (result ^ (uint8_t)aData[i]) * 16777619u;
+	}
+
+	return result;
+}
+
+static EjfpRoute *routeFind(const EjfpRouter *aRouter, const char *aValue, size_t aValueLength, uint32_t aHash)
+{
+	for (size_t i = aHash & aRouter->routesMask;; i = (i + 1) & aRouter->routesMask) {
+		EjfpRoute *route = &aRouter->routes[i];
+
+		if (route->value == NULL || (route->hash == aHash && route->valueLength == aValueLength
+			&& memcmp(route->value, aValue, aValueLength) == 0)) {
+			return route;
+		}
+	}
+}
+
+static int peekPair(void *aContext, const EjfpScanPair *aPair)
+{
+	Peek *peek = (Peek *)aContext;
+
+	if (aPair->keyEnd - aPair->keyStart != peek->router->keyLength
+		|| memcmp(peek->inputBuffer + aPair->keyStart, peek->router->key, peek->router->keyLength) != 0) {
+		return 0;
+	}
+
+	peek->value = peek->inputBuffer + aPair->valueStart;
+	peek->valueLength = aPair->valueEnd - aPair->valueStart;
+
+	return 1;
+}
+
+void ejfpRouterInitialize(EjfpRouter *aRouter, const char *aKey, EjfpRoute *aRoutes, size_t aRoutesSize,
+	EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize)
+{
+	aRouter->key = aKey;
+	aRouter->keyLength = strlen(aKey);
+	aRouter->routes = aRoutes;
+	aRouter->routesMask = aRoutesSize - 1;
+	aRouter->nRoutes = 0;
+	aRouter->fallback = NULL;
+	aRouter->fallbackContext = NULL;
+	aRouter->fieldVariants = aFieldVariants;
+	aRouter->fieldVariantsSize = aFieldVariantsSize;
+	memset(aRoutes, 0, aRoutesSize * sizeof(EjfpRoute));
+}
+
+int ejfpRouterAdd(EjfpRouter *aRouter, const char *aValue, EjfpRouterHandler aHandler, void *aContext)
+{
+	const size_t kValueLength = strlen(aValue);
+	const uint32_t kHash = hash(aValue, kValueLength);
+	EjfpRoute *route = routeFind(aRouter, aValue, kValueLength, kHash);
+
+	if (route->value == NULL) {
+		// Keep 1 slot free, so lookups of unknown values terminate
+		if (aRouter->nRoutes + 1 > aRouter->routesMask) {
+			return EjfpErrorRouterNoMemory;
+		}
+
+		route->value = aValue;
+		route->valueLength = kValueLength;
+		route->hash = kHash;
+		++aRouter->nRoutes;
+	}
+
+	route->handler = aHandler;
+	route->context = aContext;
+
+	return EjfpOk;
+}
+
+void ejfpRouterSetFallback(EjfpRouter *aRouter, EjfpRouterHandler aHandler, void *aContext)
+{
+	aRouter->fallback = aHandler;
+	aRouter->fallbackContext = aContext;
+}
+
+int ejfpRouterDispatch(EjfpRouter *aRouter, Ejfp *aEjfp, const char *aInputBuffer, size_t aInputBufferSize)
+{
+	Peek peek = {aRouter, aInputBuffer, NULL, 0};
+	EjfpRouterHandler handler = aRouter->fallback;
+	void *context = aRouter->fallbackContext;
+	const int kPeekResult = ejfpScan(aInputBuffer, aInputBufferSize, peekPair, &peek, NULL);
+
+	if (kPeekResult < 0) {
+		return kPeekResult;
+	}
+
+	if (peek.value != NULL) {
+		const EjfpRoute *route = routeFind(aRouter, peek.value, peek.valueLength, hash(peek.value, peek.valueLength));
+
+		if (route->value != NULL) {
+			handler = route->handler;
+			context = route->context;
+		}
+	}
+
+	if (handler == NULL) {
+		return EjfpErrorRouterNoRoute;
+	}
+
+	ejfpReset(aEjfp);  // Drop the state left by a previous message
+	const int kNFieldVariants = ejfpDeserialize(aEjfp, aRouter->fieldVariants, aRouter->fieldVariantsSize,
+		aInputBuffer, aInputBufferSize);
+
+	if (kNFieldVariants >= 0) {
+		handler(context, aEjfp, aRouter->fieldVariants, (size_t)kNFieldVariants);
+	}
+
+	return kNFieldVariants;
+}
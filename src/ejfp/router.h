@@ -0,0 +1,85 @@
+//
+// router.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Dispatch of messages to handlers by the value of a discriminator key, e.g.
+// "type". The discriminator is looked up in a hash table, and is peeked at w/
+// `ejfpScan` before the message is deserialized, so messages w/o a handler
+// are never converted.
+//
+
+#ifndef EJFP_ROUTER_H_
+#define EJFP_ROUTER_H_
+
+#include "ejfp/ejfp.h"
+#include "ejfp/fieldVariant.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief Is called w/ a deserialized message. In compact mode, fields are
+/// relative to `aEjfp->base`
+typedef void (*EjfpRouterHandler)(void *aContext, Ejfp *aEjfp, const EjfpFieldVariant *aFieldVariants,
+	size_t aNFieldVariants);
+
+/// @brief Slot of the route table. Treat as opaque
+typedef struct {
+	/// @brief NULL, if the slot is free
+	const char *value;
+	size_t valueLength;
+	uint32_t hash;
+	EjfpRouterHandler handler;
+	void *context;
+} EjfpRoute;
+
+typedef struct {
+	const char *key;
+	size_t keyLength;
+
+	/// @brief Open addressing table, the size is a power of 2
+	EjfpRoute *routes;
+	size_t routesMask;
+	size_t nRoutes;
+
+	/// @brief Handles messages w/ a discriminator w/o a route, or w/o one at all. May be NULL
+	EjfpRouterHandler fallback;
+	void *fallbackContext;
+
+	EjfpFieldVariant *fieldVariants;
+	size_t fieldVariantsSize;
+} EjfpRouter;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @param aKey Discriminator key, is referenced, not copied
+/// @param aRoutes Route table. Its size must be a power of 2, and should be
+/// at least twice the number of routes
+/// @param aFieldVariants Storage for deserialized messages
+void ejfpRouterInitialize(EjfpRouter *aRouter, const char *aKey, EjfpRoute *aRoutes, size_t aRoutesSize,
+	EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize);
+
+/// @brief Registers a handler for a discriminator value. A string value is
+/// matched against the string w/o quotes, other values are matched against
+/// their JSON text, e.g. "42". A value registered twice is rebound
+///
+/// @param aValue Is referenced, not copied
+/// @return `EjfpOk`, if succeeded. `EjfpErrorRouterNoMemory`, if the table is full
+int ejfpRouterAdd(EjfpRouter *aRouter, const char *aValue, EjfpRouterHandler aHandler, void *aContext);
+
+void ejfpRouterSetFallback(EjfpRouter *aRouter, EjfpRouterHandler aHandler, void *aContext);
+
+/// @brief Picks a handler by the discriminator, deserializes the message,
+/// and calls the handler
+///
+/// @return Number of fields passed to the handler. `EjfpErrorRouterNoRoute`,
+/// if there is no handler for the message. Error code otherwise
+int ejfpRouterDispatch(EjfpRouter *aRouter, Ejfp *aEjfp, const char *aInputBuffer, size_t aInputBufferSize);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // EJFP_ROUTER_H_
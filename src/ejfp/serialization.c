@@ -5,12 +5,72 @@
 //  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
 //
 
+#include "ejfp/base64.h"
+#include "ejfp/cbor.h"
 #include "ejfp/ejfp.h"
 #include "ejfp/error.h"
 #include "ejfp/fieldVariant.h"
+#include "ejfp/format.h"
+#include "ejfp/serialization.h"
+#include "ejfp/sink.h"
+#include "ejfp/trace.h"
 #include <mtojson/mtojson.h>
 #include <string.h>
 
+#if EJFP_ENABLE_REAL && !MTOJSON_ENABLE_REAL
+#error "EJFP_ENABLE_REAL requires MTOJSON_ENABLE_REAL"
+#endif
+
+#if EJFP_ENABLE_INT64 && !MTOJSON_ENABLE_INT64
+#error "EJFP_ENABLE_INT64 requires MTOJSON_ENABLE_INT64"
+#endif
+
+/// @brief Serializes into a contiguous sink, for the objects "mtojson" cannot handle
+static int sinkSerialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, const size_t aFieldVariantsSize,
+	char *aOutBuffer, const size_t aOutBufferSize);
+
+static int sinkSerialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, const size_t aFieldVariantsSize,
+	char *aOutBuffer, const size_t aOutBufferSize)
+{
+	EjfpSink sink;
+	int nSerialized = 0;
+
+	if (aOutBufferSize == 0) {
+		ejfpSetErrorCode(EjfpErrorSerializationNoMemory);
+
+		return 0;
+	}
+
+	ejfpSinkInitialize(&sink, aOutBuffer, aOutBufferSize - 1, NULL, NULL);  // Reserve the NULL character
+	nSerialized = ejfpSerializeToSink(aEjfp, aFieldVariants, aFieldVariantsSize, &sink);
+
+	if (nSerialized < 0) {
+		ejfpSetErrorCode(nSerialized);
+
+		return 0;
+	}
+
+	aOutBuffer[nSerialized] = '\0';
+
+	return nSerialized;
+}
+
+#if EJFP_COMPACT
+
+// "mtojson" requires NULL-terminated names, so the compact mode serializes through a contiguous sink
+
+int ejfpSerialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, const size_t aFieldVariantsSize, char *aOutBuffer,
+	const size_t aOutBufferSize)
+{
+	EJFP_TRACE_MARK(aEjfp, traceMark);
+	const int kNSerialized = sinkSerialize(aEjfp, aFieldVariants, aFieldVariantsSize, aOutBuffer, aOutBufferSize);
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseSerialize, (size_t)kNSerialized, traceMark);
+
+	return kNSerialized;
+}
+
+#else
+
 typedef struct {
 	struct to_json toJson;
 
@@ -21,20 +81,29 @@ typedef struct {
 } WrappedToJson;
 
 static void tojsonSetObjectMarkerStart(struct to_json *aInstance);
-static void tojsonSetBoolean(struct to_json *aInstance, const char *aFieldName, int *aValue);
+/// @param aValue Any non-zero value is `true`. "mtojson" reads booleans as `_Bool`
+static void tojsonSetBoolean(struct to_json *aInstance, const char *aFieldName, int aValue);
 static void tojsonSetInteger(struct to_json *aInstance, const char *aFieldName, int *aValue);
 static void tojsonSetString(struct to_json *aInstance, const char *aFieldName, const char *aValue);
+static void tojsonSetValue(struct to_json *aInstance, const char *aFieldName, const void *aValue,
+	enum json_to_type aValueType);
 static size_t tojsonOutputArraySize(size_t aNFields);
 
+/// @brief `ejfpSerialize`, less the tracing of the whole call
+static int objectSerialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, const size_t aFieldVariantsSize,
+	char *aOutBuffer, const size_t aOutBufferSize);
+
 static inline void tojsonSetObjectMarkerStart(struct to_json *aInstance)
 {
 	aInstance->stype = t_to_object;
 }
 
-static inline void tojsonSetBoolean(struct to_json *aInstance, const char *aFieldName, int *aValue)
+static inline void tojsonSetBoolean(struct to_json *aInstance, const char *aFieldName, int aValue)
 {
+	static const _Bool kTrue = 1;
+	static const _Bool kFalse = 0;
 	aInstance->name = aFieldName;
-	aInstance->value = (void *)aValue;
+	aInstance->value = (void *)(aValue != 0 ? &kTrue : &kFalse);
 	aInstance->vtype = t_to_boolean;
 }
 
@@ -52,6 +121,15 @@ static inline void tojsonSetString(struct to_json *aInstance, const char *aField
 	aInstance->vtype = t_to_string;
 }
 
+/// @brief Generic setter for the types which map onto "mtojson" types directly
+static inline void tojsonSetValue(struct to_json *aInstance, const char *aFieldName, const void *aValue,
+	enum json_to_type aValueType)
+{
+	aInstance->name = aFieldName;
+	aInstance->value = aValue;
+	aInstance->vtype = aValueType;
+}
+
 static inline size_t tojsonOutputArraySize(size_t aNFields)
 {
 	return aNFields + 1;
@@ -59,14 +137,13 @@ static inline size_t tojsonOutputArraySize(size_t aNFields)
 
 void outputToJsonInitialize(struct to_json *aOutputToJsons, EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize)
 {
-	const size_t kOutputArraySize = tojsonOutputArraySize(aFieldVariantsSize);
 	tojsonSetObjectMarkerStart(&aOutputToJsons[0]);  // Start element, see "mtojson" implementation
 
-	for (size_t i = 0; i < kOutputArraySize; ++i) {
+	// The last element is left zeroed, it terminates the object
+	for (size_t i = 0; i < aFieldVariantsSize; ++i) {
 		switch (aFieldVariants[i].fieldType) {
 			case EjfpFieldVariantTypeBoolean:
-				tojsonSetBoolean(&aOutputToJsons[i], aFieldVariants[i].fieldName,
-					&aFieldVariants[i].booleanValue);
+				tojsonSetBoolean(&aOutputToJsons[i], aFieldVariants[i].fieldName, aFieldVariants[i].booleanValue);
 
 				break;
 
@@ -81,20 +158,84 @@ void outputToJsonInitialize(struct to_json *aOutputToJsons, EjfpFieldVariant *aF
 					aFieldVariants[i].stringValue);
 
 				break;
+
+#if EJFP_ENABLE_REAL
+			case EjfpFieldVariantTypeFloat:
+				tojsonSetValue(&aOutputToJsons[i], aFieldVariants[i].fieldName, &aFieldVariants[i].floatValue,
+					t_to_float);
+
+				break;
+#endif  // EJFP_ENABLE_REAL
+
+			case EjfpFieldVariantTypeNull:
+				tojsonSetValue(&aOutputToJsons[i], aFieldVariants[i].fieldName, NULL, t_to_null);
+
+				break;
+
+#if EJFP_ENABLE_INT64
+			case EjfpFieldVariantTypeInteger64:
+				tojsonSetValue(&aOutputToJsons[i], aFieldVariants[i].fieldName,
+					&aFieldVariants[i].integer64Value, t_to_int64_t);
+
+				break;
+
+			case EjfpFieldVariantTypeUnsignedInteger64:
+				tojsonSetValue(&aOutputToJsons[i], aFieldVariants[i].fieldName,
+					&aFieldVariants[i].unsignedInteger64Value, t_to_uint64_t);
+
+				break;
+#endif  // EJFP_ENABLE_INT64
+
+#if EJFP_ENABLE_REAL
+			case EjfpFieldVariantTypeDouble:
+				tojsonSetValue(&aOutputToJsons[i], aFieldVariants[i].fieldName, &aFieldVariants[i].doubleValue,
+					t_to_double);
+
+				break;
+#endif  // EJFP_ENABLE_REAL
+
+			default:
+				break;
 		}
 	}
 }
 
-int ejfpSerialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, const size_t aFieldVariantsSize, char *aOutBuffer,
-	const size_t aOutBufferSize)
+static int objectSerialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, const size_t aFieldVariantsSize,
+	char *aOutBuffer, const size_t aOutBufferSize)
 {
+	if (aEjfp != NULL && aEjfp->encoding == EjfpEncodingCbor) {
+		int nSerialized = ejfpCborSerialize(aFieldVariants, aFieldVariantsSize, aOutBuffer, aOutBufferSize);
+
+		if (nSerialized < 0) {
+			ejfpSetErrorCode(nSerialized);
+
+			return 0;
+		}
+
+		return nSerialized;
+	}
+
+	// "mtojson" has neither fixed-point, nor binary types. Blobs would have to be encoded into a temporary string.
+	// It also ignores explicit lengths of names and strings, e.g. of deserialized fields, which are not NULL-terminated
+	for (size_t i = 0; i < aFieldVariantsSize; ++i) {
+		const int kIsSized = aFieldVariants[i].fieldNameLength != 0
+			|| (aFieldVariants[i].fieldType == EjfpFieldVariantTypeString && aFieldVariants[i].stringValueLength != 0);
+
+		if (kIsSized
+				|| (EJFP_ENABLE_FIXED && aFieldVariants[i].fieldType == EjfpFieldVariantTypeFixed)
+				|| (EJFP_ENABLE_BINARY && aFieldVariants[i].fieldType == EjfpFieldVariantTypeBinary)) {
+			return sinkSerialize(aEjfp, aFieldVariants, aFieldVariantsSize, aOutBuffer, aOutBufferSize);
+		}
+	}
+
 	const size_t kOutputArraySize = tojsonOutputArraySize(aFieldVariantsSize);
 	struct to_json outputToJsons[kOutputArraySize];
 	size_t kNSerialized = 0;
-	(void)aEjfp;
 	memset((void *)outputToJsons, 0, kOutputArraySize * sizeof(struct to_json));
 	outputToJsonInitialize(outputToJsons, aFieldVariants, aFieldVariantsSize);
+	EJFP_TRACE_MARK(aEjfp, traceMark);
 	kNSerialized = json_generate(aOutBuffer, outputToJsons, aOutBufferSize);
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseGenerate, kNSerialized, traceMark);
 
 	if (kNSerialized == 0) {
 		ejfpSetErrorCode(EjfpErrorSerializationNoMemory);
@@ -102,3 +243,82 @@ int ejfpSerialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, const size_t aF
 
 	return kNSerialized;
 }
+
+int ejfpSerialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, const size_t aFieldVariantsSize, char *aOutBuffer,
+	const size_t aOutBufferSize)
+{
+	EJFP_TRACE_MARK(aEjfp, traceMark);
+	const int kNSerialized = objectSerialize(aEjfp, aFieldVariants, aFieldVariantsSize, aOutBuffer, aOutBufferSize);
+	EJFP_TRACE_LAP(aEjfp, EjfpTracePhaseSerialize, (size_t)kNSerialized, traceMark);
+
+	return kNSerialized;
+}
+
+size_t ejfpSerializedSize(const EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize)
+{
+	size_t size = 2;  // {}
+
+	for (size_t i = 0; i < aFieldVariantsSize; ++i) {
+		char scalar[EJFP_FORMAT_SCALAR_MAX_LENGTH];
+
+		switch (aFieldVariants[i].fieldType) {
+			case EjfpFieldVariantTypeString:
+				size += aFieldVariants[i].stringValue == NULL ? 4 :
+					ejfpFormatStringLength(aFieldVariants[i].stringValue,
+					ejfpFieldVariantStringLength(&aFieldVariants[i]));
+
+				break;
+
+#if EJFP_ENABLE_BINARY
+			case EjfpFieldVariantTypeBinary:
+				size += aFieldVariants[i].binaryValue == NULL ? 4 :
+					2 + EJFP_BASE64_ENCODED_SIZE(aFieldVariants[i].binaryValueSize);
+
+				break;
+#endif  // EJFP_ENABLE_BINARY
+
+			default:
+				if (!EJFP_FIELD_TYPE_IS_ENABLED(aFieldVariants[i].fieldType)) {
+					return size;  // Unsupported fields terminate the object, see `outputToJsonInitialize`
+				}
+
+				size += ejfpFormatScalar(scalar, &aFieldVariants[i]);
+
+				break;
+		}
+
+		size += ejfpFormatStringLength(aFieldVariants[i].fieldName, ejfpFieldVariantNameLength(&aFieldVariants[i]))
+			+ 1;  // "name":
+		size += i == 0 ? 0 : 1;  // ,
+	}
+
+	return size;
+}
+
+size_t ejfpSerializedSizeUpperBound(const EjfpFieldVariant *aLayout, size_t aLayoutSize)
+{
+	size_t size = 3;  // {}, and the NULL character
+
+	for (size_t i = 0; i < aLayoutSize; ++i) {
+		size += ejfpFormatStringLength(aLayout[i].fieldName, ejfpFieldVariantNameLength(&aLayout[i])) + 1;
+		size += i == 0 ? 0 : 1;
+
+		if (aLayout[i].fieldType == EjfpFieldVariantTypeString) {
+			if (aLayout[i].stringValueLength == 0) {
+				return 0;
+			}
+
+			size += 2 + 2 * aLayout[i].stringValueLength;  // Worst case: each character is escaped
+#if EJFP_ENABLE_BINARY
+		} else if (aLayout[i].fieldType == EjfpFieldVariantTypeBinary) {
+			size += 2 + EJFP_BASE64_ENCODED_SIZE(aLayout[i].binaryValueSize);
+#endif  // EJFP_ENABLE_BINARY
+		} else {
+			size += ejfpFormatScalarMaxLength(aLayout[i].fieldType);
+		}
+	}
+
+	return size;
+}
+
+#endif  // EJFP_COMPACT
@@ -21,6 +21,25 @@ extern "C" {
 int ejfpSerialize(Ejfp *aEjfp, EjfpFieldVariant *aFieldVariants, const size_t aFieldVariantsSize,
 	char *aOut, const size_t aOutSize);
 
+#if !EJFP_COMPACT
+
+/// @brief Computes the exact output size of `ejfpSerialize` without writing anything
+///
+/// @return Output size, NULL character excluded. `ejfpSerialize` requires 1
+/// more byte for the NULL character
+size_t ejfpSerializedSize(const EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize);
+
+/// @brief Computes the worst-case output size for a key/type layout
+///
+/// @param aLayout For string fields, `stringValueLength` is the max. string
+/// length, for binary fields `binaryValueSize` is the max. blob size
+/// @return Buffer size sufficient for any message of this layout, NULL
+/// character included. 0, if a string field has `stringValueLength` 0, i.e.
+/// the size is unbounded
+size_t ejfpSerializedSizeUpperBound(const EjfpFieldVariant *aLayout, size_t aLayoutSize);
+
+#endif  // !EJFP_COMPACT
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
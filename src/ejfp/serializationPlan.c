@@ -0,0 +1,179 @@
+//
+// serializationPlan.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/base64.h"
+#include "ejfp/error.h"
+#include "ejfp/fieldVariant.h"
+#include "ejfp/format.h"
+#include "ejfp/serialization.h"
+#include "ejfp/serializationPlan.h"
+#include <string.h>
+
+#if !EJFP_COMPACT  // Requires pointer-based fields, see `EJFP_COMPACT`
+
+/// @return True, if values of the type can be serialized w/ a plan
+static int planSupports(EjfpFieldVariantType aFieldVariantType);
+
+/// @brief Appends a `{"key":` or `,"key":` fragment
+/// @return Pointer past the fragment, or NULL, if it does not fit
+static char *fragmentAppend(char *aOut, const char *aOutEnd, char aSeparator, const EjfpFieldVariant *aFieldVariant);
+
+static char *fragmentAppend(char *aOut, const char *aOutEnd, char aSeparator, const EjfpFieldVariant *aFieldVariant)
+{
+	if (aOut == aOutEnd) {
+		return NULL;
+	}
+
+	*aOut++ = aSeparator;
+	aOut = ejfpFormatString(aOut, aOutEnd, aFieldVariant->fieldName, ejfpFieldVariantNameLength(aFieldVariant));
+
+	if (aOut == NULL || aOut == aOutEnd) {
+		return NULL;
+	}
+
+	*aOut++ = ':';
+
+	return aOut;
+}
+
+static inline int planSupports(EjfpFieldVariantType aFieldVariantType)
+{
+	return aFieldVariantType == EjfpFieldVariantTypeString
+		|| (EJFP_ENABLE_BINARY && aFieldVariantType == EjfpFieldVariantTypeBinary)
+		|| ejfpFormatScalarMaxLength(aFieldVariantType) > 0;
+}
+
+int ejfpSerializationPlanCompile(EjfpSerializationPlan *aPlan, EjfpSerializationPlanEntry *aEntries,
+	size_t aEntriesSize, char *aFragmentBuffer, size_t aFragmentBufferSize, const EjfpFieldVariant *aLayout,
+	size_t aLayoutSize)
+{
+	char *out = aFragmentBuffer;
+	const char *outEnd = aFragmentBuffer + aFragmentBufferSize;
+
+	if (aEntriesSize < aLayoutSize) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	for (size_t i = 0; i < aLayoutSize; ++i) {
+		if (!planSupports(aLayout[i].fieldType)) {
+			return EjfpErrorSerializationUnsupportedType;
+		}
+	}
+
+	for (size_t i = 0; i < aLayoutSize; ++i) {
+		char *fragment = out;
+		out = fragmentAppend(out, outEnd, i == 0 ? '{' : ',', &aLayout[i]);
+
+		if (out == NULL) {
+			return EjfpErrorSerializationNoMemory;
+		}
+
+		aEntries[i].fieldType = aLayout[i].fieldType;
+		aEntries[i].fragmentOffset = fragment - aFragmentBuffer;
+		aEntries[i].fragmentLength = out - fragment;
+	}
+
+	// An empty object still has to be opened
+	if ((size_t)(outEnd - out) < (aLayoutSize == 0 ? 2 : 1)) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	aPlan->closingFragmentOffset = out - aFragmentBuffer;
+
+	if (aLayoutSize == 0) {
+		*out++ = '{';
+	}
+
+	*out++ = '}';
+	aPlan->closingFragmentLength = out - aFragmentBuffer - aPlan->closingFragmentOffset;
+	aPlan->entries = aEntries;
+	aPlan->entriesSize = aLayoutSize;
+	aPlan->fragments = aFragmentBuffer;
+	aPlan->maxOutputSize = ejfpSerializedSizeUpperBound(aLayout, aLayoutSize);
+
+	return out - aFragmentBuffer;
+}
+
+int ejfpSerializeWithPlan(const EjfpSerializationPlan *aPlan, const EjfpFieldVariant *aFieldVariants,
+	size_t aFieldVariantsSize, char *aOut, size_t aOutSize)
+{
+	char *out = aOut;
+	const char *outEnd = aOut + aOutSize;
+
+	if (aFieldVariantsSize != aPlan->entriesSize) {
+		return EjfpErrorSerializationLayoutMismatch;
+	}
+
+	for (size_t i = 0; i < aFieldVariantsSize; ++i) {
+		const EjfpSerializationPlanEntry *entry = &aPlan->entries[i];
+
+		if (aFieldVariants[i].fieldType != entry->fieldType) {
+			return EjfpErrorSerializationLayoutMismatch;
+		}
+
+		if ((size_t)(outEnd - out) < entry->fragmentLength) {
+			return EjfpErrorSerializationNoMemory;
+		}
+
+		memcpy(out, aPlan->fragments + entry->fragmentOffset, entry->fragmentLength);
+		out += entry->fragmentLength;
+
+		if (entry->fieldType == EjfpFieldVariantTypeString && aFieldVariants[i].stringValue != NULL) {
+			out = ejfpFormatString(out, outEnd, aFieldVariants[i].stringValue,
+				ejfpFieldVariantStringLength(&aFieldVariants[i]));
+
+			if (out == NULL) {
+				return EjfpErrorSerializationNoMemory;
+			}
+#if EJFP_ENABLE_BINARY
+		} else if (entry->fieldType == EjfpFieldVariantTypeBinary && aFieldVariants[i].binaryValue != NULL) {
+			if ((size_t)(outEnd - out) < 2 + EJFP_BASE64_ENCODED_SIZE(aFieldVariants[i].binaryValueSize)) {
+				return EjfpErrorSerializationNoMemory;
+			}
+
+			*out++ = '"';
+			out += ejfpBase64Encode(out, aFieldVariants[i].binaryValue, aFieldVariants[i].binaryValueSize);
+			*out++ = '"';
+#endif  // EJFP_ENABLE_BINARY
+		} else {
+			static const EjfpFieldVariant kNull = {.fieldType = EjfpFieldVariantTypeNull};
+			const int kIsNull = entry->fieldType == EjfpFieldVariantTypeString
+				|| (EJFP_ENABLE_BINARY && entry->fieldType == EjfpFieldVariantTypeBinary);
+			const EjfpFieldVariant *value = kIsNull ? &kNull : &aFieldVariants[i];
+
+			char formatted[EJFP_FORMAT_SCALAR_MAX_LENGTH];
+			const int kIsInPlace = (size_t)(outEnd - out) >= EJFP_FORMAT_SCALAR_MAX_LENGTH;  // Enough space for sure
+			const size_t kFormattedLength = ejfpFormatScalar(kIsInPlace ? out : formatted, value);
+
+			// E.g. a fixed-point value w/ too many fractional digits
+			if (kFormattedLength == 0) {
+				return EjfpErrorSerializationUnsupportedType;
+			} else if (!kIsInPlace) {
+				if ((size_t)(outEnd - out) < kFormattedLength) {
+					return EjfpErrorSerializationNoMemory;
+				}
+
+				memcpy(out, formatted, kFormattedLength);
+			}
+
+			out += kFormattedLength;
+		}
+	}
+
+	// Closing fragment and NULL character
+	if ((size_t)(outEnd - out) < aPlan->closingFragmentLength + 1) {
+		return EjfpErrorSerializationNoMemory;
+	}
+
+	memcpy(out, aPlan->fragments + aPlan->closingFragmentOffset, aPlan->closingFragmentLength);
+	out += aPlan->closingFragmentLength;
+	*out = '\0';
+
+	return out - aOut;
+}
+
+#endif  // !EJFP_COMPACT
@@ -0,0 +1,76 @@
+//
+// serializationPlan.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Compiled serialization of messages with a fixed key layout. Keys are escaped
+// and quoted once, so serializing a message only takes formatting its values.
+//
+
+#ifndef EJFP_SERIALIZATIONPLAN_H_
+#define EJFP_SERIALIZATIONPLAN_H_
+
+#include "ejfp/fieldVariant.h"
+#include <stddef.h>
+
+#if !EJFP_COMPACT  // Requires pointer-based fields, see `EJFP_COMPACT`
+
+typedef struct {
+	EjfpFieldVariantType fieldType;
+
+	/// @brief Position of the `{"key":` or `,"key":` fragment in the fragment buffer
+	size_t fragmentOffset;
+	size_t fragmentLength;
+} EjfpSerializationPlanEntry;
+
+typedef struct {
+	const EjfpSerializationPlanEntry *entries;
+	size_t entriesSize;
+
+	/// @brief Concatenated key fragments followed by the closing fragment
+	const char *fragments;
+	size_t closingFragmentOffset;
+	size_t closingFragmentLength;
+
+	/// @brief Buffer size sufficient for any message of this layout,
+	/// including the terminating NULL. 0, if unbounded (see
+	/// `ejfpSerializedSizeUpperBound`)
+	size_t maxOutputSize;
+} EjfpSerializationPlan;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @brief Compiles a key/type layout into a plan
+///
+/// @param aLayout Field names and types. For string fields, `stringValueLength`
+/// is the max. string length. If it is 0, the string length is considered
+/// unbounded, and `maxOutputSize` is set to 0. For binary fields,
+/// `binaryValueSize` is the max. blob size
+/// @param aEntries Storage for plan entries, at least `aLayoutSize` long
+/// @param aFragmentBuffer Storage for key fragments. It must outlive the plan
+///
+/// @return Fragment buffer bytes used, if succeeded.
+/// `EjfpErrorSerializationUnsupportedType`, if the layout has a field of a type
+/// which is not compiled in, or has no value, e.g. `EjfpFieldVariantTypeUninitialized`.
+/// Error code otherwise
+int ejfpSerializationPlanCompile(EjfpSerializationPlan *aPlan, EjfpSerializationPlanEntry *aEntries,
+	size_t aEntriesSize, char *aFragmentBuffer, size_t aFragmentBufferSize, const EjfpFieldVariant *aLayout,
+	size_t aLayoutSize);
+
+/// @brief Serializes values according to a plan. Field names of
+/// `aFieldVariants` are ignored, field types must match the layout
+///
+/// @return Output size, NULL character excluded, if succeeded. Error code otherwise
+int ejfpSerializeWithPlan(const EjfpSerializationPlan *aPlan, const EjfpFieldVariant *aFieldVariants,
+	size_t aFieldVariantsSize, char *aOut, size_t aOutSize);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // !EJFP_COMPACT
+
+#endif  // EJFP_SERIALIZATIONPLAN_H_
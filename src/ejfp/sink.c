@@ -0,0 +1,286 @@
+//
+// sink.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/base64.h"
+#include "ejfp/error.h"
+#include "ejfp/fieldVariant.h"
+#include "ejfp/format.h"
+#include "ejfp/sink.h"
+#include <string.h>
+
+/// @brief Max. number of bytes checksummed at once. Short writes are batched, as
+/// per-write updates are slower on short tokens, and a batch is folded while it is
+/// still in cache
+#define SINK_CRC_BATCH_SIZE 256
+
+/// @brief Folds the bytes written since the last fold into the CRC register,
+/// if there are at least `aMin` of them
+static void sinkCrcFold(EjfpSink *aSink, size_t aMin);
+
+/// @brief Writes an escaped and quoted string run by run
+static int sinkWriteString(EjfpSink *aSink, const char *aString, size_t aStringLength);
+
+/// @return First occurrence of the character, or `aEnd`
+static const char *sinkFind(const char *aBegin, const char *aEnd, char aCharacter);
+
+#if EJFP_ENABLE_BINARY
+/// @brief Writes a quoted base64 string. Blobs are encoded right into the
+/// scratch buffer, a flush at a time
+static int sinkWriteBase64(EjfpSink *aSink, const uint8_t *aData, size_t aDataSize);
+#endif  // EJFP_ENABLE_BINARY
+
+static inline void sinkCrcFold(EjfpSink *aSink, size_t aMin)
+{
+	if (aSink->crc != NULL && aSink->bufferUsed - aSink->crcUsed >= aMin) {
+		aSink->crcRegister = ejfpCrcUpdate(aSink->crc, aSink->crcRegister, aSink->buffer + aSink->crcUsed,
+			aSink->bufferUsed - aSink->crcUsed);
+		aSink->crcUsed = aSink->bufferUsed;
+	}
+}
+
+static int sinkWriteString(EjfpSink *aSink, const char *aString, size_t aStringLength)
+{
+	const char *end = aString + aStringLength;
+	const char *quote = sinkFind(aString, end, '"');
+	const char *backslash = sinkFind(aString, end, '\\');
+	int error = ejfpSinkWrite(aSink, "\"", 1);
+
+	while (EjfpOk == error && aString != end) {
+		const char *runEnd = quote < backslash ? quote : backslash;
+		error = ejfpSinkWrite(aSink, aString, runEnd - aString);
+		aString = runEnd;
+
+		if (EjfpOk == error && aString != end) {
+			const char escaped[2] = {'\\', *aString++};
+			error = ejfpSinkWrite(aSink, escaped, 2);
+
+			// Only the one consumed is looked up again
+			if (runEnd == quote) {
+				quote = sinkFind(aString, end, '"');
+			} else {
+				backslash = sinkFind(aString, end, '\\');
+			}
+		}
+	}
+
+	if (EjfpOk == error) {
+		error = ejfpSinkWrite(aSink, "\"", 1);
+	}
+
+	return error;
+}
+
+static inline const char *sinkFind(const char *aBegin, const char *aEnd, char aCharacter)
+{
+	const char *found = (const char *)memchr(aBegin, aCharacter, aEnd - aBegin);
+
+	return found == NULL ? aEnd : found;
+}
+
+#if EJFP_ENABLE_BINARY
+
+static int sinkWriteBase64(EjfpSink *aSink, const uint8_t *aData, size_t aDataSize)
+{
+	int error = ejfpSinkWrite(aSink, "\"", 1);
+
+	while (EjfpOk == error && aDataSize >= 3) {
+		size_t nTriples = (aSink->bufferSize - aSink->bufferUsed) / 4;
+
+		if (nTriples == 0) {
+			// Not even a quad fits, and it cannot be split
+			char quad[4];
+			ejfpBase64Encode(quad, aData, 3);
+			error = ejfpSinkWrite(aSink, quad, 4);
+			nTriples = 1;
+		} else {
+			if (nTriples > aDataSize / 3) {
+				nTriples = aDataSize / 3;
+			}
+
+			if (aSink->crc != NULL && nTriples > SINK_CRC_BATCH_SIZE / 4) {
+				nTriples = SINK_CRC_BATCH_SIZE / 4;
+			}
+
+			ejfpBase64Encode(aSink->buffer + aSink->bufferUsed, aData, nTriples * 3);
+			aSink->bufferUsed += nTriples * 4;
+			aSink->total += nTriples * 4;
+			sinkCrcFold(aSink, SINK_CRC_BATCH_SIZE);
+		}
+
+		aData += nTriples * 3;
+		aDataSize -= nTriples * 3;
+	}
+
+	if (EjfpOk == error && aDataSize > 0) {
+		char quad[4];
+		ejfpBase64Encode(quad, aData, aDataSize);
+		error = ejfpSinkWrite(aSink, quad, 4);
+	}
+
+	if (EjfpOk == error) {
+		error = ejfpSinkWrite(aSink, "\"", 1);
+	}
+
+	return error;
+}
+
+#endif  // EJFP_ENABLE_BINARY
+
+void ejfpSinkInitialize(EjfpSink *aSink, char *aBuffer, size_t aBufferSize, EjfpSinkFlush aFlush, void *aContext)
+{
+	aSink->buffer = aBuffer;
+	aSink->bufferSize = aBufferSize;
+	aSink->bufferUsed = 0;
+	aSink->flush = aFlush;
+	aSink->context = aContext;
+	aSink->total = 0;
+	aSink->crc = NULL;
+}
+
+void ejfpSinkSetCrc(EjfpSink *aSink, const EjfpCrc *aCrc)
+{
+	aSink->crc = aCrc;
+	aSink->crcUsed = aSink->bufferUsed;
+
+	if (aCrc != NULL) {
+		aSink->crcRegister = ejfpCrcStart(aCrc);
+	}
+}
+
+uint32_t ejfpSinkCrc(const EjfpSink *aSink)
+{
+	// Only the last batch, which is shorter than `SINK_CRC_BATCH_SIZE`, is left
+	return ejfpCrcFinish(aSink->crc, ejfpCrcUpdate(aSink->crc, aSink->crcRegister, aSink->buffer + aSink->crcUsed,
+		aSink->bufferUsed - aSink->crcUsed));
+}
+
+int ejfpSinkWrite(EjfpSink *aSink, const char *aData, size_t aDataSize)
+{
+	while (aDataSize > 0) {
+		size_t chunkSize = aSink->bufferSize - aSink->bufferUsed;
+
+		if (chunkSize == 0) {
+			int error = ejfpSinkFlush(aSink);
+
+			if (EjfpOk != error) {
+				return error;
+			}
+
+			chunkSize = aSink->bufferSize;
+
+			// A flushed sink w/o a buffer would never make progress
+			if (chunkSize == 0) {
+				return EjfpErrorSerializationNoMemory;
+			}
+		}
+
+		if (chunkSize > aDataSize) {
+			chunkSize = aDataSize;
+		}
+
+		if (aSink->crc != NULL && chunkSize > SINK_CRC_BATCH_SIZE) {
+			chunkSize = SINK_CRC_BATCH_SIZE;
+		}
+
+		memcpy(aSink->buffer + aSink->bufferUsed, aData, chunkSize);
+		aSink->bufferUsed += chunkSize;
+		aSink->total += chunkSize;
+		aData += chunkSize;
+		aDataSize -= chunkSize;
+		sinkCrcFold(aSink, SINK_CRC_BATCH_SIZE);
+	}
+
+	return EjfpOk;
+}
+
+int ejfpSinkFlush(EjfpSink *aSink)
+{
+	if (aSink->flush == NULL) {
+		return aSink->bufferUsed < aSink->bufferSize ? EjfpOk : EjfpErrorSerializationNoMemory;
+	}
+
+	sinkCrcFold(aSink, 0);
+
+	if (aSink->bufferUsed > 0 && aSink->flush(aSink->context, aSink->buffer, aSink->bufferUsed) != 0) {
+		return EjfpErrorSerializationSink;
+	}
+
+	aSink->bufferUsed = 0;
+	aSink->crcUsed = 0;
+
+	return EjfpOk;
+}
+
+int ejfpSerializeToSink(Ejfp *aEjfp, const EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize,
+	EjfpSink *aSink)
+{
+	const size_t kTotalStart = aSink->total;
+	(void)aEjfp;  // Only used by the accessors in compact mode
+
+#if EJFP_COMPACT
+	// Offsets cannot be resolved, while the default layout works w/o an instance
+	if (aEjfp == NULL || aEjfp->base == NULL) {
+		return EjfpErrorSerializationNoBase;
+	}
+#endif  // EJFP_COMPACT
+
+	int error = ejfpSinkWrite(aSink, "{", 1);
+
+	for (size_t i = 0; EjfpOk == error && i < aFieldVariantsSize; ++i) {
+		const EjfpFieldVariant *fieldVariant = &aFieldVariants[i];
+		char scalar[EJFP_FORMAT_SCALAR_MAX_LENGTH];
+		size_t scalarLength = ejfpFormatScalar(scalar, fieldVariant);
+
+		// Unsupported fields terminate the object, as they do in `ejfpSerialize`
+		if (scalarLength == 0 && fieldVariant->fieldType != EjfpFieldVariantTypeString
+				&& !(EJFP_ENABLE_BINARY && fieldVariant->fieldType == EjfpFieldVariantTypeBinary)) {
+			break;
+		}
+
+		if (i > 0) {
+			error = ejfpSinkWrite(aSink, ",", 1);
+		}
+
+		if (EjfpOk == error) {
+			error = sinkWriteString(aSink, EJFP_FIELD_NAME(aEjfp->base, fieldVariant),
+				ejfpFieldVariantNameLength(fieldVariant));
+		}
+
+		if (EjfpOk == error) {
+			error = ejfpSinkWrite(aSink, ":", 1);
+		}
+
+		if (EjfpOk != error) {
+			break;
+		}
+
+		if (scalarLength > 0) {
+			error = ejfpSinkWrite(aSink, scalar, scalarLength);
+#if !EJFP_COMPACT
+		} else if (fieldVariant->stringValue == NULL) {
+			error = ejfpSinkWrite(aSink, "null", 4);
+#endif
+#if EJFP_ENABLE_BINARY
+		} else if (fieldVariant->fieldType == EjfpFieldVariantTypeBinary) {
+			error = sinkWriteBase64(aSink, fieldVariant->binaryValue, fieldVariant->binaryValueSize);
+#endif
+		} else {
+			error = sinkWriteString(aSink, EJFP_FIELD_STRING(aEjfp->base, fieldVariant),
+				ejfpFieldVariantStringLength(fieldVariant));
+		}
+	}
+
+	if (EjfpOk == error) {
+		error = ejfpSinkWrite(aSink, "}", 1);
+	}
+
+	if (EjfpOk == error && aSink->flush != NULL) {
+		error = ejfpSinkFlush(aSink);
+	}
+
+	return EjfpOk == error ? (int)(aSink->total - kTotalStart) : error;
+}
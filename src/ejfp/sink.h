@@ -0,0 +1,84 @@
+//
+// sink.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Streaming serialization. Output is accumulated in a small fixed scratch
+// buffer which is handed over to a user callback each time it fills up, so
+// peak RAM does not depend on the message size.
+//
+
+#ifndef EJFP_SINK_H_
+#define EJFP_SINK_H_
+
+#include "ejfp/crc.h"
+#include "ejfp/ejfp.h"
+#include "ejfp/fieldVariant.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief Consumes a chunk of serialized output
+/// @return 0, if succeeded. Non-zero value aborts serialization
+typedef int (*EjfpSinkFlush)(void *aContext, const char *aData, size_t aDataSize);
+
+typedef struct {
+	char *buffer;
+	size_t bufferSize;
+	size_t bufferUsed;
+
+	/// @brief If NULL, the sink writes into `buffer` contiguously, and fails
+	/// once it is full
+	EjfpSinkFlush flush;
+	void *context;
+
+	/// @brief Total number of bytes written into the sink
+	size_t total;
+
+	/// @brief May be NULL, see `ejfpSinkSetCrc`
+	const EjfpCrc *crc;
+	uint32_t crcRegister;
+
+	/// @brief Leading bytes of the buffer which are already fed into the
+	/// register, or precede `ejfpSinkSetCrc`
+	size_t crcUsed;
+} EjfpSink;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+void ejfpSinkInitialize(EjfpSink *aSink, char *aBuffer, size_t aBufferSize, EjfpSinkFlush aFlush, void *aContext);
+
+/// @brief Appends bytes, flushes the scratch buffer as many times as needed
+/// @return `EjfpOk`, if succeeded. `EjfpErrorSerializationNoMemory`, if the
+/// buffer is full, and there is no flush callback, or the buffer is 0 bytes
+/// long. Error code otherwise
+int ejfpSinkWrite(EjfpSink *aSink, const char *aData, size_t aDataSize);
+
+/// @brief Checksums the bytes written from now on. Writes are folded into the
+/// checksum in batches of up to 256 bytes, while they are still in cache
+///
+/// @param aCrc NULL disables the checksum
+void ejfpSinkSetCrc(EjfpSink *aSink, const EjfpCrc *aCrc);
+
+/// @return Checksum of the bytes written since `ejfpSinkSetCrc`
+uint32_t ejfpSinkCrc(const EjfpSink *aSink);
+
+/// @brief Hands over whatever is left in the scratch buffer
+/// @return `EjfpOk`, if succeeded. Error code otherwise
+int ejfpSinkFlush(EjfpSink *aSink);
+
+/// @brief Serializes fields into a sink, and flushes it. The output is the
+/// same as that of `ejfpSerialize`, except that it is not NULL-terminated
+///
+/// @param aEjfp May be NULL. In compact mode, it must have a base, see `ejfpSetBase`
+/// @return Output size, if succeeded. Error code otherwise
+int ejfpSerializeToSink(Ejfp *aEjfp, const EjfpFieldVariant *aFieldVariants, size_t aFieldVariantsSize,
+	EjfpSink *aSink);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // EJFP_SINK_H_
@@ -0,0 +1,267 @@
+//
+// stream.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/deserialization.h"
+#include "ejfp/error.h"
+#include "ejfp/stream.h"
+#include <stdint.h>
+#include <string.h>
+
+typedef enum {
+	ScanIncomplete = 0,
+	ScanComplete,
+
+	/// @brief Recovery mode only, see `ejfpStreamSetRecovery`
+	ScanCorrupted,
+} ScanResult;
+
+static int isWhitespace(char aCharacter)
+{
+	return aCharacter == ' ' || aCharacter == '\t' || aCharacter == '\n' || aCharacter == '\r';
+}
+
+/// @brief Advances the framer over [scanned; end)
+/// @param aPosition Receives the position of the closing brace, or that of
+/// the byte the corruption has been detected at
+static ScanResult streamScan(EjfpStream *aStream, size_t *aPosition);
+
+/// @brief Finds the first '{' or '\n' 8 bytes at a time (SWAR)
+/// @return `aSize`, if there is none
+static size_t frameStartFind(const char *aData, size_t aSize);
+
+/// @brief Drops [begin; aPosition), and restarts framing there
+static void streamSkip(EjfpStream *aStream, size_t aPosition);
+
+/// @brief Moves unconsumed bytes to the front of the buffer
+static void streamCompact(EjfpStream *aStream);
+
+static ScanResult streamScan(EjfpStream *aStream, size_t *aPosition)
+{
+	size_t position = aStream->scanned;
+	ScanResult result = ScanIncomplete;
+
+	for (; position < aStream->end; ++position) {
+		const char character = aStream->buffer[position];
+
+		if (aStream->isInString) {
+			if (aStream->isEscaped) {
+				aStream->isEscaped = 0;
+			} else if (character == '\\') {
+				aStream->isEscaped = 1;
+			} else if (character == '"') {
+				aStream->isInString = 0;
+			} else if (character == '\n' && aStream->isRecovering) {
+				result = ScanCorrupted;
+
+				break;
+			}
+		} else if (character == '"') {
+			aStream->isInString = 1;
+		} else if (character == '{') {
+			if (aStream->depth > 0 && aStream->isRecovering) {
+				result = ScanCorrupted;
+
+				break;
+			}
+
+			++aStream->depth;
+		} else if (character == '}' && --aStream->depth == 0) {
+			result = ScanComplete;
+
+			break;
+		}
+	}
+
+	aStream->scanned = position;
+	*aPosition = position;
+
+	return result;
+}
+
+static size_t frameStartFind(const char *aData, size_t aSize)
+{
+	static const uint64_t kOnes = 0x0101010101010101ull;
+	static const uint64_t kHighs = 0x8080808080808080ull;
+	size_t i = 0;
+
+	for (; i + sizeof(uint64_t) <= aSize; i += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, aData + i, sizeof(word));
+		const uint64_t kBraces = word ^ (kOnes * '{');
+		const uint64_t kNewlines = word ^ (kOnes * '\n');
+
+		// A byte is zero, if the high bit survives. False positives only follow true ones
+		if ((((kBraces - kOnes) & ~kBraces) | ((kNewlines - kOnes) & ~kNewlines)) & kHighs) {
+			break;
+		}
+	}
+
+	for (; i < aSize && aData[i] != '{' && aData[i] != '\n'; ++i) {
+	}
+
+	return i;
+}
+
+static void streamSkip(EjfpStream *aStream, size_t aPosition)
+{
+	aStream->nSkipped += aPosition - aStream->begin;
+	aStream->begin = aPosition;
+	aStream->scanned = aPosition;
+	aStream->depth = 0;
+	aStream->isInString = 0;
+	aStream->isEscaped = 0;
+}
+
+static void streamCompact(EjfpStream *aStream)
+{
+	const size_t kSize = aStream->end - aStream->begin;
+	memmove(aStream->buffer, aStream->buffer + aStream->begin, kSize);
+	aStream->scanned -= aStream->begin;
+	aStream->end = kSize;
+	aStream->begin = 0;
+}
+
+void ejfpStreamInitialize(EjfpStream *aStream, char *aBuffer, size_t aBufferSize)
+{
+	aStream->buffer = aBuffer;
+	aStream->bufferSize = aBufferSize;
+	aStream->begin = 0;
+	aStream->end = 0;
+	aStream->scanned = 0;
+	aStream->depth = 0;
+	aStream->isInString = 0;
+	aStream->isEscaped = 0;
+	aStream->isDropping = 0;
+	aStream->isRecovering = 0;
+	aStream->nSkipped = 0;
+}
+
+void ejfpStreamSetRecovery(EjfpStream *aStream, int aIsEnabled)
+{
+	aStream->isRecovering = aIsEnabled;
+}
+
+size_t ejfpStreamSkipped(const EjfpStream *aStream)
+{
+	return aStream->nSkipped;
+}
+
+char *ejfpStreamReserve(EjfpStream *aStream, size_t *aSize)
+{
+	// Amortized: bytes are moved only when the free tail is shorter than the consumed head
+	if (aStream->begin > 0 && aStream->bufferSize - aStream->end <= aStream->begin) {
+		streamCompact(aStream);
+	}
+
+	*aSize = aStream->bufferSize - aStream->end;
+
+	return aStream->buffer + aStream->end;
+}
+
+void ejfpStreamCommit(EjfpStream *aStream, size_t aSize)
+{
+	aStream->end += aSize;
+}
+
+size_t ejfpStreamFeed(EjfpStream *aStream, const char *aData, size_t aSize)
+{
+	size_t freeSize = 0;
+	char *free = ejfpStreamReserve(aStream, &freeSize);
+
+	if (aSize > freeSize) {
+		aSize = freeSize;
+	}
+
+	memcpy(free, aData, aSize);
+	ejfpStreamCommit(aStream, aSize);
+
+	return aSize;
+}
+
+int ejfpStreamNext(EjfpStream *aStream, Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray,
+	size_t aFieldVariantArraySize)
+{
+	for (;;) {
+		if (aStream->depth == 0) {
+			while (aStream->begin < aStream->end && isWhitespace(aStream->buffer[aStream->begin])) {
+				++aStream->begin;
+			}
+
+			aStream->scanned = aStream->begin;
+
+			if (aStream->begin == aStream->end) {
+				return EjfpErrorDeserializationPartitioned;
+			}
+
+			if (aStream->buffer[aStream->begin] != '{') {
+				if (!aStream->isRecovering) {
+					streamSkip(aStream, aStream->begin + 1);
+
+					return EjfpErrorDeserializationInvalidSyntax;
+				}
+
+				streamSkip(aStream, aStream->begin + 1 + frameStartFind(aStream->buffer + aStream->begin + 1,
+					aStream->end - aStream->begin - 1));
+
+				continue;
+			}
+		}
+
+		size_t position = 0;
+		const ScanResult kScanResult = streamScan(aStream, &position);
+
+		if (kScanResult == ScanCorrupted) {
+			// Restart at the '{', or past the newline
+			const int kIsReported = aStream->isDropping;
+			streamSkip(aStream, aStream->buffer[position] == '{' ? position : position + 1);
+			aStream->isDropping = 0;
+
+			if (!kIsReported) {
+				return EjfpErrorDeserializationInvalidSyntax;
+			}
+
+			continue;
+		} else if (kScanResult == ScanIncomplete) {
+			if (aStream->isDropping || (aStream->begin == 0 && aStream->end == aStream->bufferSize)) {
+				// Discard the received part of the object, but keep tracking it, so its tail is dropped too
+				const int kIsReported = aStream->isDropping;
+				aStream->nSkipped += aStream->end - aStream->begin;
+				aStream->begin = 0;
+				aStream->end = 0;
+				aStream->scanned = 0;
+				aStream->isDropping = 1;
+
+				if (!kIsReported) {
+					return EjfpErrorDeserializationNoMemory;
+				}
+			}
+
+			return EjfpErrorDeserializationPartitioned;
+		}
+
+		const char *frame = aStream->buffer + aStream->begin;
+		const size_t kFrameSize = position + 1 - aStream->begin;
+
+		if (aStream->isDropping) {
+			streamSkip(aStream, position + 1);
+			aStream->isDropping = 0;
+
+			continue;
+		}
+
+		aStream->begin = position + 1;
+		aStream->scanned = aStream->begin;
+		ejfpReset(aEjfp);  // Drop the state left by a previous object
+		const int kResult = ejfpDeserialize(aEjfp, aFieldVariantArray, aFieldVariantArraySize, frame, kFrameSize);
+
+		if (kResult < 0) {
+			aStream->nSkipped += kFrameSize;
+		}
+
+		return kResult;
+	}
+}
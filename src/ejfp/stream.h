@@ -0,0 +1,101 @@
+//
+// stream.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Framing of a byte stream, e.g. a TCP connection or a UART, into JSON
+// objects. Bytes are accumulated in a caller-provided buffer. The framer
+// tracks brace depth and string state across chunks, so every byte is
+// scanned once regardless of how the input is split.
+//
+
+#ifndef EJFP_STREAM_H_
+#define EJFP_STREAM_H_
+
+#include "ejfp/ejfp.h"
+#include "ejfp/fieldVariant.h"
+#include <stddef.h>
+
+/// @brief Framer state. Treat as opaque
+typedef struct {
+	char *buffer;
+	size_t bufferSize;
+
+	/// @brief Start of unconsumed bytes
+	size_t begin;
+
+	/// @brief End of received bytes
+	size_t end;
+
+	/// @brief [begin; scanned) has been scanned by the framer
+	size_t scanned;
+
+	int depth;
+	int isInString;
+	int isEscaped;
+
+	/// @brief The current object has not fit into the buffer, and is being skipped
+	int isDropping;
+
+	/// @brief See `ejfpStreamSetRecovery`
+	int isRecovering;
+
+	/// @brief Number of bytes dropped so far, see `ejfpStreamSkipped`
+	size_t nSkipped;
+} EjfpStream;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+void ejfpStreamInitialize(EjfpStream *aStream, char *aBuffer, size_t aBufferSize);
+
+/// @brief Enables resynchronization for noisy links. Stray bytes between
+/// objects are skipped up to the next newline or '{' at once, w/o reporting
+/// each of them. Inside an object, a '{' (nested objects are not supported),
+/// or a raw newline in a string (JSON requires it to be escaped) is taken for
+/// a corruption: the object is dropped, and framing restarts at the '{', or
+/// after the newline respectively. Works best w/ newline-delimited objects
+void ejfpStreamSetRecovery(EjfpStream *aStream, int aIsEnabled);
+
+/// @brief Number of bytes dropped as stray or belonging to malformed or
+/// oversized objects
+size_t ejfpStreamSkipped(const EjfpStream *aStream);
+
+/// @brief Provides free space for incoming bytes, e.g. for `recv`. Moves
+/// unconsumed bytes to the front of the buffer, when necessary
+///
+/// @param aSize Receives the size of free space. 0 means that the buffer is
+/// occupied by an incomplete object
+char *ejfpStreamReserve(EjfpStream *aStream, size_t *aSize);
+
+/// @brief Accounts for `aSize` bytes written into the space provided by
+/// `ejfpStreamReserve`
+void ejfpStreamCommit(EjfpStream *aStream, size_t aSize);
+
+/// @brief Copies bytes into the stream
+///
+/// @return Number of bytes accepted
+size_t ejfpStreamFeed(EjfpStream *aStream, const char *aData, size_t aSize);
+
+/// @brief Extracts and deserializes the next complete object. Fields refer to
+/// the stream's buffer and stay valid until the next call of any `ejfpStream*`
+/// function
+///
+/// @return Number of filled `EjfpFieldVariant` instances.
+/// `EjfpErrorDeserializationPartitioned`, if more bytes are needed.
+/// `EjfpErrorDeserializationNoMemory`, if an object does not fit into the
+/// buffer; the incomplete object is dropped. Other error codes, if an object
+/// is malformed; the object (or a stray byte outside of an object) is dropped,
+/// so the next call proceeds with the following bytes. In recovery mode,
+/// stray bytes are skipped silently, and a corrupted object is reported once,
+/// see `ejfpStreamSetRecovery`
+int ejfpStreamNext(EjfpStream *aStream, Ejfp *aEjfp, EjfpFieldVariant *aFieldVariantArray,
+	size_t aFieldVariantArraySize);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // EJFP_STREAM_H_
@@ -0,0 +1,161 @@
+//
+// trace.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// Buckets are log-linear: the position of the highest bit, and the 2 bits
+// right below it, so recording a measurement takes no division.
+//
+
+#include "ejfp/trace.h"
+#include <string.h>
+
+#if EJFP_TRACE
+
+/// @return Position of the highest set bit. `aValue` must not be 0
+static unsigned highestBit(uint32_t aValue);
+
+static inline unsigned highestBit(uint32_t aValue)
+{
+#if defined(__GNUC__)
+	return 31 - (unsigned)__builtin_clz(aValue);
+#else
+	unsigned position = 0;
+
+	while (aValue >>= 1) {
+		++position;
+	}
+
+	return position;
+#endif  // defined(__GNUC__)
+}
+
+void ejfpTraceInitialize(EjfpTrace *aTrace, EjfpTraceClock aClock)
+{
+	aTrace->clock = aClock;
+	aTrace->hook = NULL;
+	aTrace->hookContext = NULL;
+
+	for (size_t i = 0; i < EjfpTracePhaseN; ++i) {
+		aTrace->histograms[i] = NULL;
+	}
+}
+
+void ejfpTraceSetHook(EjfpTrace *aTrace, EjfpTraceHook aHook, void *aContext)
+{
+	aTrace->hook = aHook;
+	aTrace->hookContext = aContext;
+}
+
+void ejfpTraceSetHistogram(EjfpTrace *aTrace, EjfpTracePhase aPhase, EjfpTraceHistogram *aHistogram)
+{
+	aTrace->histograms[aPhase] = aHistogram;
+}
+
+void ejfpTraceHistogramReset(EjfpTraceHistogram *aHistogram)
+{
+	memset(aHistogram, 0, sizeof(*aHistogram));
+}
+
+uint32_t ejfpTraceNow(const EjfpTrace *aTrace)
+{
+	return aTrace != NULL ? aTrace->clock() : 0;
+}
+
+void ejfpTraceRecord(const EjfpTrace *aTrace, EjfpTracePhase aPhase, size_t aMessageSize, uint32_t aTicks)
+{
+	if (aTrace == NULL) {
+		return;
+	}
+
+	if (aTrace->hook != NULL) {
+		aTrace->hook(aTrace->hookContext, aPhase, aMessageSize, aTicks);
+	}
+
+	EjfpTraceHistogram *histogram = aTrace->histograms[aPhase];
+
+	if (histogram != NULL) {
+		const size_t kSizeClass = ejfpTraceSizeClass(aMessageSize);
+		++histogram->counts[kSizeClass][ejfpTraceBucket(aTicks)];
+
+		if (aTicks > histogram->max[kSizeClass]) {
+			histogram->max[kSizeClass] = aTicks;
+		}
+	}
+}
+
+const char *ejfpTracePhaseName(EjfpTracePhase aPhase)
+{
+	static const char *const kNames[EjfpTracePhaseN] = {"tokenize", "validate", "parse", "generate", "deserialize",
+		"serialize"};
+
+	return aPhase < EjfpTracePhaseN ? kNames[aPhase] : "";
+}
+
+size_t ejfpTraceSizeClass(size_t aMessageSize)
+{
+	if (aMessageSize < 64) {
+		return 0;
+	} else if (aMessageSize >= ejfpTraceSizeClassMin(EJFP_TRACE_SIZE_CLASSES - 1)) {
+		return EJFP_TRACE_SIZE_CLASSES - 1;
+	}
+
+	return (highestBit((uint32_t)aMessageSize) - 4) / 2;  // x4 per class
+}
+
+size_t ejfpTraceSizeClassMin(size_t aSizeClass)
+{
+	return aSizeClass == 0 ? 0 : (size_t)16 << (2 * aSizeClass);
+}
+
+size_t ejfpTraceBucket(uint32_t aTicks)
+{
+	if (aTicks < 4) {
+		return aTicks;
+	}
+
+	const unsigned kPosition = highestBit(aTicks);
+
+	return (kPosition - 1) * 4 + ((aTicks >> (kPosition - 2)) & 3);
+}
+
+uint32_t ejfpTraceBucketMin(size_t aBucket)
+{
+	return aBucket < 4 ? (uint32_t)aBucket : (uint32_t)(4 + aBucket % 4) << (aBucket / 4 - 1);
+}
+
+uint32_t ejfpTraceHistogramCount(const EjfpTraceHistogram *aHistogram, size_t aSizeClass)
+{
+	uint32_t count = 0;
+
+	for (size_t i = 0; i < EJFP_TRACE_BUCKETS; ++i) {
+		count += aHistogram->counts[aSizeClass][i];
+	}
+
+	return count;
+}
+
+uint32_t ejfpTraceHistogramPercentile(const EjfpTraceHistogram *aHistogram, size_t aSizeClass, unsigned aPermille)
+{
+	const uint32_t kCount = ejfpTraceHistogramCount(aHistogram, aSizeClass);
+	const uint32_t kMax = aHistogram->max[aSizeClass];
+
+	// Rank of the measurement, rounded up
+	uint64_t rank = ((uint64_t)kCount * aPermille + 999) / 1000;
+	rank = rank == 0 ? 1 : rank;
+
+	for (size_t i = 0; i < EJFP_TRACE_BUCKETS && kCount > 0; ++i) {
+		if (rank <= aHistogram->counts[aSizeClass][i]) {
+			const uint32_t kUpper = i + 1 < EJFP_TRACE_BUCKETS ? ejfpTraceBucketMin(i + 1) - 1 : UINT32_MAX;
+
+			return kUpper < kMax ? kUpper : kMax;
+		}
+
+		rank -= aHistogram->counts[aSizeClass][i];
+	}
+
+	return 0;
+}
+
+#endif  // EJFP_TRACE
@@ -0,0 +1,147 @@
+//
+// trace.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Latency tracing of `ejfpSerialize` and `ejfpDeserialize`, see `EJFP_TRACE`.
+// Each call, and each of its phases, is timed by a caller-provided clock, and
+// passed to a hook, and/or counted in a histogram split by message size. The
+// clock returns ticks of any unit which wrap at 32 bits, e.g.:
+//
+//     uint32_t clockMonotonic(void)  // Nanoseconds
+//     {
+//         struct timespec time;
+//         clock_gettime(CLOCK_MONOTONIC, &time);
+//
+//         return (uint32_t)((uint64_t)time.tv_sec * 1000000000u + time.tv_nsec);
+//     }
+//
+//     uint32_t clockTsc(void) { return (uint32_t)__rdtsc(); }  // x86 cycles
+//     uint32_t clockDwt(void) { return DWT->CYCCNT; }  // Cortex-M cycles
+//
+// so a single call may take up to 2^32 ticks.
+//
+
+#ifndef EJFP_TRACE_H_
+#define EJFP_TRACE_H_
+
+#include "ejfp/config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#if EJFP_TRACE
+
+/// @brief Message sizes: < 64 B, < 256 B, < 1 KiB, < 4 KiB, < 16 KiB, and more
+#define EJFP_TRACE_SIZE_CLASSES 6
+
+/// @brief Ticks: 0 to 3 exactly, then 4 buckets per power of 2, i.e. within
+/// 25 %, up to 2^32
+#define EJFP_TRACE_BUCKETS 124
+
+typedef enum {
+	EjfpTracePhaseTokenize = 0,  ///< "jsmn"
+	EjfpTracePhaseValidate,  ///< Structure check of the tokens
+	EjfpTracePhaseParse,  ///< Value conversion. The whole walk on the shape cache and trusted paths
+	EjfpTracePhaseGenerate,  ///< "mtojson"
+	EjfpTracePhaseDeserialize,  ///< Whole `ejfpDeserialize` call
+	EjfpTracePhaseSerialize,  ///< Whole `ejfpSerialize` call
+	EjfpTracePhaseN,
+} EjfpTracePhase;
+
+typedef uint32_t (*EjfpTraceClock)(void);
+
+/// @param aMessageSize Input size for deserialization, output size for
+/// serialization
+typedef void (*EjfpTraceHook)(void *aContext, EjfpTracePhase aPhase, size_t aMessageSize, uint32_t aTicks);
+
+typedef struct {
+	uint32_t counts[EJFP_TRACE_SIZE_CLASSES][EJFP_TRACE_BUCKETS];
+	uint32_t max[EJFP_TRACE_SIZE_CLASSES];
+} EjfpTraceHistogram;
+
+/// @brief Set by `ejfpSetTrace`. May be shared by instances
+typedef struct {
+	EjfpTraceClock clock;
+	EjfpTraceHook hook;
+	void *hookContext;
+
+	/// @brief Caller-provided, NULL if a phase is not counted
+	EjfpTraceHistogram *histograms[EjfpTracePhaseN];
+} EjfpTrace;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @brief Initializes a trace w/o a hook, and w/o histograms
+void ejfpTraceInitialize(EjfpTrace *aTrace, EjfpTraceClock aClock);
+
+/// @brief Invokes the hook on every timed phase. NULL disables it
+void ejfpTraceSetHook(EjfpTrace *aTrace, EjfpTraceHook aHook, void *aContext);
+
+/// @brief Counts a phase in the histogram. It is not reset. NULL stops counting
+void ejfpTraceSetHistogram(EjfpTrace *aTrace, EjfpTracePhase aPhase, EjfpTraceHistogram *aHistogram);
+
+void ejfpTraceHistogramReset(EjfpTraceHistogram *aHistogram);
+
+/// @return Clock reading, 0 if the trace is NULL
+uint32_t ejfpTraceNow(const EjfpTrace *aTrace);
+
+/// @brief Passes a measurement to the hook and the histogram. Failed calls
+/// are recorded as well. Phases a call does not go through, e.g. tokenization
+/// on the trusted path, are not
+///
+/// @param aTrace May be NULL
+void ejfpTraceRecord(const EjfpTrace *aTrace, EjfpTracePhase aPhase, size_t aMessageSize, uint32_t aTicks);
+
+/// @return Short name, e.g. "tokenize"
+const char *ejfpTracePhaseName(EjfpTracePhase aPhase);
+
+size_t ejfpTraceSizeClass(size_t aMessageSize);
+
+/// @return Smallest message size of the class
+size_t ejfpTraceSizeClassMin(size_t aSizeClass);
+
+size_t ejfpTraceBucket(uint32_t aTicks);
+
+/// @return Smallest number of ticks of the bucket
+uint32_t ejfpTraceBucketMin(size_t aBucket);
+
+/// @return Number of measurements of the size class
+uint32_t ejfpTraceHistogramCount(const EjfpTraceHistogram *aHistogram, size_t aSizeClass);
+
+/// @brief Percentile, e.g. p99 for `aPermille` = 990. The value is the upper
+/// bound of the bucket the measurement falls into, but never exceeds the
+/// maximum
+///
+/// @return Ticks. 0, if there are no measurements
+uint32_t ejfpTraceHistogramPercentile(const EjfpTraceHistogram *aHistogram, size_t aSizeClass, unsigned aPermille);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+// Instrumentation of the library's own phases. `aEjfp` may be NULL
+
+#define EJFP_TRACE_OF(aEjfp) ((aEjfp) != NULL ? (aEjfp)->trace : NULL)
+
+/// @brief Declares a clock reading
+#define EJFP_TRACE_MARK(aEjfp, aMark) uint32_t aMark = ejfpTraceNow(EJFP_TRACE_OF(aEjfp))
+
+/// @brief Records the ticks since the mark, and moves the mark, so phases
+/// which follow each other take a clock reading each
+#define EJFP_TRACE_LAP(aEjfp, aPhase, aMessageSize, aMark) do { \
+		const uint32_t kTraceNow = ejfpTraceNow(EJFP_TRACE_OF(aEjfp)); \
+		ejfpTraceRecord(EJFP_TRACE_OF(aEjfp), (aPhase), (aMessageSize), kTraceNow - (aMark)); \
+		(aMark) = kTraceNow; \
+	} while (0)
+
+#else
+
+#define EJFP_TRACE_MARK(aEjfp, aMark)
+#define EJFP_TRACE_LAP(aEjfp, aPhase, aMessageSize, aMark) do {} while (0)
+
+#endif  // EJFP_TRACE
+
+#endif  // EJFP_TRACE_H_
@@ -0,0 +1,367 @@
+//
+// validation.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+
+#include "ejfp/error.h"
+#include "ejfp/fieldVariant.h"
+#include "ejfp/validation.h"
+#include <string.h>
+
+typedef struct {
+	const char *begin;
+	const char *it;
+	const char *end;
+} Scanner;
+
+static int isWhitespace(char aCh);
+
+static int isDigit(char aCh);
+
+static int isHexDigit(char aCh);
+
+static void scanWhitespace(Scanner *aScanner);
+
+/// @brief Scans a string. `it` is expected to point at the opening quote
+static int scanString(Scanner *aScanner);
+
+/// @brief Scans a number, sets `aValueClass` to integer or float
+static int scanNumber(Scanner *aScanner, EjfpFieldVariantType *aValueClass);
+
+static int scanLiteral(Scanner *aScanner, const char *aLiteral, size_t aLiteralLength);
+
+/// @brief Scans "key": value pairs up to, and including the closing '}'
+static int scanPairs(Scanner *aScanner, EjfpScanCallback aCallback, void *aContext, int *aNPairs,
+	int *aIsStopped);
+
+static inline int isWhitespace(char aCh)
+{
+	return aCh == ' ' || aCh == '\t' || aCh == '\n' || aCh == '\r';
+}
+
+static inline int isDigit(char aCh)
+{
+	return aCh >= '0' && aCh <= '9';
+}
+
+static inline int isHexDigit(char aCh)
+{
+	return isDigit(aCh) || (aCh >= 'a' && aCh <= 'f') || (aCh >= 'A' && aCh <= 'F');
+}
+
+static inline void scanWhitespace(Scanner *aScanner)
+{
+	while (aScanner->it != aScanner->end && isWhitespace(*aScanner->it)) {
+		++aScanner->it;
+	}
+}
+
+static int scanString(Scanner *aScanner)
+{
+	++aScanner->it;
+
+	for (;;) {
+		// Skip plain characters
+		while (aScanner->it != aScanner->end && (unsigned char)*aScanner->it >= 0x20 && *aScanner->it != '"'
+				&& *aScanner->it != '\\') {
+			++aScanner->it;
+		}
+
+		if (aScanner->it == aScanner->end) {
+			return EjfpErrorDeserializationPartitioned;
+		}
+
+		switch (*aScanner->it) {
+			case '"':
+				++aScanner->it;
+
+				return EjfpOk;
+
+			case '\\':
+				if (++aScanner->it == aScanner->end) {
+					return EjfpErrorDeserializationPartitioned;
+				}
+
+				switch (*aScanner->it) {
+					case '"':
+					case '\\':
+					case '/':
+					case 'b':
+					case 'f':
+					case 'n':
+					case 'r':
+					case 't':
+						++aScanner->it;
+
+						break;
+
+					case 'u':
+						for (int i = 0; i < 4; ++i) {
+							if (++aScanner->it == aScanner->end) {
+								return EjfpErrorDeserializationPartitioned;
+							} else if (!isHexDigit(*aScanner->it)) {
+								return EjfpErrorDeserializationInvalidSyntax;
+							}
+						}
+
+						++aScanner->it;
+
+						break;
+
+					default:
+						return EjfpErrorDeserializationInvalidSyntax;
+				}
+
+				break;
+
+			default:  // Control character
+				return EjfpErrorDeserializationInvalidSyntax;
+		}
+	}
+}
+
+static int scanNumber(Scanner *aScanner, EjfpFieldVariantType *aValueClass)
+{
+	*aValueClass = EjfpFieldVariantTypeInteger;
+
+	if (*aScanner->it == '-' && ++aScanner->it == aScanner->end) {
+		return EjfpErrorDeserializationPartitioned;
+	}
+
+	// Integer part: "0", or no leading zeros
+	if (*aScanner->it == '0') {
+		++aScanner->it;
+	} else if (isDigit(*aScanner->it)) {
+		while (aScanner->it != aScanner->end && isDigit(*aScanner->it)) {
+			++aScanner->it;
+		}
+	} else {
+		return EjfpErrorDeserializationInvalidSyntax;
+	}
+
+	// Fraction
+	if (aScanner->it != aScanner->end && *aScanner->it == '.') {
+		*aValueClass = EjfpFieldVariantTypeFloat;
+
+		if (++aScanner->it == aScanner->end) {
+			return EjfpErrorDeserializationPartitioned;
+		} else if (!isDigit(*aScanner->it)) {
+			return EjfpErrorDeserializationInvalidSyntax;
+		}
+
+		while (aScanner->it != aScanner->end && isDigit(*aScanner->it)) {
+			++aScanner->it;
+		}
+	}
+
+	// Exponent
+	if (aScanner->it != aScanner->end && (*aScanner->it == 'e' || *aScanner->it == 'E')) {
+		*aValueClass = EjfpFieldVariantTypeFloat;
+
+		if (++aScanner->it != aScanner->end && (*aScanner->it == '+' || *aScanner->it == '-')) {
+			++aScanner->it;
+		}
+
+		if (aScanner->it == aScanner->end) {
+			return EjfpErrorDeserializationPartitioned;
+		} else if (!isDigit(*aScanner->it)) {
+			return EjfpErrorDeserializationInvalidSyntax;
+		}
+
+		while (aScanner->it != aScanner->end && isDigit(*aScanner->it)) {
+			++aScanner->it;
+		}
+	}
+
+	// In strict mode primitive must be followed by a whitespace, ',' or '}'
+	if (aScanner->it == aScanner->end) {
+		return EjfpErrorDeserializationPartitioned;
+	} else if (!isWhitespace(*aScanner->it) && *aScanner->it != ',' && *aScanner->it != '}') {
+		return EjfpErrorDeserializationInvalidSyntax;
+	}
+
+	return EjfpOk;
+}
+
+static int scanLiteral(Scanner *aScanner, const char *aLiteral, size_t aLiteralLength)
+{
+	const size_t kAvailable = aScanner->end - aScanner->it;
+
+	if (kAvailable < aLiteralLength) {
+		return memcmp(aScanner->it, aLiteral, kAvailable) == 0 ? EjfpErrorDeserializationPartitioned :
+			EjfpErrorDeserializationInvalidSyntax;
+	} else if (memcmp(aScanner->it, aLiteral, aLiteralLength) != 0) {
+		return EjfpErrorDeserializationInvalidSyntax;
+	}
+
+	aScanner->it += aLiteralLength;
+
+	return EjfpOk;
+}
+
+static int scanPairs(Scanner *aScanner, EjfpScanCallback aCallback, void *aContext, int *aNPairs,
+	int *aIsStopped)
+{
+	EjfpScanPair pair;
+	int error = EjfpOk;
+
+	for (;;) {
+		// Key
+		scanWhitespace(aScanner);
+
+		if (aScanner->it == aScanner->end) {
+			return EjfpErrorDeserializationPartitioned;
+		} else if (*aScanner->it != '"') {
+			return EjfpErrorDeserializationInvalidSyntax;
+		}
+
+		pair.keyStart = aScanner->it - aScanner->begin + 1;
+
+		if (EjfpOk != (error = scanString(aScanner))) {
+			return error;
+		}
+
+		pair.keyEnd = aScanner->it - aScanner->begin - 1;
+		scanWhitespace(aScanner);
+
+		if (aScanner->it == aScanner->end) {
+			return EjfpErrorDeserializationPartitioned;
+		} else if (*aScanner->it != ':') {
+			return EjfpErrorDeserializationInvalidSyntax;
+		}
+
+		// Value
+		++aScanner->it;
+		scanWhitespace(aScanner);
+
+		if (aScanner->it == aScanner->end) {
+			return EjfpErrorDeserializationPartitioned;
+		}
+
+		pair.valueStart = aScanner->it - aScanner->begin;
+
+		switch (*aScanner->it) {
+			case '"':
+				pair.valueClass = EjfpFieldVariantTypeString;
+				++pair.valueStart;
+				error = scanString(aScanner);
+
+				break;
+
+			case 't':
+				pair.valueClass = EjfpFieldVariantTypeBoolean;
+				error = scanLiteral(aScanner, "true", 4);
+
+				break;
+
+			case 'f':
+				pair.valueClass = EjfpFieldVariantTypeBoolean;
+				error = scanLiteral(aScanner, "false", 5);
+
+				break;
+
+			case 'n':
+				pair.valueClass = EjfpFieldVariantTypeNull;
+				error = scanLiteral(aScanner, "null", 4);
+
+				break;
+
+			case '{':
+			case '[':
+				error = EjfpErrorDeserializationUnsupportedJsonStructure;
+
+				break;
+
+			default:
+				error = scanNumber(aScanner, &pair.valueClass);
+
+				break;
+		}
+
+		if (EjfpOk != error) {
+			return error;
+		}
+
+		pair.valueEnd = aScanner->it - aScanner->begin - (pair.valueClass == EjfpFieldVariantTypeString ? 1 : 0);
+		++*aNPairs;
+
+		if (aCallback != NULL && aCallback(aContext, &pair) != 0) {
+			*aIsStopped = 1;
+
+			return EjfpOk;
+		}
+
+		// Separator
+		scanWhitespace(aScanner);
+
+		if (aScanner->it == aScanner->end) {
+			return EjfpErrorDeserializationPartitioned;
+		} else if (*aScanner->it == '}') {
+			++aScanner->it;
+
+			return EjfpOk;
+		} else if (*aScanner->it != ',') {
+			return EjfpErrorDeserializationInvalidSyntax;
+		}
+
+		++aScanner->it;
+	}
+}
+
+int ejfpScan(const char *aInputBuffer, size_t aInputBufferSize, EjfpScanCallback aCallback, void *aContext,
+	size_t *aErrorOffset)
+{
+	Scanner scanner = {aInputBuffer, aInputBuffer, aInputBuffer + aInputBufferSize};
+	int nPairs = 0;
+	int isStopped = 0;
+	int error = EjfpOk;
+
+	scanWhitespace(&scanner);
+
+	if (scanner.it == scanner.end) {
+		error = EjfpErrorDeserializationPartitioned;
+	} else if (*scanner.it == '[') {
+		error = EjfpErrorDeserializationUnsupportedJsonStructure;
+	} else if (*scanner.it != '{') {
+		error = EjfpErrorDeserializationInvalidSyntax;
+	} else {
+		++scanner.it;
+		scanWhitespace(&scanner);
+
+		if (scanner.it != scanner.end && *scanner.it == '}') {
+			++scanner.it;
+		} else {
+			error = scanPairs(&scanner, aCallback, aContext, &nPairs, &isStopped);
+		}
+	}
+
+	if (isStopped) {
+		return nPairs;
+	}
+
+	// Nothing but whitespaces may follow the object. Like "jsmn", treat the NULL character as the end of input
+	if (EjfpOk == error) {
+		scanWhitespace(&scanner);
+
+		if (scanner.it != scanner.end && *scanner.it != '\0') {
+			error = EjfpErrorDeserializationInvalidSyntax;
+		}
+	}
+
+	if (EjfpOk != error) {
+		if (aErrorOffset != NULL) {
+			*aErrorOffset = scanner.it - scanner.begin;
+		}
+
+		return error;
+	}
+
+	return nPairs;
+}
+
+int ejfpValidate(const char *aInputBuffer, size_t aInputBufferSize, size_t *aErrorOffset)
+{
+	return ejfpScan(aInputBuffer, aInputBufferSize, NULL, NULL, aErrorOffset);
+}
@@ -0,0 +1,56 @@
+//
+// validation.h
+//
+// Created on: 2026-10-19
+//     Author: Dmitry Murashov (dmtr <DOT> murashov <AT> <GMAIL>)
+//
+// Single-pass validation of flat JSON objects w/o token storage or number
+// conversion. The grammar is that of RFC 8259, restricted to the structures
+// `ejfpDeserialize` supports.
+//
+
+#ifndef EJFP_VALIDATION_H_
+#define EJFP_VALIDATION_H_
+
+#include "ejfp/fieldVariant.h"
+#include <stddef.h>
+
+/// @brief Position of a key/value pair in the input. String spans exclude quotes
+typedef struct {
+	size_t keyStart;
+	size_t keyEnd;
+	size_t valueStart;
+	size_t valueEnd;
+
+	/// @brief `String`, `Boolean`, `Null`, `Integer` (no fraction, no
+	/// exponent), or `Float`. Numbers are not converted, so this is a syntactic
+	/// class, not the final type
+	EjfpFieldVariantType valueClass;
+} EjfpScanPair;
+
+/// @brief Is called for each key/value pair as soon as the value is scanned
+/// @return 0 to continue. Non-zero value stops the scan
+typedef int (*EjfpScanCallback)(void *aContext, const EjfpScanPair *aPair);
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/// @brief Scans and validates an object, reports key/value pairs
+///
+/// @param aCallback May be NULL
+/// @param aErrorOffset If not NULL, receives the offset of the offending byte on failure
+///
+/// @return Number of pairs, if succeeded or stopped by the callback. Error code otherwise
+int ejfpScan(const char *aInputBuffer, size_t aInputBufferSize, EjfpScanCallback aCallback, void *aContext,
+	size_t *aErrorOffset);
+
+/// @brief Validates an object w/o producing anything. Same as `ejfpScan` w/o a callback
+/// @return Number of pairs, if valid. Error code otherwise
+int ejfpValidate(const char *aInputBuffer, size_t aInputBufferSize, size_t *aErrorOffset);
+
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
+
+#endif  // EJFP_VALIDATION_H_
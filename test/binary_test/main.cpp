@@ -0,0 +1,335 @@
+#define OHDEBUG_PORT_ENABLE 1
+#define OHDEBUG_TAGS_ENABLE "Trace"
+
+#include <OhDebug.hpp>
+
+#include <ejfp/base64.h>
+#include <ejfp/cbor.h>
+#include <ejfp/deserialization.h>
+#include <ejfp/error.h>
+#include <ejfp/iovec.h>
+#include <ejfp/ringInput.h>
+#include <ejfp/serialization.h>
+#include <ejfp/serializationPlan.h>
+#include <ejfp/sink.h>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int flushAppend(void *aContext, const char *aData, size_t aDataSize)
+{
+	static_cast<std::string *>(aContext)->append(aData, aDataSize);
+
+	return 0;
+}
+
+/// @brief Reference encoder, 1 bit at a time
+static std::string base64Reference(const uint8_t *aData, std::size_t aDataSize)
+{
+	static constexpr const char *kAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	std::string out;
+	unsigned bits = 0;
+	unsigned nBits = 0;
+
+	for (std::size_t i = 0; i < aDataSize; ++i) {
+		bits = (bits << 8) | aData[i];
+		nBits += 8;
+
+		for (; nBits >= 6; nBits -= 6) {
+			out += kAlphabet[(bits >> (nBits - 6)) & 0x3f];
+		}
+	}
+
+	if (nBits > 0) {
+		out += kAlphabet[(bits << (6 - nBits)) & 0x3f];
+	}
+
+	out.append((4 - out.size() % 4) % 4, '=');
+
+	return out;
+}
+
+OHDEBUG_TEST("Binary: Base64 vectors, and lengths on both sides of the vector loops")
+{
+	static constexpr const char *kVectors[][2] = {{"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"},
+		{"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"}};  // RFC 4648, 10
+
+	for (const auto &vector : kVectors) {
+		char encoded[16];
+		const std::size_t kSize = ejfpBase64Encode(encoded, vector[0], strlen(vector[0]));
+		assert(std::string(encoded, kSize) == vector[1]);
+	}
+
+	uint8_t data[200];
+
+	for (std::size_t i = 0; i < sizeof(data); ++i) {
+		data[i] = static_cast<uint8_t>(i * 151 + 7);
+	}
+
+	for (std::size_t size = 0; size <= sizeof(data); ++size) {
+		char encoded[EJFP_BASE64_ENCODED_SIZE(sizeof(data))];
+		const std::size_t kEncodedSize = ejfpBase64Encode(encoded, data, size);
+		assert(kEncodedSize == EJFP_BASE64_ENCODED_SIZE(size));
+		assert(std::string(encoded, kEncodedSize) == base64Reference(data, size));
+		assert(ejfpBase64DecodedSize(encoded, kEncodedSize) == size);
+
+		uint8_t decoded[sizeof(data)];
+		assert(ejfpBase64Decode(decoded, encoded, kEncodedSize) == EjfpOk);
+		assert(memcmp(decoded, data, size) == 0);
+
+		// W/o padding
+		std::size_t unpaddedSize = kEncodedSize;
+
+		while (unpaddedSize > 0 && encoded[unpaddedSize - 1] == '=') {
+			--unpaddedSize;
+		}
+
+		assert(ejfpBase64DecodedSize(encoded, unpaddedSize) == size);
+
+		// In place
+		assert(ejfpBase64Decode(encoded, encoded, unpaddedSize) == EjfpOk);
+		assert(memcmp(encoded, data, size) == 0);
+	}
+}
+
+OHDEBUG_TEST("Binary: Base64 invalid input")
+{
+	char encoded[EJFP_BASE64_ENCODED_SIZE(60)];
+	uint8_t data[60] {};
+	uint8_t decoded[60];
+	ejfpBase64Encode(encoded, data, sizeof(data));
+
+	// A bad character anywhere is detected, be it in a vector block or in the tail
+	for (std::size_t i = 0; i < sizeof(encoded); ++i) {
+		for (char bad : {'*', ' ', '=', '\0', '\x80'}) {
+			if (bad == '=' && i == sizeof(encoded) - 1) {
+				continue;  // "AAA=" is valid padding
+			}
+
+			const char kGood = encoded[i];
+			encoded[i] = bad;
+			assert(ejfpBase64Decode(decoded, encoded, sizeof(encoded)) == EjfpErrorDeserializationInvalidSyntax);
+			encoded[i] = kGood;
+		}
+	}
+
+	assert(ejfpBase64Decode(decoded, encoded, sizeof(encoded)) == EjfpOk);
+	assert(ejfpBase64DecodedSize("A", 1) == 0);
+	assert(ejfpBase64DecodedSize("AAAAA", 5) == 0);
+	assert(ejfpBase64Decode(decoded, "A", 1) == EjfpErrorDeserializationInvalidSyntax);
+	assert(ejfpBase64Decode(decoded, "Zg=A", 4) == EjfpErrorDeserializationInvalidSyntax);
+}
+
+OHDEBUG_TEST("Binary: JSON round trip, into a buffer and in place")
+{
+	static const char *const kBinaryFields[] = {"payload", "key"};
+	uint8_t payload[100];
+
+	for (std::size_t i = 0; i < sizeof(payload); ++i) {
+		payload[i] = static_cast<uint8_t>(255 - i * 3);
+	}
+
+	EjfpFieldVariant fieldVariants[4] {{EjfpFieldVariantTypeInteger, "id"}, {EjfpFieldVariantTypeBinary, "payload"},
+		{EjfpFieldVariantTypeBinary, "key"}, {EjfpFieldVariantTypeString, "name"}};
+	fieldVariants[0].integerValue = 3;
+	fieldVariants[1].binaryValue = payload;
+	fieldVariants[1].binaryValueSize = sizeof(payload);
+	fieldVariants[2].binaryValue = payload;
+	fieldVariants[2].binaryValueSize = 5;
+	fieldVariants[3].stringValue = "cGF5bG9hZA==";  // Not in the schema, stays a string
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	char output[256];
+	const int kSize = ejfpSerialize(&ejfp, fieldVariants, 4, output, sizeof(output));
+	OHDEBUG("Trace", output);
+	assert(kSize > 0 && static_cast<std::size_t>(kSize) == ejfpSerializedSize(fieldVariants, 4));
+	assert(strstr(output, "\"key\":\"//z59vM=\"") != nullptr);
+
+	char buffer[sizeof(payload) + 5];
+
+	for (bool isInPlace : {false, true}) {
+		std::string input(output, kSize);
+		EjfpFieldVariant decoded[4] {};
+		ejfpReset(&ejfp);
+		ejfpSetBinarySchema(&ejfp, kBinaryFields, 2, isInPlace ? nullptr : buffer, sizeof(buffer));
+		assert((isInPlace ? ejfpDeserializeInPlace(&ejfp, decoded, 4, &input[0], input.size()) :
+			ejfpDeserialize(&ejfp, decoded, 4, input.data(), input.size())) == 4);
+		assert(isInPlace || input == std::string(output, kSize));  // The input is only written to in place
+		assert(decoded[0].fieldType == EjfpFieldVariantTypeInteger && decoded[0].integerValue == 3);
+		assert(decoded[1].fieldType == EjfpFieldVariantTypeBinary);
+		assert(decoded[1].binaryValueSize == sizeof(payload));
+		assert(memcmp(decoded[1].binaryValue, payload, sizeof(payload)) == 0);
+		assert(decoded[2].fieldType == EjfpFieldVariantTypeBinary && decoded[2].binaryValueSize == 5);
+		assert(memcmp(decoded[2].binaryValue, payload, 5) == 0);
+		assert(decoded[3].fieldType == EjfpFieldVariantTypeString && decoded[3].stringValueLength == 12);
+		const char *kExpectedBegin = isInPlace ? input.data() : buffer;
+		const char *kExpectedEnd = kExpectedBegin + (isInPlace ? input.size() : sizeof(buffer));
+		assert(reinterpret_cast<const char *>(decoded[1].binaryValue) >= kExpectedBegin);
+		assert(reinterpret_cast<const char *>(decoded[2].binaryValue) < kExpectedEnd);
+
+		// Back into the same text
+		char reserialized[256];
+		assert(ejfpSerialize(&ejfp, decoded, 4, reserialized, sizeof(reserialized)) == kSize);
+		assert(strcmp(reserialized, output) == 0);
+	}
+
+	// The buffer is too small for both blobs, or there is none
+	for (std::size_t bufferSize : {sizeof(buffer) - 1, static_cast<std::size_t>(0)}) {
+		const std::string kInput(output, kSize);
+		EjfpFieldVariant decoded[4] {};
+		ejfpReset(&ejfp);
+		ejfpSetBinarySchema(&ejfp, kBinaryFields, 2, bufferSize == 0 ? nullptr : buffer, bufferSize);
+		assert(ejfpDeserialize(&ejfp, decoded, 4, kInput.data(), kInput.size()) == EjfpErrorDeserializationNoMemory);
+		assert(kInput == std::string(output, kSize));
+	}
+
+	// Not base64
+	{
+		std::string input = "{\"key\":\"a b\"}";
+		EjfpFieldVariant decoded[1] {};
+		ejfpReset(&ejfp);
+		ejfpSetBinarySchema(&ejfp, kBinaryFields, 2, buffer, sizeof(buffer));
+		assert(ejfpDeserialize(&ejfp, decoded, 1, &input[0], input.size()) == EjfpErrorDeserializationInvalidSyntax);
+	}
+}
+
+OHDEBUG_TEST("Binary: Ring buffer input")
+{
+	static constexpr const char *kInput = "{\"key\": \"AQIDBA==\", \"name\": \"AQIDBA==\"}";
+	static const char *const kBinaryFields[] = {"key"};
+	const std::size_t kInputSize = strlen(kInput);
+	char buffer[4];
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	ejfpSetBinarySchema(&ejfp, kBinaryFields, 1, buffer, sizeof(buffer));
+
+	// Wraps in the middle of the blob, which is spilled, and then decoded
+	char ring[48];
+	const std::size_t kOffset = sizeof(ring) - 12;
+
+	for (std::size_t i = 0; i < kInputSize; ++i) {
+		ring[(kOffset + i) % sizeof(ring)] = kInput[i];
+	}
+
+	EjfpRingInput ringInput;
+	EjfpFieldVariant decoded[2] {};
+	char spill[8];
+	ejfpRingInputInitialize(&ringInput, ring, sizeof(ring), kOffset, kInputSize);
+	assert(ejfpDeserializeRing(&ejfp, decoded, 2, &ringInput, spill, sizeof(spill)) == 2);
+	assert(decoded[0].fieldType == EjfpFieldVariantTypeBinary && decoded[0].binaryValueSize == 4);
+	assert(reinterpret_cast<const char *>(decoded[0].binaryValue) == buffer);
+	assert(memcmp(decoded[0].binaryValue, "\x01\x02\x03\x04", 4) == 0);
+	assert(decoded[1].fieldType == EjfpFieldVariantTypeString && decoded[1].stringValueLength == 8);
+
+	ejfpSetBinarySchema(&ejfp, kBinaryFields, 1, buffer, sizeof(buffer) - 1);
+	assert(ejfpDeserializeRing(&ejfp, decoded, 2, &ringInput, spill, sizeof(spill))
+		== EjfpErrorDeserializationNoMemory);
+}
+
+OHDEBUG_TEST("Binary: Sinks, plans, and CBOR")
+{
+	uint8_t payload[301];
+
+	for (std::size_t i = 0; i < sizeof(payload); ++i) {
+		payload[i] = static_cast<uint8_t>(i * 29 + 1);
+	}
+
+	EjfpFieldVariant fieldVariants[3] {{EjfpFieldVariantTypeBinary, "blob"}, {EjfpFieldVariantTypeInteger, "n"},
+		{EjfpFieldVariantTypeBinary, "none"}};
+	fieldVariants[0].binaryValue = payload;
+	fieldVariants[0].binaryValueSize = sizeof(payload);
+	fieldVariants[1].integerValue = 9;
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	char expected[512];
+	const int kSize = ejfpSerialize(&ejfp, fieldVariants, 3, expected, sizeof(expected));
+	assert(kSize > static_cast<int>(EJFP_BASE64_ENCODED_SIZE(sizeof(payload))));
+	assert(strstr(expected, "\"none\":null") != nullptr);
+
+	// Scratch buffers smaller than a quad, and not a multiple of it
+	for (std::size_t scratchSize : {1, 3, 7, 64}) {
+		std::string output;
+		char scratch[64];
+		EjfpSink sink;
+		ejfpSinkInitialize(&sink, scratch, scratchSize, flushAppend, &output);
+		assert(ejfpSerializeToSink(&ejfp, fieldVariants, 3, &sink) == kSize);
+		assert(output == expected);
+	}
+
+	// Plan
+	EjfpFieldVariant layout[3] {{EjfpFieldVariantTypeBinary, "blob"}, {EjfpFieldVariantTypeInteger, "n"},
+		{EjfpFieldVariantTypeBinary, "none"}};
+	layout[0].binaryValueSize = sizeof(payload);
+	layout[2].binaryValueSize = 1;
+	EjfpSerializationPlan plan;
+	EjfpSerializationPlanEntry entries[3];
+	char fragments[64];
+	assert(ejfpSerializationPlanCompile(&plan, entries, 3, fragments, sizeof(fragments), layout, 3) > 0);
+	assert(plan.maxOutputSize >= static_cast<std::size_t>(kSize) + 1);
+	char planned[512];
+	assert(ejfpSerializeWithPlan(&plan, fieldVariants, 3, planned, sizeof(planned)) == kSize);
+	assert(strcmp(planned, expected) == 0);
+
+	// CBOR byte strings, referenced in the input
+	char cbor[512];
+	const int kCborSize = ejfpCborSerialize(fieldVariants, 3, cbor, sizeof(cbor));
+	assert(kCborSize > static_cast<int>(sizeof(payload)) && kCborSize < kSize);
+	EjfpFieldVariant decoded[3] {};
+	assert(ejfpCborDeserialize(decoded, 3, cbor, kCborSize) == 3);
+	assert(decoded[0].fieldType == EjfpFieldVariantTypeBinary && decoded[0].binaryValueSize == sizeof(payload));
+	assert(memcmp(decoded[0].binaryValue, payload, sizeof(payload)) == 0);
+	assert(decoded[0].binaryValue > reinterpret_cast<const uint8_t *>(cbor));
+	assert(decoded[1].fieldType == EjfpFieldVariantTypeInteger && decoded[1].integerValue == 9);
+	assert(decoded[2].fieldType == EjfpFieldVariantTypeNull);
+	assert(ejfpCborDeserialize(decoded, 3, cbor, kCborSize - 1) == EjfpErrorDeserializationPartitioned);
+}
+
+OHDEBUG_TEST("Binary: scatter-gather output over a socketpair")
+{
+	const uint8_t kPayload[4] = {1, 2, 3, 4};
+	EjfpFieldVariant fieldVariants[3] {{EjfpFieldVariantTypeBinary, "b"}, {EjfpFieldVariantTypeInteger, "n"},
+		{EjfpFieldVariantTypeBinary, "none"}};
+	fieldVariants[0].binaryValue = kPayload;
+	fieldVariants[0].binaryValueSize = sizeof(kPayload);
+	fieldVariants[1].integerValue = 7;
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	char expected[64];
+	const int kSize = ejfpSerialize(&ejfp, fieldVariants, 3, expected, sizeof(expected));
+	assert(std::string(expected) == "{\"b\":\"AQIDBA==\",\"n\":7,\"none\":null}");
+
+	struct iovec iovecs[4];
+	char scratch[64];
+	const int kNIovecs = ejfpSerializeToIovec(&ejfp, fieldVariants, 3, iovecs, 4, scratch, sizeof(scratch));
+	assert(kNIovecs > 0);
+
+	int sockets[2];
+	assert(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+	assert(writev(sockets[0], iovecs, kNIovecs) == kSize);
+	close(sockets[0]);
+	std::string received;
+	char chunk[64];
+
+	for (ssize_t n = 0; (n = read(sockets[1], chunk, sizeof(chunk))) > 0;) {
+		received.append(chunk, n);
+	}
+
+	close(sockets[1]);
+	assert(received == expected);
+
+	// The encoded blob does not fit into the scratch buffer
+	assert(ejfpSerializeToIovec(&ejfp, fieldVariants, 3, iovecs, 4, scratch, 12)
+		== EjfpErrorSerializationNoMemory);
+}
+
+int main(void)
+{
+	OHDEBUG("Trace", "binary_test");
+	OHDEBUG_RUN_TESTS();
+
+	return 0;
+}
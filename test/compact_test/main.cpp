@@ -0,0 +1,189 @@
+#define OHDEBUG_PORT_ENABLE 1
+#define OHDEBUG_TAGS_ENABLE "Trace"
+
+#include <OhDebug.hpp>
+
+#include <ejfp/deserialization.h>
+#include <ejfp/error.h>
+#include <ejfp/serialization.h>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+static std::string fieldName(const Ejfp &aEjfp, const EjfpFieldVariant &aFieldVariant)
+{
+	return std::string(EJFP_FIELD_NAME(aEjfp.base, &aFieldVariant), aFieldVariant.fieldNameLength);
+}
+
+OHDEBUG_TEST("Compact: Layout")
+{
+	OHDEBUG("Trace", "sizeof(EjfpFieldVariant)", sizeof(EjfpFieldVariant));
+	static_assert(EJFP_COMPACT, "");
+	static_assert(sizeof(EjfpFieldVariant) == 16, "");
+
+	// The scale fits into the padding after the type
+	static_assert(EJFP_ENABLE_FIXED, "");
+	static_assert(offsetof(EjfpFieldVariant, fixedDigits) == 1, "");
+}
+
+OHDEBUG_TEST("Compact: Deserialization, and serialization of the same fields")
+{
+	static constexpr const char *kInput = "{\"id\": 42, \"name\": \"drone\", \"armed\": true, \"speed\": 1.5, "
+		"\"uptime\": 5000000000, \"mode\": null}";
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	EjfpFieldVariant fieldVariants[8] {};
+	const int nFieldVariants = ejfpDeserialize(&ejfp, fieldVariants, 8, kInput, strlen(kInput));
+	assert(nFieldVariants == 6);
+	assert(ejfp.base == kInput);
+
+	assert(fieldName(ejfp, fieldVariants[0]) == "id");
+	assert(fieldVariants[0].fieldType == EjfpFieldVariantTypeInteger);
+	assert(fieldVariants[0].integerValue == 42);
+
+	assert(fieldName(ejfp, fieldVariants[1]) == "name");
+	assert(fieldVariants[1].fieldType == EjfpFieldVariantTypeString);
+	assert(std::string(EJFP_FIELD_STRING(ejfp.base, &fieldVariants[1]), fieldVariants[1].stringValueLength)
+		== "drone");
+
+	assert(fieldVariants[2].fieldType == EjfpFieldVariantTypeBoolean && fieldVariants[2].booleanValue);
+	assert(fieldVariants[3].fieldType == EjfpFieldVariantTypeFloat && fieldVariants[3].floatValue == 1.5f);
+	assert(fieldVariants[4].fieldType == EjfpFieldVariantTypeInteger64);
+	assert(fieldVariants[4].integer64Value == 5000000000);
+	assert(fieldName(ejfp, fieldVariants[5]) == "mode");
+	assert(fieldVariants[5].fieldType == EjfpFieldVariantTypeNull);
+
+	char output[128] {};
+	const int outputSize = ejfpSerialize(&ejfp, fieldVariants, nFieldVariants, output, sizeof(output));
+	OHDEBUG("Trace", output);
+	assert(std::string(output) ==
+		"{\"id\":42,\"name\":\"drone\",\"armed\":true,\"speed\":1.5,\"uptime\":5000000000,\"mode\":null}");
+	assert(outputSize == (int)strlen(output));
+
+	// The output does not fit
+	assert(ejfpSerialize(&ejfp, fieldVariants, nFieldVariants, output, outputSize) == 0);
+	assert(ejfpErrorCode() == EjfpErrorSerializationNoMemory);
+}
+
+OHDEBUG_TEST("Compact: Fixed-point fields")
+{
+	static constexpr const char *kInput = "{\"altitude\": 123.45, \"name\": \"drone\"}";
+	static constexpr EjfpFixedField kFixedFields[1] {{"altitude", 2}};
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	ejfpSetFixedSchema(&ejfp, kFixedFields, 1);
+	EjfpFieldVariant fieldVariants[2] {};
+	assert(ejfpDeserialize(&ejfp, fieldVariants, 2, kInput, strlen(kInput)) == 2);
+	assert(fieldVariants[0].fieldType == EjfpFieldVariantTypeFixed);
+	assert(fieldVariants[0].fixedDigits == 2 && fieldVariants[0].fixedValue == 12345);
+	assert(fieldVariants[1].stringValueLength == 5);
+
+	char output[64] {};
+	assert(ejfpSerialize(&ejfp, fieldVariants, 2, output, sizeof(output)) > 0);
+	assert(std::string(output) == "{\"altitude\":123.45,\"name\":\"drone\"}");
+}
+
+OHDEBUG_TEST("Compact: Serialization from a string pool")
+{
+	static constexpr const char kPool[] = "statusready";
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	ejfpSetBase(&ejfp, kPool);
+	EjfpFieldVariant fieldVariants[2] {};
+	fieldVariants[0].fieldType = EjfpFieldVariantTypeString;
+	EJFP_FIELD_SET_NAME(kPool, &fieldVariants[0], kPool, 6);
+	EJFP_FIELD_SET_STRING(kPool, &fieldVariants[0], kPool + 6, 5);
+	fieldVariants[1].fieldType = EjfpFieldVariantTypeInteger;
+	EJFP_FIELD_SET_NAME(kPool, &fieldVariants[1], kPool + 6, 5);
+	fieldVariants[1].integerValue = -7;
+
+	char output[64] {};
+	ejfpSerialize(&ejfp, fieldVariants, 2, output, sizeof(output));
+	OHDEBUG("Trace", output);
+	assert(std::string(output) == "{\"status\":\"ready\",\"ready\":-7}");
+}
+
+OHDEBUG_TEST("Compact: Errors")
+{
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	EjfpFieldVariant fieldVariants[1] {};
+	static constexpr const char *kTwoFields = "{\"a\": 1, \"b\": 2}";
+	assert(ejfpDeserialize(&ejfp, fieldVariants, 1, kTwoFields, strlen(kTwoFields))
+		== EjfpErrorDeserializationNoMemory);
+	assert(ejfpDeserialize(&ejfp, fieldVariants, 1, "{\"a\": ", 6) == EjfpErrorDeserializationPartitioned);
+
+	// Offsets must fit into 16 bits
+	static char large[EJFP_COMPACT_BASE_SIZE_MAX + 2] {};
+	assert(ejfpDeserialize(&ejfp, fieldVariants, 1, large, sizeof(large)) == EjfpErrorDeserializationNoMemory);
+}
+
+OHDEBUG_TEST("Compact: Same syntax as the default mode")
+{
+	// Results of the default mode, which is lenient the way "jsmn" is
+	struct {
+		const char *input;
+		int result;
+	} cases[] = {
+		{"", 0},
+		{" {\"a\": true} ", 1},
+		{"{\"a\":01}", 1},
+		{"{\"a\":1.}", 1},
+		{"{\"a\":1,}", 1},
+		{"{\"a\" 1}", 1},
+		{"{\"a\":1,,\"b\":2}", 2},
+		{"{\"a\":\"\\x\"}", EjfpErrorDeserializationInvalidSyntax},
+		{"{\"a\":1}}", EjfpErrorDeserializationInvalidSyntax},
+		{"{a:1}", EjfpErrorDeserializationUnsupportedJsonStructure},
+		{"{\"a\":1} x", EjfpErrorDeserializationUnsupportedJsonStructure},
+		{"{\"a\":\"b\":1}", EjfpErrorDeserializationUnsupportedJsonStructure},
+		{"{\"a\":{\"b\":1}}", EjfpErrorDeserializationUnsupportedJsonStructure},
+		{"[1]", EjfpErrorDeserializationUnsupportedJsonStructure},
+		{"{\"a\":\"\\u00e9\"}", 1},
+		{"{\"a\":[1]}", EjfpErrorDeserializationUnsupportedJsonStructure},
+		{"{\"a\":\"b\"]", EjfpErrorDeserializationInvalidSyntax},
+		{"{\"a\":\x01}", EjfpErrorDeserializationInvalidSyntax},
+		{"{\"a\":1", EjfpErrorDeserializationPartitioned},
+		{"{\"a\":1,\"b\":2,\"c\":3,\"d\":4,\"e\":5}", EjfpErrorDeserializationNoMemory},
+	};
+
+	for (const auto &testCase : cases) {
+		Ejfp ejfp{};
+		ejfpInitialize(&ejfp);
+		EjfpFieldVariant fieldVariants[4] {};
+		const int result = ejfpDeserialize(&ejfp, fieldVariants, 4, testCase.input, strlen(testCase.input));
+		OHDEBUG("Trace", testCase.input, "->", result);
+		assert(result == testCase.result);
+		assert(result < 1 || fieldName(ejfp, fieldVariants[0]) == "a");
+	}
+}
+
+OHDEBUG_TEST("Compact: Serialization w/o a base")
+{
+	EjfpFieldVariant fieldVariants[1] {};
+	fieldVariants[0].fieldType = EjfpFieldVariantTypeInteger;
+	fieldVariants[0].fieldNameLength = 1;
+	char output[16] {};
+
+	// The default mode accepts a NULL instance, the compact one reports it instead of crashing
+	assert(ejfpSerialize(nullptr, fieldVariants, 1, output, sizeof(output)) == 0);
+	assert(ejfpErrorCode() == EjfpErrorSerializationNoBase);
+
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	assert(ejfpSerialize(&ejfp, fieldVariants, 1, output, sizeof(output)) == 0);
+	assert(ejfpErrorCode() == EjfpErrorSerializationNoBase);
+
+	ejfpSetBase(&ejfp, "a");
+	assert(ejfpSerialize(&ejfp, fieldVariants, 1, output, sizeof(output)) == 7);
+	assert(std::string(output) == "{\"a\":0}");
+}
+
+int main(void)
+{
+	OHDEBUG("Trace", "compact_test");
+	OHDEBUG_RUN_TESTS();
+
+	return 0;
+}
@@ -0,0 +1,112 @@
+#define OHDEBUG_PORT_ENABLE 1
+#define OHDEBUG_TAGS_ENABLE "Trace"
+
+#include <OhDebug.hpp>
+
+#include <ejfp/connections.h>
+#include <ejfp/error.h>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+struct Received {
+	std::map<int, std::vector<int>> sequences;  // By client
+	std::vector<int> closed;
+	int nErrors = 0;
+};
+
+static void onObject(void *aContext, EjfpConnection *aConnection, int aResult, const EjfpFieldVariant *aFieldVariants)
+{
+	Received &received = *static_cast<Received *>(aContext);
+	const int kClient = static_cast<int>(reinterpret_cast<std::size_t>(aConnection->userData));
+
+	if (aResult == EjfpErrorStreamEnd) {
+		received.closed.push_back(kClient);
+		close(aConnection->fd);
+	} else if (aResult < 0) {
+		++received.nErrors;
+	} else {
+		assert(aResult == 1 && std::strncmp(aFieldVariants[0].fieldName, "seq", 3) == 0);
+		received.sequences[kClient].push_back(aFieldVariants[0].integerValue);
+	}
+}
+
+OHDEBUG_TEST("Connections: demultiplexing of interleaved partial objects")
+{
+	constexpr std::size_t kNClients = 3;
+	constexpr std::size_t kBufferSize = 32;
+	EjfpConnection connectionArray[kNClients];
+	char buffers[kNClients * kBufferSize];
+	EjfpFieldVariant fieldVariants[2];
+	EjfpConnections connections{};
+	Received received;
+	int sockets[kNClients][2];
+	assert(ejfpConnectionsInitialize(&connections, connectionArray, kNClients, buffers, kBufferSize, fieldVariants, 2,
+		onObject, &received) == EjfpOk);
+
+	for (std::size_t i = 0; i < kNClients; ++i) {
+		assert(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets[i]) == 0);
+		assert(ejfpConnectionsAdd(&connections, sockets[i][1], reinterpret_cast<void *>(i)) != nullptr);
+	}
+
+	int spare[2];
+	assert(socketpair(AF_UNIX, SOCK_STREAM, 0, spare) == 0);
+	assert(ejfpConnectionsAdd(&connections, spare[1], nullptr) == nullptr);  // The pool is full
+
+	// Each client sends its objects in halves, interleaved w/ the other clients
+	for (int seq = 0; seq < 4; ++seq) {
+		for (std::size_t i = 0; i < kNClients; ++i) {
+			const std::string message = "{\"seq\": " + std::to_string(seq * 10 + i) + "}\n";
+			const std::size_t kHalf = message.size() / 2;
+			assert(write(sockets[i][0], message.data(), kHalf) == (ssize_t)kHalf);
+			ejfpConnectionsPoll(&connections, 0);
+			assert(write(sockets[i][0], message.data() + kHalf, message.size() - kHalf)
+				== (ssize_t)(message.size() - kHalf));
+		}
+
+		while (ejfpConnectionsPoll(&connections, 0) > 0) {
+		}
+	}
+
+	assert(write(sockets[1][0], "garbage", 7) == 7);
+	close(sockets[1][0]);
+
+	for (int i = 0; i < 8 && received.closed.empty(); ++i) {
+		ejfpConnectionsPoll(&connections, 100);
+	}
+
+	for (std::size_t i = 0; i < kNClients; ++i) {
+		const std::vector<int> expected{(int)i, (int)(10 + i), (int)(20 + i), (int)(30 + i)};
+		assert(received.sequences[i] == expected);
+	}
+
+	OHDEBUG("Trace", "errors", received.nErrors);
+	assert(received.nErrors == 7);  // Each stray byte is reported
+	assert(received.closed == std::vector<int>{1});
+	assert(connectionArray[1].fd == -1);
+
+	// The freed slot is reused
+	assert(ejfpConnectionsAdd(&connections, spare[1], nullptr) == &connectionArray[1]);
+
+	close(sockets[0][0]);
+	close(sockets[0][1]);
+	close(sockets[2][0]);
+	close(sockets[2][1]);
+
+	close(spare[0]);
+	close(spare[1]);
+	ejfpConnectionsDeinitialize(&connections);
+}
+
+int main(void)
+{
+	OHDEBUG("Trace", "connections_test");
+	OHDEBUG_RUN_TESTS();
+
+	return 0;
+}
@@ -0,0 +1,135 @@
+#define OHDEBUG_PORT_ENABLE 1
+#define OHDEBUG_TAGS_ENABLE "Trace"
+
+#include <OhDebug.hpp>
+
+#include <ejfp/ejfp.hpp>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+#include <type_traits>
+
+static std::size_t sNAllocations = 0;
+
+void *operator new(std::size_t aSize)
+{
+	++sNAllocations;
+
+	if (void *memory = std::malloc(aSize)) {
+		return memory;
+	}
+
+	throw std::bad_alloc{};
+}
+
+void operator delete(void *aMemory) noexcept
+{
+	std::free(aMemory);
+}
+
+void operator delete(void *aMemory, std::size_t) noexcept
+{
+	std::free(aMemory);
+}
+
+using namespace std::literals;
+
+static constexpr std::string_view kInput = R"({"name": "drone", "id": 42, "armed": true, "voltage": 11.5,
+	"timestamp": 1684411200123456789, "mode": null, "latitude": 59.93863123456789})";
+
+OHDEBUG_TEST("C++: Range-for, find, typed access")
+{
+	ejfp::Parser<8> parser;
+	const std::size_t kNAllocations = sNAllocations;
+	assert(parser.parse(kInput) == 7);
+	std::size_t nFields = 0;
+
+	for (ejfp::FieldView field : parser.fields()) {
+		assert(kInput.find(field.name()) != std::string_view::npos);  // Views refer to the input
+		++nFields;
+	}
+
+	assert(nFields == 7);
+	const ejfp::Fields fields = parser.fields();
+	assert(fields.find("name")->get<std::string_view>() == "drone"sv);
+	assert(fields.find("name")->name().data() == kInput.data() + 2);
+	assert(fields.find("id")->get<int>() == 42);
+	assert(fields.find("id")->get<std::int64_t>() == 42);  // Widened
+	assert(fields.find("id")->get<std::uint64_t>() == 42u);
+	assert(!fields.find("id")->is<std::string_view>());
+	assert(fields.find("armed")->get<bool>() == true);
+	assert(fields.find("voltage")->get<float>() == 11.5f);
+	assert(fields.find("voltage")->get<double>() == 11.5);
+	assert(fields.find("timestamp")->get<std::int64_t>() == 1684411200123456789);
+	assert(!fields.find("timestamp")->is<int>());
+	assert(fields.find("mode")->is<std::nullptr_t>());
+	assert(fields.find("latitude")->get<double>() == 59.93863123456789);
+	assert(!fields.find("missing").has_value());
+	assert(sNAllocations == kNAllocations);
+}
+
+OHDEBUG_TEST("C++: Visitation")
+{
+	ejfp::Parser<8> parser;
+	parser.parse(kInput);
+	int nNumbers = 0;
+	int nOthers = 0;
+
+	for (ejfp::FieldView field : parser.fields()) {
+		field.visit([&](auto aValue) {
+			using T = decltype(aValue);
+
+			if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+				++nNumbers;
+			} else {
+				++nOthers;
+			}
+		});
+	}
+
+	assert(nNumbers == 4);
+	assert(nOthers == 3);
+}
+
+OHDEBUG_TEST("C++: Serialization from an initializer list")
+{
+	char out[256];
+	const std::string_view kName = "drone, not NULL-terminated"sv.substr(0, 5);
+	const std::size_t kNAllocations = sNAllocations;
+	const int outSize = ejfp::serialize(out, {
+		{"name", kName},
+		{"id", 42},
+		{"armed", true},
+		{"voltage", 11.5f},
+		{"timestamp", 1684411200123456789LL},
+		{"counter", 18446744073709551615ULL},
+		{"latitude", 59.93863123456789},
+		{"quoted \"key\"", "\\"},
+		{"mode", nullptr},
+	});
+	assert(sNAllocations == kNAllocations);
+	OHDEBUG("Trace", out);
+	assert(std::string_view(out, outSize) == R"({"name":"drone","id":42,"armed":true,"voltage":11.5,)"
+		R"("timestamp":1684411200123456789,"counter":18446744073709551615,"latitude":59.93863123456789,)"
+		R"("quoted \"key\"":"\\","mode":null})"sv);
+
+	// Round trip
+	ejfp::Parser<9> parser;
+	assert(parser.parse({out, static_cast<std::size_t>(outSize)}) == 9);
+	assert(parser.fields().find("counter")->get<std::uint64_t>() == 18446744073709551615ULL);
+
+	char small[16];
+	assert(ejfp::serialize(small, {{"name", kName}, {"id", 42}}) == EjfpErrorSerializationNoMemory);
+	assert(ejfp::serialize(small, {}) == 2 && small == "{}"sv);
+}
+
+int main(void)
+{
+	OHDEBUG("Trace", "cpp_test");
+	OHDEBUG_RUN_TESTS();
+
+	return 0;
+}
@@ -0,0 +1,199 @@
+#define OHDEBUG_PORT_ENABLE 1
+#define OHDEBUG_TAGS_ENABLE "Trace"
+
+#include <OhDebug.hpp>
+
+#include <ejfp/cbor.h>
+#include <ejfp/deserialization.h>
+#include <ejfp/error.h>
+#include <ejfp/format.h>
+#include <ejfp/ringInput.h>
+#include <ejfp/serialization.h>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+OHDEBUG_TEST("Fixed: Deserialize w/ per-field scale")
+{
+	static constexpr const char *kInput =
+		"{\"temperature\": 23.456, \"voltage\": -3.3, \"count\": 7, \"raw\": 12, \"armed\": true, \"id\": \"a\"}";
+	static const EjfpFixedField kFixedFields[] = {{"temperature", 2}, {"voltage", 3}, {"count", 0}, {"armed", 1},
+		{"id", 1}};
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	ejfpSetFixedSchema(&ejfp, kFixedFields, 5);
+	EjfpFieldVariant fieldVariants[6] {};
+	const int nFieldVariants = ejfpDeserialize(&ejfp, fieldVariants, 6, kInput, strlen(kInput));
+	assert(nFieldVariants == 6);
+	assert(fieldVariants[0].fieldType == EjfpFieldVariantTypeFixed);
+	assert(fieldVariants[0].fixedValue == 2346 && fieldVariants[0].fixedDigits == 2);
+	assert(fieldVariants[1].fieldType == EjfpFieldVariantTypeFixed);
+	assert(fieldVariants[1].fixedValue == -3300 && fieldVariants[1].fixedDigits == 3);
+	assert(fieldVariants[2].fieldType == EjfpFieldVariantTypeFixed);
+	assert(fieldVariants[2].fixedValue == 7 && fieldVariants[2].fixedDigits == 0);
+	assert(fieldVariants[3].fieldType == EjfpFieldVariantTypeInteger && fieldVariants[3].integerValue == 12);
+
+	// Non-numeric values of fixed-point fields keep their types
+	assert(fieldVariants[4].fieldType == EjfpFieldVariantTypeBoolean);
+	assert(fieldVariants[5].fieldType == EjfpFieldVariantTypeString);
+
+	// Reals are still rejected outside of the schema
+	static constexpr const char *kReal = "{\"speed\": 1.5}";
+	ejfpReset(&ejfp);
+	assert(ejfpDeserialize(&ejfp, fieldVariants, 6, kReal, strlen(kReal))
+		== EjfpErrorDeserializationUnsupportedJsonStructure);
+}
+
+OHDEBUG_TEST("Fixed: Ring buffer input w/ the same schema")
+{
+	static constexpr const char *kInput = "{\"temperature\": 23.456, \"count\": 7}";
+	static const EjfpFixedField kFixedFields[] = {{"temperature", 2}, {"count", 1}};
+	const std::size_t kInputSize = strlen(kInput);
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	ejfpSetFixedSchema(&ejfp, kFixedFields, 2);
+
+	// Wraps in the middle of "23.456"
+	char ring[64];
+	const std::size_t kOffset = sizeof(ring) - 20;
+
+	for (std::size_t i = 0; i < kInputSize; ++i) {
+		ring[(kOffset + i) % sizeof(ring)] = kInput[i];
+	}
+
+	EjfpRingInput ringInput;
+	EjfpFieldVariant fieldVariants[2] {};
+	ejfpRingInputInitialize(&ringInput, ring, sizeof(ring), kOffset, kInputSize);
+	assert(ejfpDeserializeRing(&ejfp, fieldVariants, 2, &ringInput, nullptr, 0) == 2);
+	assert(fieldVariants[0].fieldType == EjfpFieldVariantTypeFixed);
+	assert(fieldVariants[0].fixedValue == 2346 && fieldVariants[0].fixedDigits == 2);
+	assert(fieldVariants[1].fieldType == EjfpFieldVariantTypeFixed);
+	assert(fieldVariants[1].fixedValue == 70 && fieldVariants[1].fixedDigits == 1);
+}
+
+OHDEBUG_TEST("Fixed: Rounding, exponents, and range")
+{
+	struct {
+		const char *input;
+		unsigned digits;
+		int isValid;
+		EjfpFixed value;
+	} kCases[] = {
+		{"1.005", 2, 1, 101},
+		{"-1.005", 2, 1, -101},
+		{"1.004", 2, 1, 100},
+		{"0.004", 2, 1, 0},
+		{"-0.005", 2, 1, -1},
+		{"1e2", 1, 1, 1000},
+		{"12.3e-1", 2, 1, 123},
+		{"1.5E+1", 0, 1, 15},
+		{"1e-400", 2, 1, 0},
+		{"0.12345678901234567890123", 18, 1, 123456789012345679},
+		{"9223372036854775807", 0, 1, INT64_MAX},
+		{"-9223372036854775808", 0, 1, INT64_MIN},
+		{"92233720368547758.07", 2, 1, INT64_MAX},
+		{"9223372036854775808", 0, 0, 0},
+		{"92233720368547758.08", 2, 0, 0},
+		{"1e400", 2, 0, 0},
+		{"1.2.3", 2, 0, 0},
+		{"1e", 2, 0, 0},
+		{"-", 2, 0, 0},
+	};
+
+	for (const auto &testCase : kCases) {
+		const EjfpFixedField kFixedField{"x", (uint8_t)testCase.digits};
+		const std::string kInput = std::string("{\"x\": ") + testCase.input + "}";
+		Ejfp ejfp{};
+		ejfpInitialize(&ejfp);
+		ejfpSetFixedSchema(&ejfp, &kFixedField, 1);
+		EjfpFieldVariant fieldVariant{};
+		const int result = ejfpDeserialize(&ejfp, &fieldVariant, 1, kInput.c_str(), kInput.size());
+		OHDEBUG("Trace", kInput.c_str(), "->", result, (long long)fieldVariant.fixedValue);
+
+		if (testCase.isValid) {
+			assert(result == 1);
+			assert(fieldVariant.fieldType == EjfpFieldVariantTypeFixed);
+			assert(fieldVariant.fixedValue == testCase.value);
+		} else {
+			assert(result < 0);
+		}
+	}
+}
+
+OHDEBUG_TEST("Fixed: Serialize")
+{
+	struct {
+		EjfpFixed value;
+		uint8_t digits;
+		const char *expected;
+	} kCases[] = {
+		{1234, 2, "12.34"},
+		{-5, 3, "-0.005"},
+		{7, 0, "7"},
+		{100, 2, "1.00"},
+		{0, 1, "0.0"},
+		{INT64_MIN, 18, "-9.223372036854775808"},
+		{-1, 18, "-0.000000000000000001"},
+	};
+
+	for (const auto &testCase : kCases) {
+		char formatted[EJFP_FORMAT_SCALAR_MAX_LENGTH];
+		EjfpFieldVariant fieldVariant{EjfpFieldVariantTypeFixed, "x"};
+		fieldVariant.fixedValue = testCase.value;
+		fieldVariant.fixedDigits = testCase.digits;
+		const size_t kLength = ejfpFormatScalar(formatted, &fieldVariant);
+		assert(std::string(formatted, kLength) == testCase.expected);
+		assert(kLength <= ejfpFormatScalarMaxLength(EjfpFieldVariantTypeFixed));
+	}
+
+	// Objects w/ fixed-point fields bypass "mtojson"
+	EjfpFieldVariant fieldVariants[3] {
+		{EjfpFieldVariantTypeInteger, "id"},
+		{EjfpFieldVariantTypeFixed, "voltage"},
+		{EjfpFieldVariantTypeString, "unit"},
+	};
+	fieldVariants[0].integerValue = 1;
+	fieldVariants[1].fixedValue = 3300;
+	fieldVariants[1].fixedDigits = 3;
+	fieldVariants[2].stringValue = "V";
+	char output[64] {};
+	const int kNSerialized = ejfpSerialize(nullptr, fieldVariants, 3, output, sizeof(output));
+	OHDEBUG("Trace", output);
+	assert(std::string(output) == "{\"id\":1,\"voltage\":3.300,\"unit\":\"V\"}");
+	assert((size_t)kNSerialized == ejfpSerializedSize(fieldVariants, 3));
+	assert(ejfpSerialize(nullptr, fieldVariants, 3, output, 20) == 0);
+	assert(ejfpErrorCode() == EjfpErrorSerializationNoMemory);
+}
+
+OHDEBUG_TEST("Fixed: CBOR decimal fraction")
+{
+	EjfpFieldVariant fieldVariant{EjfpFieldVariantTypeFixed, "t"};
+	fieldVariant.fixedValue = 2346;
+	fieldVariant.fixedDigits = 2;
+	char output[16] {};
+	const int kSize = ejfpCborSerialize(&fieldVariant, 1, output, sizeof(output));
+
+	// {"t": 4([-2, 2346])}
+	static constexpr const unsigned char kExpected[] = {0xa1, 0x61, 't', 0xc4, 0x82, 0x21, 0x19, 0x09, 0x2a};
+	assert(kSize == (int)sizeof(kExpected) && memcmp(output, kExpected, sizeof(kExpected)) == 0);
+
+	EjfpFieldVariant decoded{};
+	assert(ejfpCborDeserialize(&decoded, 1, output, (size_t)kSize) == 1);
+	assert(decoded.fieldType == EjfpFieldVariantTypeFixed);
+	assert(decoded.fixedValue == 2346 && decoded.fixedDigits == 2);
+
+	// Other tags are not supported
+	static constexpr const unsigned char kBignum[] = {0xa1, 0x61, 't', 0xc2, 0x41, 0x01};
+	assert(ejfpCborDeserialize(&decoded, 1, (const char *)kBignum, sizeof(kBignum))
+		== EjfpErrorDeserializationUnsupportedJsonStructure);
+}
+
+int main(void)
+{
+	OHDEBUG("Trace", "fixed_test");
+	OHDEBUG_RUN_TESTS();
+
+	return 0;
+}
@@ -0,0 +1,261 @@
+#define OHDEBUG_PORT_ENABLE 1
+#define OHDEBUG_TAGS_ENABLE "Trace"
+
+#include <OhDebug.hpp>
+
+#include <ejfp/cbor.h>
+#include <ejfp/crc.h>
+#include <ejfp/error.h>
+#include <ejfp/frame.h>
+#include <ejfp/serialization.h>
+#include <ejfp/sink.h>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+static int flushAppend(void *aContext, const char *aData, size_t aDataSize)
+{
+	static_cast<std::string *>(aContext)->append(aData, aDataSize);
+
+	return 0;
+}
+
+OHDEBUG_TEST("Frame: CRC check values, byte-wise and sliced")
+{
+	static constexpr const char *kCheck = "123456789";
+	static const EjfpCrcParameters kParameters[] = {EJFP_CRC32, EJFP_CRC16_MODBUS, EJFP_CRC16_CCITT};
+	static const uint32_t kChecks[] = {0xcbf43926u, 0x4b37u, 0x29b1u};
+	char message[67];
+
+	for (std::size_t i = 0; i < sizeof(message); ++i) {
+		message[i] = static_cast<char>(i * 37 + 11);
+	}
+
+	for (std::size_t i = 0; i < 3; ++i) {
+		uint32_t table[EJFP_CRC_TABLE_SIZE];
+		uint32_t slicedTable[EJFP_CRC_SLICED_TABLE_SIZE];
+		EjfpCrc crc;
+		EjfpCrc slicedCrc;
+		ejfpCrcInitialize(&crc, &kParameters[i], table, EJFP_CRC_TABLE_SIZE);
+		ejfpCrcInitialize(&slicedCrc, &kParameters[i], slicedTable, EJFP_CRC_SLICED_TABLE_SIZE);
+		assert(!crc.isSliced && slicedCrc.isSliced);
+		OHDEBUG("Trace", "width", kParameters[i].width, "check", ejfpCrcCompute(&slicedCrc, kCheck, 9));
+		assert(ejfpCrcCompute(&crc, kCheck, 9) == kChecks[i]);
+		assert(ejfpCrcCompute(&slicedCrc, kCheck, 9) == kChecks[i]);
+
+		// Both agree on any length, and on any split into chunks
+		for (std::size_t size = 0; size <= sizeof(message); ++size) {
+			const uint32_t kExpected = ejfpCrcCompute(&crc, message, size);
+			assert(ejfpCrcCompute(&slicedCrc, message, size) == kExpected);
+
+			for (std::size_t split = 0; split <= size; split += 5) {
+				uint32_t crcRegister = ejfpCrcStart(&slicedCrc);
+				crcRegister = ejfpCrcUpdate(&slicedCrc, crcRegister, message, split);
+				crcRegister = ejfpCrcUpdate(&slicedCrc, crcRegister, message + split, size - split);
+				assert(ejfpCrcFinish(&slicedCrc, crcRegister) == kExpected);
+			}
+		}
+	}
+}
+
+OHDEBUG_TEST("Frame: Round trip")
+{
+	static const EjfpCrcParameters kParameters[] = {EJFP_CRC32, EJFP_CRC16_MODBUS, EJFP_CRC16_CCITT};
+	static const uint8_t kLengthSizes[] = {0, 1, 2, 4};
+	static const EjfpEncoding kEncodings[] = {EjfpEncodingJson, EjfpEncodingCbor};
+	EjfpFieldVariant fieldVariants[3] {
+		{EjfpFieldVariantTypeString, "name"},
+		{EjfpFieldVariantTypeInteger, "id"},
+		{EjfpFieldVariantTypeBoolean, "armed"},
+	};
+	fieldVariants[0].stringValue = "drone";
+	fieldVariants[1].integerValue = -42;
+	fieldVariants[2].integerValue = 1;
+
+	for (std::size_t i = 0; i < 3; ++i) {
+		uint32_t table[EJFP_CRC_SLICED_TABLE_SIZE];
+		EjfpCrc crc;
+		ejfpCrcInitialize(&crc, &kParameters[i], table, EJFP_CRC_SLICED_TABLE_SIZE);
+
+		for (uint8_t lengthSize : kLengthSizes) {
+			for (EjfpEncoding encoding : kEncodings) {
+				const EjfpFrameFormat kFormat{&crc, lengthSize};
+				Ejfp ejfp{};
+				ejfpInitialize(&ejfp);
+				ejfpSetEncoding(&ejfp, encoding);
+				char frame[128];
+				const int kFrameSize = ejfpSerializeFramed(&ejfp, &kFormat, fieldVariants, 3, frame, sizeof(frame));
+				OHDEBUG("Trace", "width", kParameters[i].width, "length size", lengthSize, "frame size", kFrameSize);
+				assert(kFrameSize > static_cast<int>(ejfpFrameOverhead(&kFormat)));
+				const std::size_t kObjectSize = kFrameSize - ejfpFrameOverhead(&kFormat);
+				uint32_t trailer = 0;
+
+				for (std::size_t byte = 0; byte < kParameters[i].width / 8u; ++byte) {
+					trailer |= static_cast<uint32_t>(static_cast<uint8_t>(frame[kFrameSize - 1 - byte]))
+						<< (8 * (kParameters[i].width / 8u - 1 - byte));
+				}
+
+				assert(trailer == ejfpCrcCompute(&crc, frame + lengthSize, kObjectSize));
+
+				if (lengthSize == 1) {
+					assert(static_cast<uint8_t>(frame[0]) == kObjectSize);
+				}
+
+				EjfpFieldVariant decoded[3] {};
+				std::size_t frameSize = 0;
+				ejfpReset(&ejfp);
+				assert(ejfpDeserializeFramed(&ejfp, &kFormat, decoded, 3, frame, kFrameSize, &frameSize) == 3);
+				assert(frameSize == static_cast<std::size_t>(kFrameSize));
+				assert(decoded[0].fieldType == EjfpFieldVariantTypeString);
+				assert(decoded[0].stringValueLength == 5 && strncmp(decoded[0].stringValue, "drone", 5) == 0);
+				assert(decoded[1].fieldType == EjfpFieldVariantTypeInteger && decoded[1].integerValue == -42);
+				assert(decoded[2].fieldType == EjfpFieldVariantTypeBoolean && decoded[2].integerValue == 1);
+			}
+		}
+	}
+}
+
+OHDEBUG_TEST("Frame: Corruption, truncation, and overflow")
+{
+	const EjfpCrcParameters kParameters = EJFP_CRC16_MODBUS;
+	uint32_t table[EJFP_CRC_TABLE_SIZE];
+	EjfpCrc crc;
+	ejfpCrcInitialize(&crc, &kParameters, table, EJFP_CRC_TABLE_SIZE);
+	const EjfpFrameFormat kFormat{&crc, 2};
+	EjfpFieldVariant fieldVariants[1] {{EjfpFieldVariantTypeInteger, "id"}};
+	fieldVariants[0].integerValue = 7;
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	char frames[64];
+	const int kFrameSize = ejfpSerializeFramed(&ejfp, &kFormat, fieldVariants, 1, frames, sizeof(frames));
+	assert(kFrameSize == 4 + static_cast<int>(strlen("{\"id\":7}")));
+
+	// Frames follow each other
+	memcpy(frames + kFrameSize, frames, kFrameSize);
+	EjfpFieldVariant decoded[1] {};
+	std::size_t frameSize = 0;
+	assert(ejfpDeserializeFramed(&ejfp, &kFormat, decoded, 1, frames, 2 * kFrameSize, &frameSize) == 1);
+	assert(frameSize == static_cast<std::size_t>(kFrameSize));
+
+	// Every single-bit error in the object is detected, and the frame can still be skipped
+	for (int i = 2; i < kFrameSize - 2; ++i) {
+		for (int bit = 0; bit < 8; ++bit) {
+			frames[i] ^= static_cast<char>(1 << bit);
+			frameSize = 0;
+			ejfpReset(&ejfp);
+			assert(ejfpDeserializeFramed(&ejfp, &kFormat, decoded, 1, frames, 2 * kFrameSize, &frameSize)
+				== EjfpErrorFrameChecksum);
+			assert(frameSize == static_cast<std::size_t>(kFrameSize));
+			frames[i] ^= static_cast<char>(1 << bit);
+		}
+	}
+
+	for (int size = 0; size < kFrameSize; ++size) {
+		ejfpReset(&ejfp);
+		assert(ejfpDeserializeFramed(&ejfp, &kFormat, decoded, 1, frames, size, nullptr)
+			== EjfpErrorDeserializationPartitioned);
+	}
+
+	// Exact fit
+	assert(ejfpSerializeFramed(&ejfp, &kFormat, fieldVariants, 1, frames, kFrameSize) == kFrameSize);
+	assert(ejfpSerializeFramed(&ejfp, &kFormat, fieldVariants, 1, frames, kFrameSize - 1)
+		== EjfpErrorSerializationNoMemory);
+
+	// The length does not fit into a 1-byte prefix
+	std::string longString(300, 'x');
+	EjfpFieldVariant longFieldVariants[1] {{EjfpFieldVariantTypeString, "s"}};
+	longFieldVariants[0].stringValue = longString.c_str();
+	char longFrame[512];
+	const EjfpFrameFormat kShortPrefix{&crc, 1};
+	assert(ejfpSerializeFramed(&ejfp, &kShortPrefix, longFieldVariants, 1, longFrame, sizeof(longFrame))
+		== EjfpErrorSerializationNoMemory);
+	assert(ejfpSerializeFramed(&ejfp, &kFormat, longFieldVariants, 1, longFrame, sizeof(longFrame)) > 300);
+}
+
+OHDEBUG_TEST("Frame: Checksum of a flushed sink")
+{
+	const EjfpCrcParameters kParameters = EJFP_CRC32;
+	uint32_t table[EJFP_CRC_SLICED_TABLE_SIZE];
+	EjfpCrc crc;
+	ejfpCrcInitialize(&crc, &kParameters, table, EJFP_CRC_SLICED_TABLE_SIZE);
+	std::string longString(200, 'y');
+	EjfpFieldVariant fieldVariants[3] {{EjfpFieldVariantTypeString, "payload"}, {EjfpFieldVariantTypeInteger, "n"},
+		{EjfpFieldVariantTypeString, "escaped"}};
+	fieldVariants[0].stringValue = longString.c_str();
+	fieldVariants[1].integerValue = 123456;
+	fieldVariants[2].stringValue = "\\\"a\"\"b\\\\c\"";
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+
+	// The scratch buffer is smaller than the output, so it is checksummed in chunks
+	std::string output;
+	char scratch[13];
+	EjfpSink sink;
+	ejfpSinkInitialize(&sink, scratch, sizeof(scratch), flushAppend, &output);
+	ejfpSinkSetCrc(&sink, &crc);
+	const int kSize = ejfpSerializeToSink(&ejfp, fieldVariants, 3, &sink);
+	assert(kSize > 200 && output.size() == static_cast<std::size_t>(kSize));
+	assert(ejfpSinkCrc(&sink) == ejfpCrcCompute(&crc, output.data(), output.size()));
+
+	// Same output as `ejfpSerialize`
+	char expected[512];
+	assert(ejfpSerialize(&ejfp, fieldVariants, 3, expected, sizeof(expected)) == kSize);
+	assert(output == expected);
+}
+
+OHDEBUG_TEST("Frame: Checksum of objects longer than a batch, contiguous, and in CBOR")
+{
+	const EjfpCrcParameters kParameters = EJFP_CRC32;
+	uint32_t table[EJFP_CRC_TABLE_SIZE];
+	EjfpCrc crc;
+	ejfpCrcInitialize(&crc, &kParameters, table, EJFP_CRC_TABLE_SIZE);
+	std::string longString;
+
+	for (int i = 0; i < 300; ++i) {
+		longString += i % 7 == 0 ? '"' : static_cast<char>('a' + i % 26);
+	}
+
+	EjfpFieldVariant fieldVariants[2] {{EjfpFieldVariantTypeString, "payload"}, {EjfpFieldVariantTypeString, "tail"}};
+	fieldVariants[0].stringValue = longString.c_str();
+	fieldVariants[1].stringValue = longString.c_str() + 100;
+
+	// Contiguous sink
+	char object[1024];
+	EjfpSink sink;
+	ejfpSinkInitialize(&sink, object, sizeof(object), nullptr, nullptr);
+	ejfpSinkSetCrc(&sink, &crc);
+	const int kSize = ejfpSerializeToSink(nullptr, fieldVariants, 2, &sink);
+	assert(kSize > 2 * 256);  // Several batches
+	assert(ejfpSinkCrc(&sink) == ejfpCrcCompute(&crc, object, kSize));
+
+	// CBOR through a flushed sink is the same as the contiguous encoding
+	std::string output;
+	char scratch[13];
+	ejfpSinkInitialize(&sink, scratch, sizeof(scratch), flushAppend, &output);
+	ejfpSinkSetCrc(&sink, &crc);
+	const int kCborSize = ejfpCborSerializeToSink(fieldVariants, 2, &sink);
+	assert(kCborSize > 300 && output.size() == static_cast<std::size_t>(kCborSize));
+	assert(ejfpCborSerialize(fieldVariants, 2, object, sizeof(object)) == kCborSize);
+	assert(output == std::string(object, kCborSize));
+	assert(ejfpSinkCrc(&sink) == ejfpCrcCompute(&crc, object, kCborSize));
+
+	// Framed CBOR
+	const EjfpFrameFormat kFormat{&crc, 2};
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	ejfpSetEncoding(&ejfp, EjfpEncodingCbor);
+	char frame[1024];
+	assert(ejfpSerializeFramed(&ejfp, &kFormat, fieldVariants, 2, frame, sizeof(frame)) == kCborSize + 6);
+	const uint32_t kCrc = ejfpCrcCompute(&crc, frame + 2, kCborSize);
+	assert(memcmp(frame + 2 + kCborSize, &kCrc, 4) == 0);  // Little-endian host
+}
+
+int main(void)
+{
+	OHDEBUG("Trace", "frame_test");
+	OHDEBUG_RUN_TESTS();
+
+	return 0;
+}
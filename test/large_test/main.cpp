@@ -0,0 +1,103 @@
+#define OHDEBUG_PORT_ENABLE 1
+#define OHDEBUG_TAGS_ENABLE "Trace"
+
+#include <OhDebug.hpp>
+
+#include <ejfp/deserialization.h>
+#include <ejfp/error.h>
+#include <ejfp/stream.h>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static constexpr std::size_t kChunkSize = 1 << 20;
+static constexpr std::size_t kFourGiB = (std::size_t)1 << 32;
+
+OHDEBUG_TEST("Large input: positions past 4 GiB in a single object")
+{
+	// An object w/ 4 GiB of whitespace b/w its fields. The whitespace is a single chunk of memory mapped over and over,
+	// so it costs neither RAM, nor disk space
+	const std::size_t kNChunks = kFourGiB / kChunkSize + 2;
+	const std::size_t kSize = kNChunks * kChunkSize;
+	const int kFd = memfd_create("large_test", 0);
+	assert(kFd >= 0);
+	assert(ftruncate(kFd, 3 * kChunkSize) == 0);
+	char *chunks = (char *)mmap(nullptr, 3 * kChunkSize, PROT_READ | PROT_WRITE, MAP_SHARED, kFd, 0);
+	assert(chunks != MAP_FAILED);
+	memset(chunks, ' ', 3 * kChunkSize);
+	memcpy(chunks, "{\"first\": 1,", 12);
+	memcpy(chunks + 3 * kChunkSize - 23, "\"last\": \"4 GiB later\"}", 23);
+
+	char *input = (char *)mmap(nullptr, kSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	assert(input != MAP_FAILED);
+
+	for (std::size_t i = 0; i < kNChunks; ++i) {
+		const off_t kOffset = i == 0 ? 0 : i + 1 == kNChunks ? 2 * kChunkSize : kChunkSize;
+		assert(mmap(input + i * kChunkSize, kChunkSize, PROT_READ, MAP_SHARED | MAP_FIXED, kFd, kOffset)
+			== input + i * kChunkSize);
+	}
+
+	Ejfp ejfp;
+	ejfpInitialize(&ejfp);
+	EjfpFieldVariant fieldVariants[2] {};
+	const int kNFieldVariants = ejfpDeserialize(&ejfp, fieldVariants, 2, input, kSize);
+	OHDEBUG("Trace", "fields", kNFieldVariants, "last at", (std::size_t)(fieldVariants[1].fieldName - input));
+	assert(kNFieldVariants == 2);
+	assert(fieldVariants[0].fieldType == EjfpFieldVariantTypeInteger && fieldVariants[0].integerValue == 1);
+	assert((std::size_t)(fieldVariants[1].fieldName - input) > kFourGiB);
+	assert(fieldVariants[1].fieldNameLength == 4 && memcmp(fieldVariants[1].fieldName, "last", 4) == 0);
+	assert(fieldVariants[1].fieldType == EjfpFieldVariantTypeString);
+	assert(fieldVariants[1].stringValueLength == 11 && memcmp(fieldVariants[1].stringValue, "4 GiB later", 11) == 0);
+
+	munmap(input, kSize);
+	munmap(chunks, 3 * kChunkSize);
+	close(kFd);
+}
+
+OHDEBUG_TEST("Large input: stream over a sparse file")
+{
+	// Objects at the start and past 4 GiB of a sparse file, w/ a hole (NULL characters) in between
+	static constexpr const char kFirst[] = "{\"seq\": 1}\n";
+	static constexpr const char kSecond[] = "{\"seq\": 2}\n";
+	const std::size_t kSecondOffset = kFourGiB + 4321;
+	const std::size_t kSize = kFourGiB + kChunkSize;
+	const int kFd = memfd_create("large_test", 0);  // Holes are cheaper to read in memory than on disk
+	assert(kFd >= 0);
+	assert(ftruncate(kFd, (off_t)kSize) == 0);
+	assert(pwrite(kFd, kFirst, sizeof(kFirst) - 1, 0) == sizeof(kFirst) - 1);
+	assert(pwrite(kFd, kSecond, sizeof(kSecond) - 1, (off_t)kSecondOffset) == sizeof(kSecond) - 1);
+	char *buffer = (char *)mmap(nullptr, kSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_NORESERVE, kFd, 0);
+	assert(buffer != MAP_FAILED);
+	madvise(buffer, kSize, MADV_SEQUENTIAL);
+
+	EjfpStream stream;
+	Ejfp ejfp;
+	EjfpFieldVariant fieldVariant {};
+	ejfpInitialize(&ejfp);
+	ejfpStreamInitialize(&stream, buffer, kSize);
+	ejfpStreamSetRecovery(&stream, 1);  // Skip the hole at once
+	ejfpStreamCommit(&stream, kSize);
+
+	assert(ejfpStreamNext(&stream, &ejfp, &fieldVariant, 1) == 1);
+	assert(fieldVariant.integerValue == 1);
+	assert(ejfpStreamNext(&stream, &ejfp, &fieldVariant, 1) == 1);
+	assert(fieldVariant.integerValue == 2);
+	assert((std::size_t)(fieldVariant.fieldName - buffer) > kFourGiB);
+	assert(ejfpStreamNext(&stream, &ejfp, &fieldVariant, 1) == EjfpErrorDeserializationPartitioned);
+	OHDEBUG("Trace", "skipped", ejfpStreamSkipped(&stream));
+	assert(ejfpStreamSkipped(&stream) == kSize - (sizeof(kFirst) - 1) - (sizeof(kSecond) - 1));
+
+	munmap(buffer, kSize);
+	close(kFd);
+}
+
+int main(void)
+{
+	OHDEBUG("Trace", "large_test");
+	OHDEBUG_RUN_TESTS();
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+#define OHDEBUG_PORT_ENABLE 1
+#define OHDEBUG_TAGS_ENABLE "Trace"
+
+#include <OhDebug.hpp>
+
+#include <ejfp/cbor.h>
+#include <ejfp/deserialization.h>
+#include <ejfp/error.h>
+#include <ejfp/serialization.h>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+OHDEBUG_TEST("Minimal profile: Supported types")
+{
+	static constexpr const char *kInput = "{\"id\": -42, \"name\": \"drone\", \"armed\": true, \"mode\": null}";
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	EjfpFieldVariant fieldVariants[4] {};
+	const int nFieldVariants = ejfpDeserialize(&ejfp, fieldVariants, 4, kInput, strlen(kInput));
+	assert(nFieldVariants == 4);
+	assert(fieldVariants[0].fieldType == EjfpFieldVariantTypeInteger && fieldVariants[0].integerValue == -42);
+	assert(fieldVariants[1].fieldType == EjfpFieldVariantTypeString);
+	assert(fieldVariants[2].fieldType == EjfpFieldVariantTypeBoolean && fieldVariants[2].booleanValue);
+	assert(fieldVariants[3].fieldType == EjfpFieldVariantTypeNull);
+
+	char output[128] {};
+	EjfpFieldVariant outputFieldVariants[3] {
+		{EjfpFieldVariantTypeInteger, "id"},
+		{EjfpFieldVariantTypeBoolean, "armed"},
+		{EjfpFieldVariantTypeNull, "mode"},
+	};
+	outputFieldVariants[0].integerValue = -42;
+	outputFieldVariants[1].booleanValue = 1;
+	ejfpSerialize(&ejfp, outputFieldVariants, 3, output, sizeof(output));
+	OHDEBUG("Trace", output);
+	assert(std::string(output) == "{\"id\":-42,\"armed\":true,\"mode\":null}");
+}
+
+OHDEBUG_TEST("Minimal profile: Disabled types are rejected")
+{
+	static constexpr const char *kInputs[] = {
+		"{\"speed\": 1.5}",
+		"{\"uptime\": 5000000000}",
+		"{\"offset\": -5000000000}",
+	};
+
+	for (const char *input : kInputs) {
+		Ejfp ejfp{};
+		ejfpInitialize(&ejfp);
+		EjfpFieldVariant fieldVariant{};
+		const int result = ejfpDeserialize(&ejfp, &fieldVariant, 1, input, strlen(input));
+		OHDEBUG("Trace", input, "->", result);
+		assert(result == EjfpErrorDeserializationUnsupportedJsonStructure);
+	}
+
+	// CBOR: {"a": 1.5} (half precision)
+	static constexpr const unsigned char kCbor[] = {0xa1, 0x61, 'a', 0xf9, 0x3e, 0x00};
+	EjfpFieldVariant fieldVariant{};
+	assert(ejfpCborDeserialize(&fieldVariant, 1, (const char *)kCbor, sizeof(kCbor))
+		== EjfpErrorDeserializationUnsupportedJsonStructure);
+}
+
+int main(void)
+{
+	OHDEBUG("Trace", "minimal_test");
+	OHDEBUG_RUN_TESTS();
+
+	return 0;
+}
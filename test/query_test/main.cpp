@@ -0,0 +1,152 @@
+#define OHDEBUG_PORT_ENABLE 1
+#define OHDEBUG_TAGS_ENABLE "Trace"
+
+#include <OhDebug.hpp>
+
+#include <ejfp/error.h>
+#include <ejfp/query.h>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+static constexpr const char *kDocument = "{\"id\": 7, \"sensors\": [{\"temp\": 21.5, \"name\": \"a\"}, "
+	"{\"temp\": -3, \"name\": \"b\"}, [1, 2], {\"name\": \"d\", \"temp\": 40}], "
+	"\"meta\": {\"a/b\": true, \"m~n\": null, \"\": \"empty\", \"nested\": {\"deep\": [[], {}, \"x\"]}}}";
+
+OHDEBUG_TEST("Query: Pointers into a nested document")
+{
+	jsmntok_t tokens[64];
+	EjfpDocument document;
+	const int kNTokens = ejfpDocumentIndex(&document, tokens, 64, kDocument, strlen(kDocument));
+	OHDEBUG("Trace", "tokens", kNTokens);
+	assert(kNTokens > 0);
+	assert(tokens[0].size == kNTokens);  // The root subtree spans the document
+
+	EjfpFieldVariant fieldVariant;
+	assert(ejfpDocumentQuery(&document, "/sensors/3/temp", &fieldVariant) == 1);
+	assert(fieldVariant.fieldType == EjfpFieldVariantTypeInteger && fieldVariant.integerValue == 40);
+	assert(std::string(fieldVariant.fieldName, fieldVariant.fieldNameLength) == "temp");
+	assert(ejfpDocumentQuery(&document, "/sensors/1/name", &fieldVariant) == 1);
+	assert(fieldVariant.fieldType == EjfpFieldVariantTypeString);
+	assert(std::string(fieldVariant.stringValue, fieldVariant.stringValueLength) == "b");
+	assert(ejfpDocumentQuery(&document, "/sensors/0/temp", &fieldVariant) == 1);
+	assert(fieldVariant.fieldType == EjfpFieldVariantTypeFloat);
+	assert(ejfpDocumentQuery(&document, "/sensors/2/1", &fieldVariant) == 1);
+	assert(fieldVariant.integerValue == 2 && fieldVariant.fieldName == nullptr);
+	assert(ejfpDocumentQuery(&document, "/meta/a~1b", &fieldVariant) == 1);
+	assert(fieldVariant.fieldType == EjfpFieldVariantTypeBoolean);
+	assert(ejfpDocumentQuery(&document, "/meta/m~0n", &fieldVariant) == 1);
+	assert(fieldVariant.fieldType == EjfpFieldVariantTypeNull);
+	assert(ejfpDocumentQuery(&document, "/meta/", &fieldVariant) == 1);
+	assert(std::string(fieldVariant.stringValue, fieldVariant.stringValueLength) == "empty");
+	assert(ejfpDocumentQuery(&document, "/meta/nested/deep/2", &fieldVariant) == 1);
+	assert(std::string(fieldVariant.stringValue, fieldVariant.stringValueLength) == "x");
+	assert(ejfpDocumentQuery(&document, "/id", &fieldVariant) == 1 && fieldVariant.integerValue == 7);
+
+	// Containers are found, but not converted
+	assert(ejfpDocumentQuery(&document, "", &fieldVariant) == EjfpErrorDeserializationUnsupportedJsonStructure);
+	assert(ejfpDocumentQuery(&document, "/sensors", &fieldVariant)
+		== EjfpErrorDeserializationUnsupportedJsonStructure);
+
+	for (const char *pointer : {"/sensors/4", "/sensors/-", "/sensors/01", "/sensors/name", "/id/0", "/nope",
+		"/meta/nested/deep/0/0", "/meta/nested/deep/1/x", "/meta/a/b"}) {
+		OHDEBUG("Trace", pointer);
+		assert(ejfpDocumentQuery(&document, pointer, &fieldVariant) == EjfpErrorQueryNotFound);
+	}
+
+	assert(ejfpDocumentQuery(&document, "id", &fieldVariant) == EjfpErrorQueryInvalidPath);
+	assert(ejfpDocumentQuery(&document, "/meta/~2", &fieldVariant) == EjfpErrorQueryInvalidPath);
+	assert(ejfpDocumentQuery(&document, "/meta/~", &fieldVariant) == EjfpErrorQueryInvalidPath);
+}
+
+OHDEBUG_TEST("Query: Compiled paths and relative lookups")
+{
+	EjfpPathSegment segments[3];
+	EjfpPath path;
+	assert(ejfpPathCompile(&path, segments, 3, "/sensors") == 1);
+	assert(ejfpPathCompile(&path, segments, 2, "/a/b/c") == EjfpErrorQueryNoMemory);
+
+	jsmntok_t tokens[64];
+	EjfpDocument document;
+	assert(ejfpDocumentIndex(&document, tokens, 64, kDocument, strlen(kDocument)) > 0);
+	assert(ejfpPathCompile(&path, segments, 3, "/sensors") == 1);
+	const int kSensors = ejfpDocumentFind(&document, 0, &path);
+	assert(kSensors > 0 && tokens[kSensors].type == JSMN_ARRAY);
+
+	// Lookups relative to the array reuse both the index, and the compiled path
+	EjfpFieldVariant fieldVariant;
+	const int kExpected[] = {21, -3, 0, 40};
+	EjfpPathSegment temperatureSegments[2];
+	EjfpPath temperaturePath;
+
+	for (int i = 0; i < 4; ++i) {
+		const std::string kPointer = "/" + std::to_string(i) + "/temp";
+		assert(ejfpPathCompile(&temperaturePath, temperatureSegments, 2, kPointer.c_str()) == 2);
+		const int kToken = ejfpDocumentFind(&document, kSensors, &temperaturePath);
+
+		if (i == 2) {
+			assert(kToken == EjfpErrorQueryNotFound);  // An array w/o keys
+			continue;
+		}
+
+		assert(ejfpDocumentValue(&document, kToken, &fieldVariant) == 1);
+		assert(fieldVariant.fieldType == EjfpFieldVariantTypeFloat ? (int)fieldVariant.floatValue == kExpected[i]
+			: fieldVariant.integerValue == kExpected[i]);
+	}
+
+	// The same path, another document
+	static constexpr const char *kOther = "{\"sensors\": [{\"temp\": 1}, {\"temp\": 2}, {}, {\"temp\": 4}]}";
+	EjfpDocument other;
+	assert(ejfpDocumentIndex(&other, tokens, 64, kOther, strlen(kOther)) == 13);
+	assert(ejfpPathCompile(&path, segments, 3, "/sensors/3/temp") == 3);
+	const int kToken = ejfpDocumentFind(&other, 0, &path);
+	assert(ejfpDocumentValue(&other, kToken, &fieldVariant) == 1 && fieldVariant.integerValue == 4);
+}
+
+OHDEBUG_TEST("Query: Errors")
+{
+	jsmntok_t tokens[8];
+	EjfpDocument document;
+	EjfpFieldVariant fieldVariant;
+	static constexpr const char *kPartitioned = "{\"a\": [1, 2";
+	assert(ejfpDocumentIndex(&document, tokens, 8, kPartitioned, strlen(kPartitioned))
+		== EjfpErrorDeserializationPartitioned);
+	assert(ejfpDocumentIndex(&document, tokens, 8, "  ", 2) == EjfpErrorDeserializationPartitioned);
+	static constexpr const char *kLarge = "[1, 2, 3, 4, 5, 6, 7, 8]";
+	assert(ejfpDocumentIndex(&document, tokens, 8, kLarge, strlen(kLarge)) == EjfpErrorDeserializationNoMemory);
+	assert(ejfpDocumentIndex(&document, tokens, 8, "{\"a\": ]", 7) == EjfpErrorDeserializationInvalidSyntax);
+
+	// Not found in a document which has failed to index
+	assert(ejfpDocumentQuery(&document, "", &fieldVariant) == EjfpErrorQueryNotFound);
+
+	for (const char *input : {"{a: 1}", "{\"a\" 1}", "{\"a\": 1,}", "[1 2]", "[1,]", "{\"a\": 1]", "{} {}",
+		"[\"\\x\"]", "{\"a\":}"}) {
+		OHDEBUG("Trace", input);
+		assert(ejfpDocumentIndex(&document, tokens, 8, input, strlen(input)) == EjfpErrorDeserializationInvalidSyntax);
+	}
+
+	// A number at the end of input may go on
+	assert(ejfpDocumentIndex(&document, tokens, 8, "12", 2) == EjfpErrorDeserializationPartitioned);
+	assert(ejfpDocumentIndex(&document, tokens, 8, "12 ", 3) == 1);
+	assert(ejfpDocumentQuery(&document, "", &fieldVariant) == 1 && fieldVariant.integerValue == 12);
+
+	// Pointers are compiled into a fixed-size array, however long they are
+	std::string pointer;
+
+	for (std::size_t i = 0; i < EJFP_QUERY_SEGMENTS_MAX; ++i) {
+		pointer += "/a";
+	}
+
+	assert(ejfpDocumentQuery(&document, pointer.c_str(), &fieldVariant) == EjfpErrorQueryNotFound);
+	pointer += "/a";
+	assert(ejfpDocumentQuery(&document, pointer.c_str(), &fieldVariant) == EjfpErrorQueryNoMemory);
+}
+
+int main(void)
+{
+	OHDEBUG("Trace", "query_test");
+	OHDEBUG_RUN_TESTS();
+
+	return 0;
+}
@@ -3,11 +3,25 @@
 
 #include <OhDebug.hpp>
 
+#include <ejfp/cbor.h>
+#include <ejfp/delta.h>
 #include <ejfp/deserialization.h>
+#include <ejfp/error.h>
+#include <ejfp/iovec.h>
 #include <ejfp/print.h>
+#include <ejfp/ringInput.h>
+#include <ejfp/router.h>
 #include <ejfp/serialization.h>
+#include <ejfp/serializationPlan.h>
+#include <ejfp/sink.h>
+#include <ejfp/validation.h>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
 
 OHDEBUG_TEST("Serialization: Basic output")
 {
@@ -54,8 +68,8 @@ OHDEBUG_TEST("Deserialization: Basic input")
 	Ejfp ejfp{};
 	EjfpFieldVariant ejfpFieldVariants[kNEjfpFieldVariants] = {};
 	ejfpInitialize(&ejfp);
-	int error = ejfpDeserialize(&ejfp, ejfpFieldVariants, kNEjfpFieldVariants, input, inputLength);
-	OHDEBUG("Trace", "error code:", error);
+	int nParsed = ejfpDeserialize(&ejfp, ejfpFieldVariants, kNEjfpFieldVariants, input, inputLength);
+	OHDEBUG("Trace", "parsed:", nParsed);
 
 	for (std::size_t i = 0; i < kNEjfpFieldVariants; ++i) {
 		ejfpFieldVariantPrint(&ejfpFieldVariants[i]);
@@ -63,6 +77,718 @@ OHDEBUG_TEST("Deserialization: Basic input")
 	}
 }
 
+OHDEBUG_TEST("Serialization, deserialization: 64-bit integers and doubles")
+{
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	constexpr std::size_t kNFieldVariants = 5;
+	constexpr std::size_t kOutputBufferSize = 256;
+	char outputBuffer[kOutputBufferSize] = {0};
+	EjfpFieldVariant ejfpFieldVariants[kNFieldVariants] {
+		{EjfpFieldVariantTypeInteger64, "timestamp"},
+		{EjfpFieldVariantTypeUnsignedInteger64, "id"},
+		{EjfpFieldVariantTypeDouble, "latitude"},
+		{EjfpFieldVariantTypeInteger64, "negative"},
+		{EjfpFieldVariantTypeFloat, "float"},
+	};
+	ejfpFieldVariants[0].integer64Value = 1684411200123456789LL;
+	ejfpFieldVariants[1].unsignedInteger64Value = UINT64_MAX;
+	ejfpFieldVariants[2].doubleValue = 59.93863123456789;
+	ejfpFieldVariants[3].integer64Value = INT64_MIN;
+	ejfpFieldVariants[4].floatValue = 0.5f;
+	int outputSize = ejfpSerialize(&ejfp, ejfpFieldVariants, kNFieldVariants, outputBuffer, kOutputBufferSize);
+	OHDEBUG("Trace", "outputBuffer", outputBuffer, "outputSize", outputSize);
+	assert(outputSize > 0);
+
+	EjfpFieldVariant parsed[kNFieldVariants] = {};
+	ejfpInitialize(&ejfp);
+	int nParsed = ejfpDeserialize(&ejfp, parsed, kNFieldVariants, outputBuffer, outputSize);
+	assert(nParsed == kNFieldVariants);
+
+	for (std::size_t i = 0; i < kNFieldVariants; ++i) {
+		ejfpFieldVariantPrint(&parsed[i]);
+		std::cout << std::endl;
+		assert(parsed[i].fieldType == ejfpFieldVariants[i].fieldType);
+	}
+
+	assert(parsed[0].integer64Value == ejfpFieldVariants[0].integer64Value);
+	assert(parsed[1].unsignedInteger64Value == ejfpFieldVariants[1].unsignedInteger64Value);
+	assert(parsed[2].doubleValue == ejfpFieldVariants[2].doubleValue);
+	assert(parsed[3].integer64Value == ejfpFieldVariants[3].integer64Value);
+	assert(parsed[4].floatValue == ejfpFieldVariants[4].floatValue);
+}
+
+OHDEBUG_TEST("Serialization: compiled plan matches the generic path")
+{
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	constexpr std::size_t kNFieldVariants = 5;
+	constexpr std::size_t kOutputBufferSize = 256;
+	EjfpFieldVariant layout[kNFieldVariants] {
+		{EjfpFieldVariantTypeString, "message"},
+		{EjfpFieldVariantTypeInteger, "id"},
+		{EjfpFieldVariantTypeBoolean, "activated"},
+		{EjfpFieldVariantTypeDouble, "voltage"},
+		{EjfpFieldVariantTypeInteger64, "timestamp"},
+	};
+	layout[0].stringValueLength = 16;
+	EjfpSerializationPlanEntry entries[kNFieldVariants];
+	char fragments[128];
+	EjfpSerializationPlan plan;
+	int fragmentsSize = ejfpSerializationPlanCompile(&plan, entries, kNFieldVariants, fragments, sizeof(fragments),
+		layout, kNFieldVariants);
+	OHDEBUG("Trace", "fragments size", fragmentsSize, "max output size", plan.maxOutputSize);
+	assert(fragmentsSize > 0);
+
+	EjfpFieldVariant values[kNFieldVariants] {
+		{EjfpFieldVariantTypeString, "message"},
+		{EjfpFieldVariantTypeInteger, "id"},
+		{EjfpFieldVariantTypeBoolean, "activated"},
+		{EjfpFieldVariantTypeDouble, "voltage"},
+		{EjfpFieldVariantTypeInteger64, "timestamp"},
+	};
+
+	for (int i = 0; i < 3; ++i) {
+		char expected[kOutputBufferSize] = {0};
+		char actual[kOutputBufferSize] = {0};
+		values[0].stringValue = i == 1 ? "with \"quotes\"" : "Hello";
+		values[1].integerValue = -1000 * i;
+		values[2].booleanValue = i % 2;
+		values[3].doubleValue = 3.3 * i;
+		values[4].integer64Value = 1684411200123456789LL + i;
+		int expectedSize = ejfpSerialize(&ejfp, values, kNFieldVariants, expected, kOutputBufferSize);
+		int actualSize = ejfpSerializeWithPlan(&plan, values, kNFieldVariants, actual, plan.maxOutputSize);
+		OHDEBUG("Trace", actual);
+		assert(actualSize == expectedSize);
+		assert(std::strcmp(expected, actual) == 0);
+		assert(ejfpSerializeWithPlan(&plan, values, kNFieldVariants, actual, actualSize) ==
+			EjfpErrorSerializationNoMemory);
+	}
+}
+
+OHDEBUG_TEST("Serialization: compiled plan w/ unsupported types and booleans")
+{
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	EjfpSerializationPlanEntry entries[2];
+	char fragments[64];
+	EjfpSerializationPlan plan;
+	EjfpFieldVariant layout[2] {{EjfpFieldVariantTypeInteger, "id"}, {EjfpFieldVariantTypeUninitialized, "unset"}};
+	assert(ejfpSerializationPlanCompile(&plan, entries, 2, fragments, sizeof(fragments), layout, 2)
+		== EjfpErrorSerializationUnsupportedType);
+	layout[1].fieldType = static_cast<EjfpFieldVariantType>(EjfpFieldVariantTypeBinary + 1);
+	assert(ejfpSerializationPlanCompile(&plan, entries, 2, fragments, sizeof(fragments), layout, 2)
+		== EjfpErrorSerializationUnsupportedType);
+
+	// Any non-zero value is `true`, whichever way it is serialized
+	layout[1].fieldType = EjfpFieldVariantTypeBoolean;
+	assert(ejfpSerializationPlanCompile(&plan, entries, 2, fragments, sizeof(fragments), layout, 2) > 0);
+	EjfpFieldVariant values[2] {{EjfpFieldVariantTypeInteger, "id"}, {EjfpFieldVariantTypeBoolean, "unset"}};
+	char expected[64];
+	char actual[64];
+
+	for (int booleanValue : {0, 1, 2, 256, -1}) {
+		values[1].booleanValue = booleanValue;
+		const int kSize = ejfpSerialize(&ejfp, values, 2, expected, sizeof(expected));
+		assert(ejfpSerializeWithPlan(&plan, values, 2, actual, sizeof(actual)) == kSize);
+		assert(std::strcmp(expected, actual) == 0);
+		assert(std::strcmp(actual, booleanValue != 0 ? "{\"id\":0,\"unset\":true}" : "{\"id\":0,\"unset\":false}")
+			== 0);
+	}
+}
+
+OHDEBUG_TEST("Serialization: exact output size")
+{
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	constexpr std::size_t kNFieldVariants = 6;
+	EjfpFieldVariant ejfpFieldVariants[kNFieldVariants] {
+		{EjfpFieldVariantTypeString, "string"},
+		{EjfpFieldVariantTypeInteger, "integer"},
+		{EjfpFieldVariantTypeNull, "null"},
+		{EjfpFieldVariantTypeFloat, "float"},
+		{EjfpFieldVariantTypeUnsignedInteger64, "id"},
+		{EjfpFieldVariantTypeBoolean, "boolean"},
+	};
+	ejfpFieldVariants[0].stringValue = "\"escaped\\\"";
+	ejfpFieldVariants[1].integerValue = -42;
+	ejfpFieldVariants[3].floatValue = 1e-3f;
+	ejfpFieldVariants[4].unsignedInteger64Value = 1234567890123ULL;
+	ejfpFieldVariants[5].booleanValue = 1;
+
+	for (std::size_t nFieldVariants = 0; nFieldVariants <= kNFieldVariants; ++nFieldVariants) {
+		const std::size_t size = ejfpSerializedSize(ejfpFieldVariants, nFieldVariants);
+		char outputBuffer[256] = {0};
+		OHDEBUG("Trace", "fields", nFieldVariants, "size", size);
+		assert(ejfpSerialize(&ejfp, ejfpFieldVariants, nFieldVariants, outputBuffer, size) == 0);
+		assert(ejfpSerialize(&ejfp, ejfpFieldVariants, nFieldVariants, outputBuffer, size + 1) == (int)size);
+		assert(std::strlen(outputBuffer) == size);
+	}
+
+	const std::size_t exact = ejfpSerializedSize(ejfpFieldVariants, kNFieldVariants);
+	ejfpFieldVariants[0].stringValueLength = 13;
+	const std::size_t upperBound = ejfpSerializedSizeUpperBound(ejfpFieldVariants, kNFieldVariants);
+	OHDEBUG("Trace", "upper bound", upperBound);
+	assert(upperBound > exact);
+	ejfpFieldVariants[0].stringValueLength = 0;
+	assert(ejfpSerializedSizeUpperBound(ejfpFieldVariants, kNFieldVariants) == 0);
+}
+
+OHDEBUG_TEST("Serialization: exact output size w/ names and strings which are not NULL-terminated")
+{
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	static constexpr const char *kInput = "identifier, labels";
+	EjfpFieldVariant ejfpFieldVariants[2] {
+		{EjfpFieldVariantTypeInteger, kInput},
+		{EjfpFieldVariantTypeString, kInput + 12},
+	};
+	ejfpFieldVariants[0].fieldNameLength = 2;  // "id"
+	ejfpFieldVariants[0].integerValue = 7;
+	ejfpFieldVariants[1].fieldNameLength = 5;  // "label"
+	ejfpFieldVariants[1].stringValue = kInput;
+	ejfpFieldVariants[1].stringValueLength = 5;  // "ident"
+	const std::size_t exact = ejfpSerializedSize(ejfpFieldVariants, 2);
+	char outputBuffer[64] = {0};
+	assert(ejfpSerialize(&ejfp, ejfpFieldVariants, 2, outputBuffer, sizeof(outputBuffer)) == (int)exact);
+	OHDEBUG("Trace", outputBuffer);
+	assert(std::strcmp(outputBuffer, "{\"id\":7,\"label\":\"ident\"}") == 0);
+
+	// The upper bound takes the same name lengths
+	const std::size_t upperBound = ejfpSerializedSizeUpperBound(ejfpFieldVariants, 2);
+	assert(exact < upperBound);
+}
+
+OHDEBUG_TEST("Serialization: streaming into a sink w/ a tiny scratch buffer")
+{
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	constexpr std::size_t kNFieldVariants = 4;
+	EjfpFieldVariant ejfpFieldVariants[kNFieldVariants] {
+		{EjfpFieldVariantTypeString, "string"},
+		{EjfpFieldVariantTypeDouble, "double"},
+		{EjfpFieldVariantTypeInteger64, "integer64"},
+		{EjfpFieldVariantTypeString, "escaped \"key\""},
+	};
+	ejfpFieldVariants[0].stringValue = "A string which is longer than the scratch buffer";
+	ejfpFieldVariants[1].doubleValue = -123.456789012345;
+	ejfpFieldVariants[2].integer64Value = -1684411200123456789LL;
+	ejfpFieldVariants[3].stringValue = "\\\"\\\"";
+	char expected[256] = {0};
+	const int expectedSize = ejfpSerialize(&ejfp, ejfpFieldVariants, kNFieldVariants, expected, sizeof(expected));
+
+	for (std::size_t scratchSize = 1; scratchSize < 9; ++scratchSize) {
+		std::string output;
+		char scratch[9];
+		EjfpSink sink;
+		ejfpSinkInitialize(&sink, scratch, scratchSize,
+			[](void *aContext, const char *aData, std::size_t aDataSize) {
+				static_cast<std::string *>(aContext)->append(aData, aDataSize);
+
+				return 0;
+			}, &output);
+		const int outputSize = ejfpSerializeToSink(&ejfp, ejfpFieldVariants, kNFieldVariants, &sink);
+		assert(outputSize == expectedSize);
+		assert(output == expected);
+	}
+
+	// Contiguous mode, w/o a flush callback
+	char contiguous[256];
+	EjfpSink sink;
+	ejfpSinkInitialize(&sink, contiguous, expectedSize, nullptr, nullptr);
+	assert(ejfpSerializeToSink(&ejfp, ejfpFieldVariants, kNFieldVariants, &sink) == expectedSize);
+	assert(std::memcmp(contiguous, expected, expectedSize) == 0);
+	ejfpSinkInitialize(&sink, contiguous, expectedSize - 1, nullptr, nullptr);
+	assert(ejfpSerializeToSink(&ejfp, ejfpFieldVariants, kNFieldVariants, &sink) == EjfpErrorSerializationNoMemory);
+	OHDEBUG("Trace", expected);
+
+	// W/o a scratch buffer, flushing does not help
+	std::size_t nFlushes = 0;
+	ejfpSinkInitialize(&sink, contiguous, 0,
+		[](void *aContext, const char *, std::size_t) {
+			++*static_cast<std::size_t *>(aContext);
+
+			return 0;
+		}, &nFlushes);
+	assert(ejfpSinkWrite(&sink, "{}", 2) == EjfpErrorSerializationNoMemory);
+	assert(ejfpSerializeToSink(&ejfp, ejfpFieldVariants, kNFieldVariants, &sink) == EjfpErrorSerializationNoMemory);
+	assert(nFlushes == 0);
+}
+
+OHDEBUG_TEST("Serialization: scatter-gather output over a socketpair")
+{
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	constexpr std::size_t kNFieldVariants = 4;
+	const std::string blob(4096, 'b');
+	EjfpFieldVariant ejfpFieldVariants[kNFieldVariants] {
+		{EjfpFieldVariantTypeString, "blob"},
+		{EjfpFieldVariantTypeInteger, "sequence"},
+		{EjfpFieldVariantTypeString, "escaped"},
+		{EjfpFieldVariantTypeString, "short"},
+	};
+	ejfpFieldVariants[0].stringValue = blob.c_str();
+	ejfpFieldVariants[1].integerValue = 7;
+	ejfpFieldVariants[2].stringValue = "Long enough to be referenced in place, but it has to be \"escaped\"";
+	ejfpFieldVariants[3].stringValue = "copied";
+	char expected[8192] = {0};
+	const int expectedSize = ejfpSerialize(&ejfp, ejfpFieldVariants, kNFieldVariants, expected, sizeof(expected));
+	assert(expectedSize > 0);
+
+	struct iovec iovecs[8];
+	char scratch[256];
+	const int nIovecs = ejfpSerializeToIovec(&ejfp, ejfpFieldVariants, kNFieldVariants, iovecs, 8, scratch,
+		sizeof(scratch));
+	OHDEBUG("Trace", "iovec entries", nIovecs);
+	assert(nIovecs == 3);
+	assert(iovecs[1].iov_base == blob.c_str());
+
+	int sockets[2];
+	assert(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+	assert(writev(sockets[0], iovecs, nIovecs) == expectedSize);
+	close(sockets[0]);
+	std::string received;
+	char chunk[1024];
+
+	for (ssize_t n = 0; (n = read(sockets[1], chunk, sizeof(chunk))) > 0;) {
+		received.append(chunk, n);
+	}
+
+	close(sockets[1]);
+	assert(received == expected);
+	assert(ejfpSerializeToIovec(&ejfp, ejfpFieldVariants, kNFieldVariants, iovecs, 2, scratch, sizeof(scratch))
+		== EjfpErrorSerializationNoMemory);
+}
+
+OHDEBUG_TEST("Deserialization: ring buffer input wrapping around")
+{
+	constexpr const char *message = "{\"temperature\": -12.5, \"label\": \"sensor #1\", \"counter\": 1234567}";
+	const std::size_t messageLength = std::strlen(message);
+	constexpr std::size_t kNFieldVariants = 3;
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	EjfpFieldVariant expected[kNFieldVariants] = {};
+	assert(ejfpDeserialize(&ejfp, expected, kNFieldVariants, message, messageLength) == kNFieldVariants);
+
+	// Place the message at every possible offset of a ring, so it gets split at every byte
+	constexpr std::size_t kRingSize = 96;
+
+	for (std::size_t offset = 0; offset < kRingSize; ++offset) {
+		char ring[kRingSize];
+		char spill[16];
+		EjfpRingInput ringInput;
+		EjfpFieldVariant parsed[kNFieldVariants] = {};
+
+		for (std::size_t i = 0; i < messageLength; ++i) {
+			ring[(offset + i) % kRingSize] = message[i];
+		}
+
+		ejfpRingInputInitialize(&ringInput, ring, kRingSize, offset, messageLength);
+		assert(ejfpDeserializeRing(&ejfp, parsed, kNFieldVariants, &ringInput, spill, sizeof(spill))
+			== kNFieldVariants);
+
+		for (std::size_t i = 0; i < kNFieldVariants; ++i) {
+			assert(parsed[i].fieldType == expected[i].fieldType);
+			assert(parsed[i].fieldNameLength == expected[i].fieldNameLength);
+			assert(std::memcmp(parsed[i].fieldName, expected[i].fieldName, expected[i].fieldNameLength) == 0);
+		}
+
+		assert(parsed[0].floatValue == -12.5f);
+		assert(std::string(parsed[1].stringValue, parsed[1].stringValueLength) == "sensor #1");
+		assert(parsed[2].integerValue == 1234567);
+
+		ejfpRingInputInitialize(&ringInput, ring, kRingSize, offset, messageLength - 1);
+		assert(ejfpDeserializeRing(&ejfp, parsed, kNFieldVariants, &ringInput, spill, sizeof(spill))
+			== EjfpErrorDeserializationPartitioned);
+	}
+
+	// Only JSON is parsed from a ring
+	EjfpRingInput ringInput;
+	EjfpFieldVariant parsed[kNFieldVariants] = {};
+	ejfpRingInputInitialize(&ringInput, message, messageLength, 0, messageLength);
+	ejfpSetEncoding(&ejfp, EjfpEncodingCbor);
+	assert(ejfpDeserializeRing(&ejfp, parsed, kNFieldVariants, &ringInput, nullptr, 0)
+		== EjfpErrorDeserializationUnsupportedEncoding);
+}
+
+OHDEBUG_TEST("Deserialization: ring buffer input accepts what the contiguous one does")
+{
+	static const std::string kInputs[] = {
+		"{\"a\": 1, \"b\": \"text\"}",
+		"{}",
+		"",
+		" \n",
+		"{\"a\" 1}",  // Separators are not checked by "jsmn" in the non-strict mode
+		"{\"a\": 1 \"b\": 2}",
+		"{\"a\": 1,}",
+		"{\"a\": tru}",
+		"{\"a\": 12345678901234567890123456789012345678901234567890123456789012345678901234567890}",
+		"{\"a\": 1}}",
+		"{\"a\": 1} \"b\" 2",
+		"{\"a\": 1} x",
+		"\"a\": 1",
+		"{\"a\": 1:2}",
+		"{\"a\": 1]",
+		"{1: 2}",
+		"{\"a\": \x01}",
+		"{\"a\": 1\xff}",
+		"{\"a\": \"\\q\"}",
+		"{\"a\": \"\\u12G4\"}",
+		"{\"a\": \"\\u12\"}",
+		std::string("{\"a\": \"x\0y\"}", 13),
+		std::string("{\"a\": 1\0}", 10),
+		"{\"a\": [1]}",
+		"{\"a\": {\"b\": 1}}",
+		"{\"a\": 1",
+		"{\"a\": \"b",
+		"{\"a\": 1, \"b\": 2, \"c\": 3, \"d\": 4, \"e\": 5}",  // Does not fit
+	};
+	constexpr std::size_t kNFieldVariants = 4;
+
+	for (const std::string &input : kInputs) {
+		Ejfp ejfp{};
+		EjfpFieldVariant expected[kNFieldVariants] = {};
+		ejfpInitialize(&ejfp);
+		const int kExpected = ejfpDeserialize(&ejfp, expected, kNFieldVariants, input.data(), input.size());
+		char expectedOutput[256] = {0};
+		OHDEBUG("Trace", input.c_str(), kExpected);
+
+		if (kExpected > 0) {
+			assert(ejfpSerialize(&ejfp, expected, kExpected, expectedOutput, sizeof(expectedOutput)) > 0);
+		}
+
+		const std::size_t kRingSize = input.size() + 3;
+
+		for (std::size_t offset = 0; offset < kRingSize; ++offset) {
+			char ring[128];
+			char spill[128];
+			EjfpRingInput ringInput;
+			EjfpFieldVariant parsed[kNFieldVariants] = {};
+
+			for (std::size_t i = 0; i < input.size(); ++i) {
+				ring[(offset + i) % kRingSize] = input[i];
+			}
+
+			ejfpRingInputInitialize(&ringInput, ring, kRingSize, offset, input.size());
+			assert(ejfpDeserializeRing(&ejfp, parsed, kNFieldVariants, &ringInput, spill, sizeof(spill)) == kExpected);
+
+			if (kExpected > 0) {
+				char output[256] = {0};
+				assert(ejfpSerialize(&ejfp, parsed, kExpected, output, sizeof(output)) > 0);
+				assert(std::strcmp(output, expectedOutput) == 0);
+			}
+		}
+	}
+}
+
+OHDEBUG_TEST("Serialization: delta w/ periodic snapshots")
+{
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	constexpr std::size_t kNFieldVariants = 3;
+	EjfpFieldVariant ejfpFieldVariants[kNFieldVariants] {
+		{EjfpFieldVariantTypeInteger, "counter"},
+		{EjfpFieldVariantTypeString, "state"},
+		{EjfpFieldVariantTypeFloat, "temperature"},
+	};
+	ejfpFieldVariants[1].stringValue = "idle";
+	std::uint64_t digests[kNFieldVariants];
+	EjfpDelta delta;
+	ejfpDeltaInitialize(&delta, digests, kNFieldVariants, 4);
+	char outputBuffer[128];
+
+	// The first message is a full snapshot
+	assert(ejfpSerializeDelta(&delta, &ejfp, ejfpFieldVariants, kNFieldVariants, outputBuffer,
+		sizeof(outputBuffer)) > 0);
+	assert(std::string(outputBuffer) == "{\"counter\":0,\"state\":\"idle\",\"temperature\":0.0}");
+
+	// Nothing has changed
+	assert(ejfpSerializeDelta(&delta, &ejfp, ejfpFieldVariants, kNFieldVariants, outputBuffer,
+		sizeof(outputBuffer)) == 0);
+
+	ejfpFieldVariants[0].integerValue = 1;
+	ejfpFieldVariants[1].stringValue = "busy";
+	assert(ejfpSerializeDelta(&delta, &ejfp, ejfpFieldVariants, kNFieldVariants, outputBuffer,
+		sizeof(outputBuffer)) > 0);
+	assert(std::string(outputBuffer) == "{\"counter\":1,\"state\":\"busy\"}");
+
+	// Failed serialization must not be remembered as emitted
+	ejfpFieldVariants[2].floatValue = 21.5f;
+	assert(ejfpSerializeDelta(&delta, &ejfp, ejfpFieldVariants, kNFieldVariants, outputBuffer, 4)
+		== EjfpErrorSerializationNoMemory);
+	assert(ejfpSerializeDelta(&delta, &ejfp, ejfpFieldVariants, kNFieldVariants, outputBuffer,
+		sizeof(outputBuffer)) > 0);
+	assert(std::string(outputBuffer) == "{\"temperature\":21.5}");
+
+	// The 4-th message is a periodic snapshot
+	assert(ejfpSerializeDelta(&delta, &ejfp, ejfpFieldVariants, kNFieldVariants, outputBuffer,
+		sizeof(outputBuffer)) > 0);
+	OHDEBUG("Trace", outputBuffer);
+	assert(std::string(outputBuffer) == "{\"counter\":1,\"state\":\"busy\",\"temperature\":21.5}");
+}
+
+OHDEBUG_TEST("Serialization, deserialization: CBOR encoding")
+{
+	// RFC 8949, Appendix A: {"a": 1, "b": -1000} is a2 61 61 01 61 62 39 03 e7
+	EjfpFieldVariant vector[2] {
+		{EjfpFieldVariantTypeInteger, "a"},
+		{EjfpFieldVariantTypeInteger, "b"},
+	};
+	vector[0].integerValue = 1;
+	vector[1].integerValue = -1000;
+	char encoded[16];
+	assert(ejfpCborSerialize(vector, 2, encoded, sizeof(encoded)) == 9);
+	assert(std::memcmp(encoded, "\xa2\x61\x61\x01\x61\x62\x39\x03\xe7", 9) == 0);
+
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+	ejfpSetEncoding(&ejfp, EjfpEncodingCbor);
+	constexpr std::size_t kNFieldVariants = 8;
+	EjfpFieldVariant ejfpFieldVariants[kNFieldVariants] {
+		{EjfpFieldVariantTypeString, "string"},
+		{EjfpFieldVariantTypeInteger, "integer"},
+		{EjfpFieldVariantTypeBoolean, "boolean"},
+		{EjfpFieldVariantTypeNull, "null"},
+		{EjfpFieldVariantTypeFloat, "float"},
+		{EjfpFieldVariantTypeDouble, "double"},
+		{EjfpFieldVariantTypeInteger64, "integer64"},
+		{EjfpFieldVariantTypeUnsignedInteger64, "unsigned64"},
+	};
+	ejfpFieldVariants[0].stringValue = "Hello";
+	ejfpFieldVariants[1].integerValue = -42;
+	ejfpFieldVariants[2].booleanValue = 1;
+	ejfpFieldVariants[4].floatValue = 0.1f;
+	ejfpFieldVariants[5].doubleValue = 0.1;
+	ejfpFieldVariants[6].integer64Value = INT64_MIN;
+	ejfpFieldVariants[7].unsignedInteger64Value = UINT64_MAX;
+	char cbor[256];
+	const int cborSize = ejfpSerialize(&ejfp, ejfpFieldVariants, kNFieldVariants, cbor, sizeof(cbor));
+	assert(cborSize > 0);
+	assert(cborSize < (int)ejfpSerializedSize(ejfpFieldVariants, kNFieldVariants));
+	OHDEBUG("Trace", "CBOR size", cborSize, "JSON size", ejfpSerializedSize(ejfpFieldVariants, kNFieldVariants));
+
+	EjfpFieldVariant parsed[kNFieldVariants] = {};
+	assert(ejfpDeserialize(&ejfp, parsed, kNFieldVariants, cbor, cborSize) == kNFieldVariants);
+
+	for (std::size_t i = 0; i < kNFieldVariants; ++i) {
+		assert(parsed[i].fieldType == ejfpFieldVariants[i].fieldType);
+		assert(parsed[i].fieldNameLength == std::strlen(ejfpFieldVariants[i].fieldName));
+		assert(std::memcmp(parsed[i].fieldName, ejfpFieldVariants[i].fieldName, parsed[i].fieldNameLength) == 0);
+	}
+
+	assert(std::string(parsed[0].stringValue, parsed[0].stringValueLength) == "Hello");
+	assert(parsed[1].integerValue == -42);
+	assert(parsed[2].booleanValue);
+	assert(parsed[4].floatValue == 0.1f);
+	assert(parsed[5].doubleValue == 0.1);
+	assert(parsed[6].integer64Value == INT64_MIN);
+	assert(parsed[7].unsignedInteger64Value == UINT64_MAX);
+	assert(ejfpDeserialize(&ejfp, parsed, kNFieldVariants, cbor, cborSize - 1) == EjfpErrorDeserializationPartitioned);
+	assert(ejfpSerialize(&ejfp, ejfpFieldVariants, kNFieldVariants, cbor, cborSize - 1) == 0);
+
+	// Trailing bytes after the map
+	cbor[cborSize] = '\0';
+	assert(ejfpDeserialize(&ejfp, parsed, kNFieldVariants, cbor, cborSize + 1) == EjfpErrorDeserializationInvalidSyntax);
+
+	// {"a": -2^64}, below INT64_MIN
+	const char kBelowInt64Min[] = "\xa1\x61\x61\x3b\xff\xff\xff\xff\xff\xff\xff\xff";
+	assert(ejfpCborDeserialize(parsed, 1, kBelowInt64Min, sizeof(kBelowInt64Min) - 1)
+		== EjfpErrorDeserializationUnsupportedJsonStructure);
+
+	// {"a": INT64_MIN} is the lowest one accepted
+	const char kInt64Min[] = "\xa1\x61\x61\x3b\x7f\xff\xff\xff\xff\xff\xff\xff";
+	assert(ejfpCborDeserialize(parsed, 1, kInt64Min, sizeof(kInt64Min) - 1) == 1);
+	assert(parsed[0].fieldType == EjfpFieldVariantTypeInteger64);
+	assert(parsed[0].integer64Value == INT64_MIN);
+}
+
+OHDEBUG_TEST("Validation: strict syntax w/o tokens")
+{
+	struct {
+		const char *input;
+		int result;
+		std::size_t errorOffset;
+	} cases[] = {
+		{"{}", 0, 0},
+		{" {\"a\": 1, \"b\": -0.5e+3, \"c\": \"\\u00e9\\n\", \"d\": null, \"e\": false} ", 5, 0},
+		{"{\"a\":1", EjfpErrorDeserializationPartitioned, 6},
+		{"{\"a\":01}", EjfpErrorDeserializationInvalidSyntax, 6},
+		{"{\"a\":1.}", EjfpErrorDeserializationInvalidSyntax, 7},
+		{"{\"a\":tru}", EjfpErrorDeserializationInvalidSyntax, 5},
+		{"{\"a\":\"\\x\"}", EjfpErrorDeserializationInvalidSyntax, 7},
+		{"{\"a\":1,}", EjfpErrorDeserializationInvalidSyntax, 7},
+		{"{\"a\":{\"b\":1}}", EjfpErrorDeserializationUnsupportedJsonStructure, 5},
+		{"{a:1}", EjfpErrorDeserializationInvalidSyntax, 1},
+		{"{\"a\":1} x", EjfpErrorDeserializationInvalidSyntax, 8},
+		{"[1]", EjfpErrorDeserializationUnsupportedJsonStructure, 0},
+	};
+
+	for (const auto &testCase : cases) {
+		std::size_t errorOffset = 0;
+		const int result = ejfpValidate(testCase.input, std::strlen(testCase.input), &errorOffset);
+		OHDEBUG("Trace", testCase.input, "->", result, errorOffset);
+		assert(result == testCase.result);
+		assert(result >= 0 || errorOffset == testCase.errorOffset);
+	}
+}
+
+static void routerCount(void *aContext, Ejfp *, const EjfpFieldVariant *, std::size_t aNFieldVariants)
+{
+	*static_cast<std::size_t *>(aContext) += aNFieldVariants;
+}
+
+OHDEBUG_TEST("Router: dispatch by a discriminator")
+{
+	EjfpRoute routes[8];
+	EjfpFieldVariant fieldVariants[4];
+	EjfpRouter router;
+	Ejfp ejfp{};
+	std::size_t nTelemetryFields = 0;
+	std::size_t nCommandFields = 0;
+	std::size_t nCodeFields = 0;
+	std::size_t nOtherFields = 0;
+	ejfpRouterInitialize(&router, "type", routes, 8, fieldVariants, 4);
+	assert(ejfpRouterAdd(&router, "telemetry", routerCount, &nCommandFields) == EjfpOk);
+	assert(ejfpRouterAdd(&router, "telemetry", routerCount, &nTelemetryFields) == EjfpOk);  // Rebound
+	assert(ejfpRouterAdd(&router, "command", routerCount, &nCommandFields) == EjfpOk);
+	assert(ejfpRouterAdd(&router, "42", routerCount, &nCodeFields) == EjfpOk);
+
+	struct {
+		const char *input;
+		int result;
+	} cases[] = {
+		{"{\"type\": \"telemetry\", \"voltage\": 11.5}", 2},
+		{"{\"id\": 1, \"type\": \"command\", \"arm\": true}", 3},
+		{"{\"type\": 42}", 1},
+		{"{\"type\": \"unknown\", \"nested\": {\"a\": 1}}", EjfpErrorRouterNoRoute},  // Not converted
+		{"{\"id\": 2}", EjfpErrorRouterNoRoute},
+		{"{\"id\": 1,, \"type\": \"command\"}", EjfpErrorDeserializationInvalidSyntax},
+	};
+
+	for (const auto &testCase : cases) {
+		const int result = ejfpRouterDispatch(&router, &ejfp, testCase.input, std::strlen(testCase.input));
+		OHDEBUG("Trace", testCase.input, "->", result);
+		assert(result == testCase.result);
+	}
+
+	assert(nTelemetryFields == 2 && nCommandFields == 3 && nCodeFields == 1);
+
+	ejfpRouterSetFallback(&router, routerCount, &nOtherFields);
+	assert(ejfpRouterDispatch(&router, &ejfp, "{\"id\": 2}", 9) == 1);
+	assert(nOtherFields == 1);
+
+	// 1 slot is kept free
+	for (const char *value : {"a", "b", "c", "d"}) {
+		assert(ejfpRouterAdd(&router, value, routerCount, nullptr) == EjfpOk);
+	}
+
+	assert(ejfpRouterAdd(&router, "e", routerCount, nullptr) == EjfpErrorRouterNoMemory);
+}
+
+OHDEBUG_TEST("Deserialization: shape cache")
+{
+	char shapeBuffer[64];
+	EjfpShapeCache shapeCache;
+	Ejfp ejfp;
+	ejfpInitialize(&ejfp);
+	ejfpShapeCacheInitialize(&shapeCache, shapeBuffer, sizeof(shapeBuffer));
+	ejfpSetShapeCache(&ejfp, &shapeCache);
+
+	static constexpr const char *kInputs[] = {
+		"{\"seq\": 1, \"name\": \"drone\", \"armed\": true, \"v\": 11.5}",  // Miss: nothing remembered
+		"{\"seq\":2,\"name\":\"dr\\\"one\\u00e9\",\"armed\":false , \"v\":12}\n",  // Hit
+		"{\"seq\": 3, \"armed\": true, \"name\": \"x\", \"v\": 1}",  // Miss: order
+		"{\"seq\": 4, \"armed\": false, \"name\": \"\", \"v\": null}",  // Hit
+		"{\"seq\": 5, \"armed\": \"yes\", \"name\": \"x\", \"v\": 1}",  // Miss: kind
+		"{\"seq\": 6, \"armed\": \"yes\", \"name\": \"x\", \"v\": 1",  // Miss: partitioned
+		"{\"seq\": 7, \"armed\": \"bad\\q\", \"name\": \"x\", \"v\": 1}",  // Miss: escape
+		"{\"seq\": 8, \"armed\": \"yes\", \"name\": \"x\", \"v\": 1, \"extra\": 0}",  // Miss: extra key
+		"{\"seq\": 9, \"armed\": \"yes\", \"name\": \"x\", \"v\": 1, \"extra\": 0}",  // Hit
+		"{\"seq\": 10, \"armed\": \"yes\", \"name\": \"x\", \"v\": 1, \"extr\": 0}",  // Miss: key
+	};
+
+	for (const char *input : kInputs) {
+		EjfpFieldVariant cached[5] {};
+		EjfpFieldVariant general[5] {};
+		Ejfp plain;
+		ejfpInitialize(&plain);
+		ejfpReset(&ejfp);
+		const int kResult = ejfpDeserialize(&ejfp, cached, 5, input, strlen(input));
+		const int kExpected = ejfpDeserialize(&plain, general, 5, input, strlen(input));
+		OHDEBUG("Trace", input, "->", kResult, ejfpShapeCacheHits(&shapeCache), ejfpShapeCacheMisses(&shapeCache));
+		assert(kResult == kExpected);
+
+		for (int i = 0; i < kResult; ++i) {
+			assert(cached[i].fieldNameLength == general[i].fieldNameLength);
+			assert(cached[i].fieldName == general[i].fieldName);
+			assert(ejfpFieldVariantDigest(&cached[i]) == ejfpFieldVariantDigest(&general[i]));
+		}
+	}
+
+	assert(ejfpShapeCacheHits(&shapeCache) == 3 && ejfpShapeCacheMisses(&shapeCache) == 7);
+
+	// Layouts which do not fit are not remembered
+	char tinyShapeBuffer[8];
+	ejfpShapeCacheInitialize(&shapeCache, tinyShapeBuffer, sizeof(tinyShapeBuffer));
+
+	for (int i = 0; i < 2; ++i) {
+		EjfpFieldVariant fieldVariants[5];
+		ejfpReset(&ejfp);
+		assert(ejfpDeserialize(&ejfp, fieldVariants, 5, kInputs[0], strlen(kInputs[0])) == 4);
+	}
+
+	assert(ejfpShapeCacheHits(&shapeCache) == 0 && ejfpShapeCacheMisses(&shapeCache) == 2);
+}
+
+OHDEBUG_TEST("Deserialization: trusted input")
+{
+	EjfpFieldVariant fieldVariants[7] {
+		{EjfpFieldVariantTypeInteger, "seq"},
+		{EjfpFieldVariantTypeString, "name"},
+		{EjfpFieldVariantTypeBoolean, "armed"},
+		{EjfpFieldVariantTypeNull, "none"},
+		{EjfpFieldVariantTypeFloat, "voltage"},
+		{EjfpFieldVariantTypeInteger64, "timestamp"},
+		{EjfpFieldVariantTypeString, "k\"ey,}"},
+	};
+	fieldVariants[0].integerValue = -42;
+	fieldVariants[1].stringValue = "dr\"one\\";
+	fieldVariants[2].booleanValue = 1;
+	fieldVariants[4].floatValue = 11.5f;
+	fieldVariants[5].integer64Value = 1684411200123456789LL;
+	fieldVariants[6].stringValue = "\",\"x\":1}";
+	char output[256] {};
+	const int kOutputSize = ejfpSerialize(nullptr, fieldVariants, 7, output, sizeof(output));
+	OHDEBUG("Trace", output);
+	assert(kOutputSize > 0);
+
+	Ejfp trusted;
+	Ejfp plain;
+	ejfpInitialize(&trusted);
+	ejfpInitialize(&plain);
+	ejfpSetTrusted(&trusted, 1);
+	EjfpFieldVariant fast[7] {};
+	EjfpFieldVariant general[7] {};
+	assert(ejfpDeserialize(&trusted, fast, 7, output, kOutputSize) == 7);
+	assert(ejfpDeserialize(&plain, general, 7, output, kOutputSize) == 7);
+
+	for (int i = 0; i < 7; ++i) {
+		assert(fast[i].fieldName == general[i].fieldName && fast[i].fieldNameLength == general[i].fieldNameLength);
+		assert(ejfpFieldVariantDigest(&fast[i]) == ejfpFieldVariantDigest(&general[i]));
+	}
+
+	// Truncated messages are never read past their ends
+	for (int size = 0; size < kOutputSize; ++size) {
+		std::string truncated(output, size);
+		assert(ejfpDeserialize(&trusted, fast, 7, truncated.c_str(), truncated.size()) < 0);
+	}
+
+	assert(ejfpDeserialize(&trusted, fast, 6, output, kOutputSize) == EjfpErrorDeserializationNoMemory);
+	assert(ejfpDeserialize(&trusted, fast, 7, "{}", 2) == 0);
+	assert(ejfpDeserialize(&trusted, fast, 7, "[1]", 3) == EjfpErrorDeserializationInvalidSyntax);
+	assert(ejfpDeserialize(&trusted, fast, 7, "{\"a\" : 1}", 10) == EjfpErrorDeserializationInvalidSyntax);
+}
+
 int main(void)
 {
 	OHDEBUG("Trace", "serialization_test");
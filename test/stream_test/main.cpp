@@ -0,0 +1,245 @@
+#define OHDEBUG_PORT_ENABLE 1
+#define OHDEBUG_TAGS_ENABLE "Trace"
+
+#include <OhDebug.hpp>
+
+#include <ejfp/coroutine.hpp>
+#include <ejfp/error.h>
+#include <ejfp/stream.h>
+#include <algorithm>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals;
+
+static constexpr std::string_view kInput = "{\"id\": 1, \"name\": \"a}b{\"}\n"
+	"  {\"id\": 2, \"name\": \"quoted \\\"}\\\" brace\"}{\"id\": 3, \"armed\": true}\r\n"
+	"{\"id\": 4, \"name\": \"\\\\\"}";
+
+/// @brief Delivers the input in chunks of 1..7 bytes. Each read suspends the
+/// reader until `pump` is called, as if bytes arrived from an event loop
+class ChunkSource {
+public:
+	class Read {
+	public:
+		Read(ChunkSource &aSource, char *aBuffer, std::size_t aSize) :
+			source{aSource},
+			buffer{aBuffer},
+			size{aSize}
+		{
+		}
+
+		bool await_ready() const
+		{
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> aReader)
+		{
+			source.reader = aReader;
+		}
+
+		std::size_t await_resume()
+		{
+			const std::size_t kChunkSize = std::min({size, source.input.size(), source.nReads % 7 + 1});
+			std::memcpy(buffer, source.input.data(), kChunkSize);
+			source.input.remove_prefix(kChunkSize);
+			++source.nReads;
+
+			return kChunkSize;
+		}
+
+	private:
+		ChunkSource &source;
+		char *buffer;
+		std::size_t size;
+	};
+
+	explicit ChunkSource(std::string_view aInput) :
+		input{aInput}
+	{
+	}
+
+	Read read(char *aBuffer, std::size_t aSize)
+	{
+		return {*this, aBuffer, aSize};
+	}
+
+	/// @return False, if nobody waits for bytes
+	bool pump()
+	{
+		if (!reader) {
+			return false;
+		}
+
+		std::exchange(reader, {}).resume();
+
+		return true;
+	}
+
+	std::size_t nReads = 0;
+
+private:
+	std::string_view input;
+	std::coroutine_handle<> reader;
+};
+
+static_assert(ejfp::ByteSource<ChunkSource>);
+
+OHDEBUG_TEST("Stream: C framer, byte-by-byte input")
+{
+	char buffer[64];
+	EjfpStream stream{};
+	ejfpStreamInitialize(&stream, buffer, sizeof(buffer));
+	Ejfp ejfp{};
+	EjfpFieldVariant fieldVariants[2] {};
+	std::vector<int> ids;
+
+	for (char character : kInput) {
+		assert(ejfpStreamFeed(&stream, &character, 1) == 1);
+
+		for (int result; (result = ejfpStreamNext(&stream, &ejfp, fieldVariants, 2))
+			!= EjfpErrorDeserializationPartitioned;) {
+			assert(result == 2);
+			ids.push_back(fieldVariants[0].integerValue);
+		}
+	}
+
+	assert((ids == std::vector<int>{1, 2, 3, 4}));
+	assert(std::string(fieldVariants[1].stringValue, fieldVariants[1].stringValueLength) == "\\\\");
+}
+
+OHDEBUG_TEST("Stream: C framer, errors")
+{
+	char buffer[24];
+	EjfpStream stream{};
+	ejfpStreamInitialize(&stream, buffer, sizeof(buffer));
+	Ejfp ejfp{};
+	EjfpFieldVariant fieldVariants[2] {};
+	std::vector<int> results;
+	const std::string_view kInput = "x{\"a\": }{\"oversized\": \"0123456789abcdef\"}{\"b\": 2}"sv;
+	std::size_t nFed = 0;
+
+	while (nFed < kInput.size()) {
+		nFed += ejfpStreamFeed(&stream, kInput.data() + nFed, std::min<std::size_t>(kInput.size() - nFed, 5));
+
+		for (int result; (result = ejfpStreamNext(&stream, &ejfp, fieldVariants, 2))
+			!= EjfpErrorDeserializationPartitioned;) {
+			results.push_back(result);
+		}
+	}
+
+	for (int result : results) {
+		OHDEBUG("Trace", result);
+	}
+
+	assert((results == std::vector<int>{EjfpErrorDeserializationInvalidSyntax,
+		EjfpErrorDeserializationUnsupportedJsonStructure, EjfpErrorDeserializationNoMemory, 1}));
+	assert(fieldVariants[0].integerValue == 2);
+}
+
+/// @return Ids of deserialized objects
+static std::vector<int> streamIds(std::string_view aInput, bool aIsRecovering, std::size_t &aNErrors,
+	std::size_t &aNSkipped)
+{
+	char buffer[64];
+	EjfpStream stream{};
+	ejfpStreamInitialize(&stream, buffer, sizeof(buffer));
+	ejfpStreamSetRecovery(&stream, aIsRecovering);
+	Ejfp ejfp{};
+	EjfpFieldVariant fieldVariants[4] {};
+	std::vector<int> ids;
+	std::size_t nFed = 0;
+	aNErrors = 0;
+
+	while (nFed < aInput.size()) {
+		nFed += ejfpStreamFeed(&stream, aInput.data() + nFed, std::min<std::size_t>(aInput.size() - nFed, 7));
+
+		for (int result; (result = ejfpStreamNext(&stream, &ejfp, fieldVariants, 4))
+			!= EjfpErrorDeserializationPartitioned;) {
+			if (result > 0) {
+				ids.push_back(fieldVariants[0].integerValue);
+			} else {
+				++aNErrors;
+			}
+		}
+	}
+
+	aNSkipped = ejfpStreamSkipped(&stream);
+
+	return ids;
+}
+
+OHDEBUG_TEST("Stream: resynchronization after corrupted objects")
+{
+	const std::string_view kInput = "{\"id\": 1, \"s\": \"ok\"}\n"
+		"\x07\x13garbage between objects\n"  // Stray bytes
+		"{\"id\": 2, \"s\": \"lost brace\"\n"  // A '}' is lost
+		"{\"id\": 3, \"s\": \"ok\"}\n"
+		"{\"id\": 4, \"s\": \"stray quote\"\"}\n"  // Stays in a string till the newline
+		"{\"id\": 5, \"s\": \"ok\"}\n"
+		"{\"id\": 6, \"s\": \"ok\"}\n"sv;
+	std::size_t nErrors = 0;
+	std::size_t nSkipped = 0;
+
+	const std::vector<int> kIds = streamIds(kInput, true, nErrors, nSkipped);
+	OHDEBUG("Trace", "recovery: objects", kIds.size(), "errors", nErrors, "skipped", nSkipped);
+	assert((kIds == std::vector<int>{1, 3, 5, 6}));
+	assert(nErrors == 2);
+	assert(nSkipped == std::string_view{"\x07\x13garbage between objects"}.size()
+		+ std::string_view{"{\"id\": 2, \"s\": \"lost brace\"\n"}.size()
+		+ std::string_view{"{\"id\": 4, \"s\": \"stray quote\"\"}\n"}.size());
+
+	// W/o recovery, every stray byte is an error, and corrupted objects swallow the following ones
+	const std::vector<int> kIdsDefault = streamIds(kInput, false, nErrors, nSkipped);
+	OHDEBUG("Trace", "default: objects", kIdsDefault.size(), "errors", nErrors, "skipped", nSkipped);
+	assert(kIdsDefault.size() < kIds.size());
+	assert(nErrors > 20);
+}
+
+static ejfp::Task<void> consume(ejfp::AsyncParser<ChunkSource, 4, 48> &aParser, std::vector<std::string> &aNames,
+	int &aNObjects)
+{
+	int result = 0;
+
+	while ((result = co_await aParser.next()) != EjfpErrorStreamEnd) {
+		assert(result > 0);
+		++aNObjects;
+
+		if (auto name = aParser.fields().find("name")) {
+			aNames.emplace_back(*name->get<std::string_view>());
+		}
+	}
+}
+
+OHDEBUG_TEST("Stream: coroutine parser over a chunked source")
+{
+	ChunkSource source{kInput};
+	ejfp::AsyncParser<ChunkSource, 4, 48> parser{source};
+	std::vector<std::string> names;
+	int nObjects = 0;
+	ejfp::Task<void> task = consume(parser, names, nObjects);
+	task.start();
+
+	while (source.pump()) {
+	}
+
+	OHDEBUG("Trace", "reads", source.nReads);
+	assert(task.done());
+	assert(nObjects == 4);
+	assert((names == std::vector<std::string>{"a}b{", "quoted \\\"}\\\" brace", "\\\\"}));
+	assert(source.nReads > 4);  // The parser has been suspended in the middle of objects
+}
+
+int main(void)
+{
+	OHDEBUG("Trace", "stream_test");
+	OHDEBUG_RUN_TESTS();
+
+	return 0;
+}
@@ -0,0 +1,167 @@
+#define OHDEBUG_PORT_ENABLE 1
+#define OHDEBUG_TAGS_ENABLE "Trace"
+
+#include <OhDebug.hpp>
+
+#include <ejfp/deserialization.h>
+#include <ejfp/error.h>
+#include <ejfp/print.h>
+#include <ejfp/ringInput.h>
+#include <ejfp/serialization.h>
+#include <ejfp/trace.h>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+struct Record {
+	EjfpTracePhase phase;
+	std::size_t messageSize;
+	uint32_t ticks;
+};
+
+static uint32_t sTicks = 0;
+
+/// @brief Advances by 10 ticks per reading
+static uint32_t clockFake()
+{
+	return sTicks += 10;
+}
+
+static void hookAppend(void *aContext, EjfpTracePhase aPhase, size_t aMessageSize, uint32_t aTicks)
+{
+	static_cast<std::vector<Record> *>(aContext)->push_back({aPhase, aMessageSize, aTicks});
+}
+
+OHDEBUG_TEST("Trace: Buckets and size classes")
+{
+	for (std::size_t bucket = 0; bucket < EJFP_TRACE_BUCKETS; ++bucket) {
+		const uint32_t kMin = ejfpTraceBucketMin(bucket);
+		assert(ejfpTraceBucket(kMin) == bucket);
+
+		if (bucket + 1 < EJFP_TRACE_BUCKETS) {
+			assert(ejfpTraceBucketMin(bucket + 1) > kMin);
+			assert(ejfpTraceBucket(ejfpTraceBucketMin(bucket + 1) - 1) == bucket);
+		}
+	}
+
+	assert(ejfpTraceBucket(UINT32_MAX) == EJFP_TRACE_BUCKETS - 1);
+	assert(ejfpTraceSizeClass(0) == 0 && ejfpTraceSizeClass(63) == 0);
+	assert(ejfpTraceSizeClass(64) == 1 && ejfpTraceSizeClass(255) == 1);
+	assert(ejfpTraceSizeClass(256) == 2 && ejfpTraceSizeClass(16383) == 4);
+	assert(ejfpTraceSizeClass(16384) == 5 && ejfpTraceSizeClass(SIZE_MAX) == 5);
+
+	for (std::size_t sizeClass = 0; sizeClass < EJFP_TRACE_SIZE_CLASSES; ++sizeClass) {
+		assert(ejfpTraceSizeClass(ejfpTraceSizeClassMin(sizeClass)) == sizeClass);
+	}
+}
+
+OHDEBUG_TEST("Trace: Percentiles")
+{
+	EjfpTrace trace;
+	EjfpTraceHistogram histogram;
+	ejfpTraceInitialize(&trace, clockFake);
+	ejfpTraceHistogramReset(&histogram);
+	ejfpTraceSetHistogram(&trace, EjfpTracePhaseDeserialize, &histogram);
+	assert(ejfpTraceHistogramPercentile(&histogram, 0, 500) == 0);
+
+	for (uint32_t ticks = 1; ticks <= 1000; ++ticks) {
+		ejfpTraceRecord(&trace, EjfpTracePhaseDeserialize, 100, ticks);
+	}
+
+	ejfpTraceRecord(&trace, EjfpTracePhaseSerialize, 100, 1);  // Not counted
+	ejfpTraceRecord(&trace, EjfpTracePhaseDeserialize, 20000, 7);
+	assert(ejfpTraceHistogramCount(&histogram, 0) == 0);
+	assert(ejfpTraceHistogramCount(&histogram, 1) == 1000);
+	assert(ejfpTraceHistogramCount(&histogram, 5) == 1);
+	assert(histogram.max[1] == 1000);
+
+	// Within a bucket of the exact value, never below it
+	const uint32_t kP50 = ejfpTraceHistogramPercentile(&histogram, 1, 500);
+	const uint32_t kP99 = ejfpTraceHistogramPercentile(&histogram, 1, 990);
+	OHDEBUG("Trace", "p50", kP50, "p99", kP99);
+	assert(kP50 >= 500 && kP50 < 500 * 5 / 4);
+	assert(kP99 >= 990 && kP99 <= 1000);
+	assert(ejfpTraceHistogramPercentile(&histogram, 1, 1000) == 1000);
+	assert(ejfpTraceHistogramPercentile(&histogram, 1, 0) == 1);
+	assert(ejfpTraceHistogramPercentile(&histogram, 5, 990) == 7);
+}
+
+OHDEBUG_TEST("Trace: Phases of the library calls")
+{
+	static constexpr const char *kInput = "{\"id\": 42, \"name\": \"drone\"}";
+	const std::size_t kInputSize = strlen(kInput);
+	std::vector<Record> records;
+	EjfpTrace trace;
+	EjfpTraceHistogram histogram;
+	ejfpTraceInitialize(&trace, clockFake);
+	ejfpTraceSetHook(&trace, hookAppend, &records);
+	ejfpTraceHistogramReset(&histogram);
+	ejfpTraceSetHistogram(&trace, EjfpTracePhaseDeserialize, &histogram);
+	Ejfp ejfp{};
+	ejfpInitialize(&ejfp);
+
+	// Not traced
+	EjfpFieldVariant fieldVariants[2] {};
+	assert(ejfpDeserialize(&ejfp, fieldVariants, 2, kInput, kInputSize) == 2);
+	assert(records.empty());
+
+	ejfpSetTrace(&ejfp, &trace);
+	ejfpReset(&ejfp);
+	assert(ejfpDeserialize(&ejfp, fieldVariants, 2, kInput, kInputSize) == 2);
+	assert(records.size() == 4);
+	assert(records[0].phase == EjfpTracePhaseTokenize && records[1].phase == EjfpTracePhaseValidate);
+	assert(records[2].phase == EjfpTracePhaseParse && records[3].phase == EjfpTracePhaseDeserialize);
+
+	for (const Record &record : records) {
+		assert(record.messageSize == kInputSize && record.ticks > 0);
+	}
+
+	// The call takes longer than its phases together
+	assert(records[3].ticks > records[0].ticks + records[1].ticks + records[2].ticks);
+	assert(ejfpTraceHistogramCount(&histogram, ejfpTraceSizeClass(kInputSize)) == 1);
+
+	// Trusted path, no tokens
+	records.clear();
+	ejfpReset(&ejfp);
+	ejfpSetTrusted(&ejfp, 1);
+	EjfpFieldVariant outgoing[2] {{EjfpFieldVariantTypeInteger, "id"}, {EjfpFieldVariantTypeString, "name"}};
+	outgoing[0].integerValue = 42;
+	outgoing[1].stringValue = "drone";
+	char output[64];
+	const int kOutputSize = ejfpSerialize(&ejfp, outgoing, 2, output, sizeof(output));
+	assert(kOutputSize > 0);
+	assert(ejfpDeserialize(&ejfp, fieldVariants, 2, output, kOutputSize) == 2);
+	assert(records.size() == 4);
+	assert(records[0].phase == EjfpTracePhaseGenerate && records[1].phase == EjfpTracePhaseSerialize);
+	assert(records[1].messageSize == static_cast<std::size_t>(kOutputSize));
+	assert(records[2].phase == EjfpTracePhaseParse && records[3].phase == EjfpTracePhaseDeserialize);
+
+	// Failed calls are recorded too
+	records.clear();
+	ejfpSetTrusted(&ejfp, 0);
+	ejfpReset(&ejfp);
+	assert(ejfpDeserialize(&ejfp, fieldVariants, 2, kInput, kInputSize - 1) == EjfpErrorDeserializationPartitioned);
+	assert(records.size() == 2);
+	assert(records[0].phase == EjfpTracePhaseTokenize && records[1].phase == EjfpTracePhaseDeserialize);
+
+	// Ring input goes through the same phases
+	records.clear();
+	EjfpRingInput ringInput;
+	ejfpRingInputInitialize(&ringInput, kInput, kInputSize, 0, kInputSize);
+	assert(ejfpDeserializeRing(&ejfp, fieldVariants, 2, &ringInput, nullptr, 0) == 2);
+	assert(records.size() == 4);
+	assert(records[0].phase == EjfpTracePhaseTokenize && records[1].phase == EjfpTracePhaseValidate);
+	assert(records[2].phase == EjfpTracePhaseParse && records[3].phase == EjfpTracePhaseDeserialize);
+	assert(records[3].messageSize == kInputSize);
+	ejfpTracePrint(&trace);
+}
+
+int main(void)
+{
+	OHDEBUG("Trace", "trace_test");
+	OHDEBUG_RUN_TESTS();
+
+	return 0;
+}
@@ -0,0 +1,671 @@
+//
+// ejfpgrep.c
+//
+// Created: 2026-10-19
+//  Author: Dmitry Murashov (dmtr <DOT> murashov <AT> geoscan.aero)
+//
+// Filters and projects NDJSON records. The input is memory-mapped, and records
+// are deserialized in place. With several threads, the file is split into
+// blocks at newline boundaries; the output keeps the input order.
+//
+// Usage: ejfpgrep [-k KEY[,KEY...]] [-e PREDICATE]... [-t THREADS] [-c] FILE
+//
+// Predicates are `KEY=VALUE`, `KEY!=VALUE`, `KEY<VALUE`, `KEY<=VALUE`,
+// `KEY>VALUE`, and `KEY>=VALUE`, all of which must hold. Numbers are compared
+// by value regardless of their JSON type, strings are compared byte-wise w/o
+// unescaping. A value which is not a JSON primitive, or is enclosed in
+// quotes, is a string. Numbers of types disabled by "ejfp/config.h" are
+// rejected in predicates, and make records unsupported. In compact builds,
+// records are limited to `EJFP_COMPACT_BASE_SIZE_MAX` bytes.
+//
+
+#define _GNU_SOURCE  // `memmem`
+
+#include "ejfp/deserialization.h"
+#include "ejfp/ejfp.h"
+#include "ejfp/error.h"
+#include "ejfp/fieldVariant.h"
+#include "ejfp/sink.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FIELDS_MAX 64
+#define KEYS_MAX 32
+#define PREDICATES_MAX 32
+#define THREADS_MAX 64
+#define BLOCK_SIZE ((size_t)8 << 20)
+#define WRITER_FLUSH_SIZE ((size_t)1 << 20)
+
+typedef enum {
+	ComparisonEqual = 0,
+	ComparisonNotEqual,
+	ComparisonLess,
+	ComparisonLessEqual,
+	ComparisonGreater,
+	ComparisonGreaterEqual,
+} Comparison;
+
+typedef struct {
+	const char *key;
+	size_t keyLength;
+	Comparison comparison;
+
+	/// @brief Only the type of string values is set, as compact fields cannot
+	/// refer outside of a record, see `string`. Others are parsed
+	EjfpFieldVariant value;
+	const char *string;
+	size_t stringLength;
+} Predicate;
+
+typedef struct {
+	const char *keys[KEYS_MAX];
+	size_t keyLengths[KEYS_MAX];
+	size_t nKeys;
+	Predicate predicates[PREDICATES_MAX];
+	size_t nPredicates;
+	int isCountOnly;
+
+	const char *input;
+	size_t inputSize;
+	size_t nBlocks;
+	size_t nThreads;
+
+	/// @brief Blocks are written out in order, see `writerFlushBlock`
+	pthread_mutex_t mutex;
+	pthread_cond_t condition;
+	size_t nextBlock;
+} Job;
+
+/// @brief Growing output buffer of a thread. Is written out once a block is done
+typedef struct {
+	char *data;
+	size_t size;
+	size_t capacity;
+	int isFailed;
+} Writer;
+
+typedef struct {
+	Job *job;
+	size_t index;
+	size_t nMatches;
+	size_t nMalformed;
+	Writer writer;
+} Worker;
+
+static int writerAppend(Writer *aWriter, const char *aData, size_t aDataSize);
+
+/// @brief `EjfpSinkFlush` over `Writer`
+static int writerSinkFlush(void *aContext, const char *aData, size_t aDataSize);
+
+/// @brief Waits for the turn of `aBlock`, and writes the buffer out
+static int writerFlushBlock(Job *aJob, Writer *aWriter, size_t aBlock);
+
+static int writeAll(int aFd, const char *aData, size_t aDataSize);
+
+/// @brief [start; end) of a block. Blocks start right after a newline
+static void blockRange(const Job *aJob, size_t aBlock, size_t *aStart, size_t *aEnd);
+
+/// @brief The library's primitive parser expects input validated by "jsmn", so
+/// predicate values are checked here
+static int isPrimitive(const char *aValue);
+
+static int predicateParse(Predicate *aPredicate, const char *aExpression);
+
+/// @param aBase Record the field refers to, see `EJFP_FIELD_STRING`
+/// @return -1, 0, or 1, like `strcmp`. 2, if the values are incomparable
+static int fieldCompare(const char *aBase, const EjfpFieldVariant *aFieldVariant, const Predicate *aPredicate);
+
+static int recordMatches(const Job *aJob, const char *aBase, const EjfpFieldVariant *aFieldVariants,
+	size_t aNFieldVariants);
+
+static int recordProcess(Worker *aWorker, const char *aRecord, size_t aRecordSize);
+
+static void *workerRun(void *aWorker);
+
+static void usage(void);
+
+static int writerAppend(Writer *aWriter, const char *aData, size_t aDataSize)
+{
+	if (aWriter->size + aDataSize > aWriter->capacity) {
+		size_t capacity = aWriter->capacity ? aWriter->capacity : WRITER_FLUSH_SIZE;
+
+		while (capacity < aWriter->size + aDataSize) {
+			capacity *= 2;
+		}
+
+		char *data = realloc(aWriter->data, capacity);
+
+		if (data == NULL) {
+			aWriter->isFailed = 1;
+
+			return -1;
+		}
+
+		aWriter->data = data;
+		aWriter->capacity = capacity;
+	}
+
+	memcpy(aWriter->data + aWriter->size, aData, aDataSize);
+	aWriter->size += aDataSize;
+
+	return 0;
+}
+
+static int writerSinkFlush(void *aContext, const char *aData, size_t aDataSize)
+{
+	return writerAppend((Writer *)aContext, aData, aDataSize);
+}
+
+static int writeAll(int aFd, const char *aData, size_t aDataSize)
+{
+	while (aDataSize > 0) {
+		const ssize_t kWritten = write(aFd, aData, aDataSize);
+
+		if (kWritten < 0) {
+			return -1;
+		}
+
+		aData += kWritten;
+		aDataSize -= (size_t)kWritten;
+	}
+
+	return 0;
+}
+
+static int writerFlushBlock(Job *aJob, Writer *aWriter, size_t aBlock)
+{
+	int result = 0;
+	pthread_mutex_lock(&aJob->mutex);
+
+	while (aJob->nextBlock != aBlock) {
+		pthread_cond_wait(&aJob->condition, &aJob->mutex);
+	}
+
+	pthread_mutex_unlock(&aJob->mutex);
+	result = writeAll(STDOUT_FILENO, aWriter->data, aWriter->size);
+	aWriter->size = 0;
+	pthread_mutex_lock(&aJob->mutex);
+	++aJob->nextBlock;
+	pthread_cond_broadcast(&aJob->condition);
+	pthread_mutex_unlock(&aJob->mutex);
+
+	return result;
+}
+
+static void blockRange(const Job *aJob, size_t aBlock, size_t *aStart, size_t *aEnd)
+{
+	size_t bounds[2] = {aBlock * BLOCK_SIZE, (aBlock + 1) * BLOCK_SIZE};
+
+	for (int i = 0; i < 2; ++i) {
+		if (bounds[i] == 0) {
+			continue;
+		} else if (bounds[i] >= aJob->inputSize) {
+			bounds[i] = aJob->inputSize;
+		} else {
+			const char *newline = memchr(aJob->input + bounds[i] - 1, '\n', aJob->inputSize - bounds[i] + 1);
+			bounds[i] = newline == NULL ? aJob->inputSize : (size_t)(newline - aJob->input) + 1;
+		}
+	}
+
+	*aStart = bounds[0];
+	*aEnd = bounds[1];
+}
+
+static int isPrimitive(const char *aValue)
+{
+	char *end = NULL;
+
+	if (strcmp(aValue, "true") == 0 || strcmp(aValue, "false") == 0 || strcmp(aValue, "null") == 0) {
+		return 1;
+	} else if (*aValue == '\0' || strchr("-0123456789", *aValue) == NULL) {
+		return 0;
+	}
+
+	strtod(aValue, &end);
+
+	return *end == '\0';
+}
+
+static int predicateParse(Predicate *aPredicate, const char *aExpression)
+{
+	static const struct {
+		const char *token;
+		Comparison comparison;
+	} kComparisons[] = {  // Two-character operators go first
+		{"!=", ComparisonNotEqual},
+		{"<=", ComparisonLessEqual},
+		{">=", ComparisonGreaterEqual},
+		{"=", ComparisonEqual},
+		{"<", ComparisonLess},
+		{">", ComparisonGreater},
+	};
+	const char *position = strpbrk(aExpression, "!=<>");
+
+	if (position == NULL || position == aExpression) {
+		return -1;
+	}
+
+	aPredicate->key = aExpression;
+	aPredicate->keyLength = (size_t)(position - aExpression);
+
+	for (size_t i = 0; i < sizeof(kComparisons) / sizeof(kComparisons[0]); ++i) {
+		const size_t kTokenLength = strlen(kComparisons[i].token);
+
+		if (strncmp(position, kComparisons[i].token, kTokenLength) == 0) {
+			aPredicate->comparison = kComparisons[i].comparison;
+			position += kTokenLength;
+			break;
+		}
+
+		if (i + 1 == sizeof(kComparisons) / sizeof(kComparisons[0])) {
+			return -1;
+		}
+	}
+
+	const size_t kValueLength = strlen(position);
+	memset(&aPredicate->value, 0, sizeof(aPredicate->value));
+
+	if (kValueLength >= 2 && position[0] == '"' && position[kValueLength - 1] == '"') {
+		aPredicate->value.fieldType = EjfpFieldVariantTypeString;
+		aPredicate->string = position + 1;
+		aPredicate->stringLength = kValueLength - 2;
+	} else if (isPrimitive(position)) {
+		ejfpFieldVariantParsePrimitive(&aPredicate->value, position, kValueLength);
+	} else {
+		aPredicate->value.fieldType = EjfpFieldVariantTypeString;
+		aPredicate->string = position;
+		aPredicate->stringLength = kValueLength;
+	}
+
+	// A number which requires a type disabled by "ejfp/config.h"
+	return aPredicate->value.fieldType == EjfpFieldVariantTypeUninitialized ? -1 : 0;
+}
+
+/// @return Non-zero, if the field is numeric
+static int fieldNumeric(const EjfpFieldVariant *aFieldVariant, long double *aValue)
+{
+	switch (aFieldVariant->fieldType) {
+		case EjfpFieldVariantTypeInteger:
+			*aValue = aFieldVariant->integerValue;
+
+			return 1;
+
+#if EJFP_ENABLE_INT64
+		case EjfpFieldVariantTypeInteger64:
+			*aValue = aFieldVariant->integer64Value;
+
+			return 1;
+
+		case EjfpFieldVariantTypeUnsignedInteger64:
+			*aValue = aFieldVariant->unsignedInteger64Value;
+
+			return 1;
+#endif  // EJFP_ENABLE_INT64
+
+#if EJFP_ENABLE_REAL
+		case EjfpFieldVariantTypeFloat:
+			*aValue = aFieldVariant->floatValue;
+
+			return 1;
+
+		case EjfpFieldVariantTypeDouble:
+			*aValue = aFieldVariant->doubleValue;
+
+			return 1;
+#endif  // EJFP_ENABLE_REAL
+
+		default:
+			return 0;
+	}
+}
+
+static int fieldCompare(const char *aBase, const EjfpFieldVariant *aFieldVariant, const Predicate *aPredicate)
+{
+	const EjfpFieldVariant *kLhs = aFieldVariant;
+	const EjfpFieldVariant *kRhs = &aPredicate->value;
+	long double lhs = 0;
+	long double rhs = 0;
+	(void)aBase;  // Only used by the accessors in compact mode
+
+	if (fieldNumeric(kLhs, &lhs) && fieldNumeric(kRhs, &rhs)) {
+		return (lhs > rhs) - (lhs < rhs);
+	} else if (kLhs->fieldType != kRhs->fieldType) {
+		return 2;
+	}
+
+	switch (kLhs->fieldType) {
+		case EjfpFieldVariantTypeString: {
+			const size_t kLhsLength = kLhs->stringValueLength;
+			const size_t kRhsLength = aPredicate->stringLength;
+			const int kResult = memcmp(EJFP_FIELD_STRING(aBase, kLhs), aPredicate->string,
+				kLhsLength < kRhsLength ? kLhsLength : kRhsLength);
+
+			if (kResult != 0) {
+				return (kResult > 0) - (kResult < 0);
+			}
+
+			return (kLhsLength > kRhsLength) - (kLhsLength < kRhsLength);
+		}
+
+		case EjfpFieldVariantTypeBoolean:
+			return (kLhs->booleanValue != 0) - (kRhs->booleanValue != 0);
+
+		case EjfpFieldVariantTypeNull:
+			return 0;
+
+		default:
+			return 2;
+	}
+}
+
+static int recordMatches(const Job *aJob, const char *aBase, const EjfpFieldVariant *aFieldVariants,
+	size_t aNFieldVariants)
+{
+	for (size_t iPredicate = 0; iPredicate < aJob->nPredicates; ++iPredicate) {
+		const Predicate *predicate = &aJob->predicates[iPredicate];
+		int isMatch = 0;
+
+		for (size_t i = 0; i < aNFieldVariants; ++i) {
+			if (aFieldVariants[i].fieldNameLength != predicate->keyLength
+				|| memcmp(EJFP_FIELD_NAME(aBase, &aFieldVariants[i]), predicate->key, predicate->keyLength) != 0) {
+				continue;
+			}
+
+			const int kComparison = fieldCompare(aBase, &aFieldVariants[i], predicate);
+
+			switch (predicate->comparison) {
+				case ComparisonEqual:
+					isMatch = kComparison == 0;
+
+					break;
+
+				case ComparisonNotEqual:
+					isMatch = kComparison != 0;
+
+					break;
+
+				case ComparisonLess:
+					isMatch = kComparison == -1;
+
+					break;
+
+				case ComparisonLessEqual:
+					isMatch = kComparison == -1 || kComparison == 0;
+
+					break;
+
+				case ComparisonGreater:
+					isMatch = kComparison == 1;
+
+					break;
+
+				case ComparisonGreaterEqual:
+					isMatch = kComparison == 1 || kComparison == 0;
+
+					break;
+			}
+
+			break;  // The first occurrence of a key wins
+		}
+
+		if (!isMatch) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int recordProcess(Worker *aWorker, const char *aRecord, size_t aRecordSize)
+{
+	const Job *job = aWorker->job;
+	Ejfp ejfp;
+	EjfpFieldVariant fieldVariants[FIELDS_MAX];
+
+	// Cheap pre-filter: a record cannot match a string equality, if it does not contain the string
+	for (size_t i = 0; i < job->nPredicates; ++i) {
+		const Predicate *predicate = &job->predicates[i];
+
+		if (predicate->comparison == ComparisonEqual && predicate->value.fieldType == EjfpFieldVariantTypeString
+			&& memmem(aRecord, aRecordSize, predicate->string, predicate->stringLength) == NULL) {
+			return 0;
+		}
+	}
+
+	ejfpInitialize(&ejfp);
+	const int kNFieldVariants = ejfpDeserialize(&ejfp, fieldVariants, FIELDS_MAX, aRecord, aRecordSize);
+
+	if (kNFieldVariants < 0) {
+		++aWorker->nMalformed;
+
+		return 0;
+	}
+
+	if (!recordMatches(job, aRecord, fieldVariants, (size_t)kNFieldVariants)) {
+		return 0;
+	}
+
+	++aWorker->nMatches;
+
+	if (job->isCountOnly) {
+		return 0;
+	} else if (job->nKeys == 0) {
+		if (writerAppend(&aWorker->writer, aRecord, aRecordSize) != 0) {
+			return -1;
+		}
+	} else {
+		// Projection: fields are kept in the record's order
+		EjfpFieldVariant projection[FIELDS_MAX];
+		size_t nProjection = 0;
+		char scratch[256];
+		EjfpSink sink;
+
+		for (int i = 0; i < kNFieldVariants; ++i) {
+			for (size_t iKey = 0; iKey < job->nKeys; ++iKey) {
+				if (fieldVariants[i].fieldNameLength == job->keyLengths[iKey]
+					&& memcmp(EJFP_FIELD_NAME(aRecord, &fieldVariants[i]), job->keys[iKey], job->keyLengths[iKey])
+					== 0) {
+					projection[nProjection++] = fieldVariants[i];
+					break;
+				}
+			}
+		}
+
+		ejfpSinkInitialize(&sink, scratch, sizeof(scratch), writerSinkFlush, &aWorker->writer);
+
+		if (ejfpSerializeToSink(&ejfp, projection, nProjection, &sink) < 0) {
+			return -1;
+		}
+	}
+
+	return writerAppend(&aWorker->writer, "\n", 1);
+}
+
+static void *workerRun(void *aWorker)
+{
+	Worker *worker = (Worker *)aWorker;
+	Job *job = worker->job;
+
+	for (size_t block = worker->index; block < job->nBlocks; block += job->nThreads) {
+		size_t start = 0;
+		size_t end = 0;
+		blockRange(job, block, &start, &end);
+
+		while (start < end) {
+			const char *newline = memchr(job->input + start, '\n', end - start);
+			const size_t kLineEnd = newline == NULL ? end : (size_t)(newline - job->input);
+			size_t recordEnd = kLineEnd;
+
+			if (recordEnd > start && job->input[recordEnd - 1] == '\r') {
+				--recordEnd;
+			}
+
+			if (recordEnd > start && recordProcess(worker, job->input + start, recordEnd - start) != 0) {
+				worker->writer.isFailed = 1;
+			}
+
+			start = kLineEnd + 1;
+		}
+
+		if (writerFlushBlock(job, &worker->writer, block) != 0) {
+			worker->writer.isFailed = 1;
+		}
+	}
+
+	return NULL;
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "Usage: ejfpgrep [-k KEY[,KEY...]] [-e PREDICATE]... [-t THREADS] [-c] FILE\n"
+		"  -k  Output only these fields\n"
+		"  -e  KEY=VALUE, KEY!=VALUE, KEY<VALUE, KEY<=VALUE, KEY>VALUE, or KEY>=VALUE\n"
+		"  -t  Number of threads, 1 by default\n"
+		"  -c  Print the number of matching records only\n");
+}
+
+int main(int aArgc, char **aArgv)
+{
+	static Job job;
+	static Worker workers[THREADS_MAX];
+	static pthread_t threads[THREADS_MAX];
+	int option = 0;
+	size_t nMatches = 0;
+	size_t nMalformed = 0;
+	int isFailed = 0;
+
+	job.nThreads = 1;
+
+	while ((option = getopt(aArgc, aArgv, "k:e:t:c")) != -1) {
+		switch (option) {
+			case 'k':
+				for (char *key = strtok(optarg, ","); key != NULL; key = strtok(NULL, ",")) {
+					if (job.nKeys == KEYS_MAX) {
+						fprintf(stderr, "ejfpgrep: too many keys\n");
+
+						return 2;
+					}
+
+					job.keys[job.nKeys] = key;
+					job.keyLengths[job.nKeys] = strlen(key);
+					++job.nKeys;
+				}
+
+				break;
+
+			case 'e':
+				if (job.nPredicates == PREDICATES_MAX || predicateParse(&job.predicates[job.nPredicates], optarg) != 0) {
+					fprintf(stderr, "ejfpgrep: invalid predicate \"%s\"\n", optarg);
+
+					return 2;
+				}
+
+				++job.nPredicates;
+
+				break;
+
+			case 't':
+				job.nThreads = (size_t)strtoul(optarg, NULL, 10);
+
+				if (job.nThreads == 0 || job.nThreads > THREADS_MAX) {
+					fprintf(stderr, "ejfpgrep: the number of threads must be within [1; %d]\n", THREADS_MAX);
+
+					return 2;
+				}
+
+				break;
+
+			case 'c':
+				job.isCountOnly = 1;
+
+				break;
+
+			default:
+				usage();
+
+				return 2;
+		}
+	}
+
+	if (optind + 1 != aArgc) {
+		usage();
+
+		return 2;
+	}
+
+	const int kFd = open(aArgv[optind], O_RDONLY);
+	struct stat status;
+
+	if (kFd < 0 || fstat(kFd, &status) != 0) {
+		perror(aArgv[optind]);
+
+		return 2;
+	}
+
+	job.inputSize = (size_t)status.st_size;
+
+	if (job.inputSize > 0) {
+		job.input = mmap(NULL, job.inputSize, PROT_READ, MAP_PRIVATE, kFd, 0);
+
+		if (job.input == MAP_FAILED) {
+			perror("mmap");
+
+			return 2;
+		}
+
+		madvise((void *)job.input, job.inputSize, MADV_SEQUENTIAL);
+	}
+
+	job.nBlocks = (job.inputSize + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	pthread_mutex_init(&job.mutex, NULL);
+	pthread_cond_init(&job.condition, NULL);
+
+	for (size_t i = 0; i < job.nThreads; ++i) {
+		workers[i].job = &job;
+		workers[i].index = i;
+	}
+
+	for (size_t i = 1; i < job.nThreads; ++i) {
+		if (pthread_create(&threads[i], NULL, workerRun, &workers[i]) != 0) {
+			perror("pthread_create");
+
+			return 2;
+		}
+	}
+
+	workerRun(&workers[0]);
+
+	for (size_t i = 0; i < job.nThreads; ++i) {
+		if (i > 0) {
+			pthread_join(threads[i], NULL);
+		}
+
+		nMatches += workers[i].nMatches;
+		nMalformed += workers[i].nMalformed;
+		isFailed |= workers[i].writer.isFailed;
+		free(workers[i].writer.data);
+	}
+
+	if (job.isCountOnly) {
+		printf("%zu\n", nMatches);
+	}
+
+	if (nMalformed > 0) {
+		fprintf(stderr, "ejfpgrep: skipped %zu malformed or unsupported records\n", nMalformed);
+	}
+
+	if (isFailed) {
+		fprintf(stderr, "ejfpgrep: output failed\n");
+
+		return 2;
+	}
+
+	return nMatches > 0 ? 0 : 1;
+}